@@ -0,0 +1,46 @@
+/**
+ * @file Host_Model.c
+ *
+ * @brief Source code of the host model of the TM4C123GH6PM device header.
+ *
+ * It holds the register memory of the peripherals and the state of the core,
+ * and calls the step function of the test on each peripheral access.
+ *
+ * @author
+ */
+
+#include "TM4C123GH6PM.h"
+
+SysTick_Type   host_systick;
+SCB_Type       host_scb;
+DWT_Type       host_dwt;
+CoreDebug_Type host_coredebug;
+SYSCTL_Type    host_sysctl;
+GPIOA_Type     host_gpio[6];
+UART0_Type     host_uart[2];
+UDMA_Type      host_udma;
+TIMER0_Type    host_timer[4];
+ADC0_Type      host_adc0;
+PWM0_Type      host_pwm[2];
+
+volatile uint32_t host_primask = 0;
+uint8_t host_nvic_enabled[HOST_MODEL_IRQ_COUNT];
+uint32_t host_nvic_priority[HOST_MODEL_IRQ_COUNT];
+uint8_t host_nvic_pending[HOST_MODEL_IRQ_COUNT];
+
+void (*host_model_step)(void) = 0;
+
+// Set while the step function runs
+static uint8_t host_model_busy = 0;
+
+void Host_Model_Access(void)
+{
+	if (host_model_busy || (host_model_step == 0))
+	{
+		return;
+	}
+
+	host_model_busy = 1;
+	host_model_step();
+	host_model_busy = 0;
+}
@@ -0,0 +1,243 @@
+/**
+ * @file TM4C123GH6PM.h
+ *
+ * @brief Host model of the TM4C123GH6PM device header.
+ *
+ * This header replaces the CMSIS device header when firmware drivers are compiled
+ * into the host tools (put -IHost_Model before -I../Keil_Project). The registers are
+ * plain memory, and PRIMASK and the NVIC are plain variables.
+ *
+ * Each access to a peripheral through its pointer (e.g. SysTick->VAL) first calls
+ * Host_Model_Access, which runs the step function of the test. The step function
+ * advances the simulated time, updates the registers that change on their own
+ * (counters, status bits), and runs the pending interrupt handlers while PRIMASK
+ * is clear. No time passes while a step function or a handler runs.
+ *
+ * @author
+ */
+
+#ifndef TM4C123GH6PM_H
+#define TM4C123GH6PM_H
+
+#include <stdint.h>
+
+#define __I  volatile const
+#define __O  volatile
+#define __IO volatile
+
+typedef enum
+{
+	SysTick_IRQn     = -1,
+	GPIOA_IRQn       = 0,
+	UART1_IRQn       = 6,
+	PWM0_FAULT_IRQn  = 9,
+	PWM0_0_IRQn      = 10,
+	PWM0_1_IRQn      = 11,
+	PWM0_2_IRQn      = 12,
+	ADC0SS0_IRQn     = 14,
+	TIMER0A_IRQn     = 19,
+	TIMER1A_IRQn     = 21,
+	TIMER2A_IRQn     = 23,
+	UDMA_IRQn        = 46,
+	UDMAERR_IRQn     = 47,
+	WTIMER0A_IRQn    = 94,
+	HOST_MODEL_IRQ_COUNT = 139
+} IRQn_Type;
+
+typedef struct
+{
+	__IO uint32_t CTRL;
+	__IO uint32_t LOAD;
+	__IO uint32_t VAL;
+	__I  uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+	__I  uint32_t CPUID;
+	__IO uint32_t ICSR;
+	__IO uint32_t VTOR;
+	__IO uint32_t AIRCR;
+	__IO uint32_t SCR;
+	__IO uint32_t CCR;
+} SCB_Type;
+
+typedef struct
+{
+	__IO uint32_t CTRL;
+	__IO uint32_t CYCCNT;
+	__IO uint32_t CPICNT;
+	__IO uint32_t EXCCNT;
+	__IO uint32_t SLEEPCNT;
+	__IO uint32_t LSUCNT;
+	__IO uint32_t FOLDCNT;
+	__I  uint32_t PCSR;
+} DWT_Type;
+
+typedef struct
+{
+	__IO uint32_t DHCSR;
+	__O  uint32_t DCRSR;
+	__IO uint32_t DCRDR;
+	__IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+	__IO uint32_t DID0, DID1, PBORCTL, RIS, IMC, MISC, RESC, RCC, GPIOHBCTL, RCC2, MOSCCTL,
+	              DSLPCLKCFG, SYSPROP, PIOSCCAL, PIOSCSTAT, PLLFREQ0, PLLFREQ1, PLLSTAT;
+	__IO uint32_t RCGCWD, RCGCTIMER, RCGCGPIO, RCGCDMA, RCGCHIB, RCGCUART, RCGCSSI, RCGCI2C,
+	              RCGCUSB, RCGCCAN, RCGCADC, RCGCACMP, RCGCPWM, RCGCQEI, RCGCEEPROM, RCGCWTIMER;
+	__IO uint32_t PRWD, PRTIMER, PRGPIO, PRDMA, PRHIB, PRUART, PRSSI, PRI2C,
+	              PRUSB, PRCAN, PRADC, PRACMP, PRPWM, PRQEI, PREEPROM, PRWTIMER;
+} SYSCTL_Type;
+
+typedef struct
+{
+	__IO uint32_t DATA, DIR, IS, IBE, IEV, IM, RIS, MIS, ICR, AFSEL, DR2R, DR4R, DR8R,
+	              ODR, PUR, PDR, SLR, DEN, LOCK, CR, AMSEL, PCTL, ADCCTL, DMACTL;
+} GPIOA_Type;
+
+typedef struct
+{
+	__IO uint32_t DR, RSR, FR, ILPR, IBRD, FBRD, LCRH, CTL, IFLS, IM, RIS, MIS, ICR, DMACTL, CC;
+} UART0_Type;
+
+typedef struct
+{
+	__IO uint32_t STAT, CFG, CTLBASE, ALTBASE, WAITSTAT, SWREQ, USEBURSTSET, USEBURSTCLR,
+	              REQMASKSET, REQMASKCLR, ENASET, ENACLR, ALTSET, ALTCLR, PRIOSET, PRIOCLR,
+	              ERRCLR, CHASGN, CHIS, CHMAP0, CHMAP1, CHMAP2, CHMAP3;
+} UDMA_Type;
+
+typedef struct
+{
+	__IO uint32_t CFG, TAMR, TBMR, CTL, SYNC, IMR, RIS, MIS, ICR, TAILR, TBILR, TAMATCHR, TBMATCHR,
+	              TAPR, TBPR, TAPMR, TBPMR, TAR, TBR, TAV, TBV, RTCPD, TAPS, TBPS, TAPV, TBPV, PP;
+} TIMER0_Type;
+
+typedef struct
+{
+	__IO uint32_t ACTSS, RIS, IM, ISC, OSTAT, EMUX, USTAT, TSSEL, SSPRI, SPC, PSSI, SAC, DCISC, CTL;
+	__IO uint32_t SSMUX0, SSCTL0, SSFIFO0, SSFSTAT0, SSOP0, SSDC0;
+	__IO uint32_t SSMUX1, SSCTL1, SSFIFO1, SSFSTAT1, SSOP1, SSDC1;
+	__IO uint32_t SSMUX3, SSCTL3, SSFIFO3, SSFSTAT3, SSOP3, SSDC3;
+	__IO uint32_t PP, PC, CC;
+} ADC0_Type;
+
+#define HOST_MODEL_PWM_GENERATOR(n) \
+	__IO uint32_t _##n##_CTL, _##n##_INTEN, _##n##_RIS, _##n##_ISC, _##n##_LOAD, _##n##_COUNT, \
+	              _##n##_CMPA, _##n##_CMPB, _##n##_GENA, _##n##_GENB, _##n##_DBCTL, _##n##_DBRISE, \
+	              _##n##_DBFALL, _##n##_FLTSRC0, _##n##_FLTSRC1, _##n##_MINFLTPER;
+
+#define HOST_MODEL_PWM_FAULT(n) \
+	__IO uint32_t _##n##_FLTSEN, _##n##_FLTSTAT0, _##n##_FLTSTAT1;
+
+typedef struct
+{
+	__IO uint32_t CTL, SYNC, ENABLE, INVERT, FAULT, INTEN, RIS, ISC, STATUS, FAULTVAL, ENUPD;
+	HOST_MODEL_PWM_GENERATOR(0)
+	HOST_MODEL_PWM_GENERATOR(1)
+	HOST_MODEL_PWM_GENERATOR(2)
+	HOST_MODEL_PWM_GENERATOR(3)
+	HOST_MODEL_PWM_FAULT(0)
+	HOST_MODEL_PWM_FAULT(1)
+	HOST_MODEL_PWM_FAULT(2)
+	HOST_MODEL_PWM_FAULT(3)
+	__IO uint32_t PP, CC;
+} PWM0_Type;
+
+// Register memory of the peripherals (Host_Model.c)
+extern SysTick_Type   host_systick;
+extern SCB_Type       host_scb;
+extern DWT_Type       host_dwt;
+extern CoreDebug_Type host_coredebug;
+extern SYSCTL_Type    host_sysctl;
+extern GPIOA_Type     host_gpio[6];
+extern UART0_Type     host_uart[2];
+extern UDMA_Type      host_udma;
+extern TIMER0_Type    host_timer[4];
+extern ADC0_Type      host_adc0;
+extern PWM0_Type      host_pwm[2];
+
+// State of the core: PRIMASK, and the enable bit and priority of each interrupt
+extern volatile uint32_t host_primask;
+extern uint8_t host_nvic_enabled[HOST_MODEL_IRQ_COUNT];
+extern uint32_t host_nvic_priority[HOST_MODEL_IRQ_COUNT];
+extern uint8_t host_nvic_pending[HOST_MODEL_IRQ_COUNT];
+
+// Step function of the test, called before each peripheral access (0 if none)
+extern void (*host_model_step)(void);
+
+/**
+ * @brief The Host_Model_Access function runs the step function of the test.
+ *
+ * Calls made while a step function runs (e.g. from the interrupt handlers that it calls)
+ * return immediately.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Host_Model_Access(void);
+
+#define SysTick   (Host_Model_Access(), &host_systick)
+#define SCB       (Host_Model_Access(), &host_scb)
+#define DWT       (Host_Model_Access(), &host_dwt)
+#define CoreDebug (Host_Model_Access(), &host_coredebug)
+#define SYSCTL    (Host_Model_Access(), &host_sysctl)
+#define GPIOA     (Host_Model_Access(), &host_gpio[0])
+#define GPIOB     (Host_Model_Access(), &host_gpio[1])
+#define GPIOC     (Host_Model_Access(), &host_gpio[2])
+#define GPIOD     (Host_Model_Access(), &host_gpio[3])
+#define GPIOE     (Host_Model_Access(), &host_gpio[4])
+#define GPIOF     (Host_Model_Access(), &host_gpio[5])
+#define UART0     (Host_Model_Access(), &host_uart[0])
+#define UART1     (Host_Model_Access(), &host_uart[1])
+#define UDMA      (Host_Model_Access(), &host_udma)
+#define TIMER0    (Host_Model_Access(), &host_timer[0])
+#define TIMER1    (Host_Model_Access(), &host_timer[1])
+#define TIMER2    (Host_Model_Access(), &host_timer[2])
+#define TIMER3    (Host_Model_Access(), &host_timer[3])
+#define ADC0      (Host_Model_Access(), &host_adc0)
+#define PWM0      (Host_Model_Access(), &host_pwm[0])
+#define PWM1      (Host_Model_Access(), &host_pwm[1])
+
+#define SCB_ICSR_PENDSTSET_Msk      (1UL << 26)
+#define SCB_ICSR_PENDSTCLR_Msk      (1UL << 25)
+#define SysTick_CTRL_COUNTFLAG_Msk  (1UL << 16)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+static inline uint32_t __get_PRIMASK(void)          { return host_primask; }
+static inline void __set_PRIMASK(uint32_t primask)  { host_primask = primask; Host_Model_Access(); }
+static inline void __disable_irq(void)              { host_primask = 1; }
+static inline void __enable_irq(void)               { host_primask = 0; Host_Model_Access(); }
+
+static inline void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __ISB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __NOP(void) { }
+static inline void __WFI(void) { Host_Model_Access(); }
+
+static inline uint32_t __CLZ(uint32_t value) { return (value == 0) ? 32 : (uint32_t)__builtin_clz(value); }
+
+// Exclusive accesses always succeed: the model has a single core
+static inline uint32_t __LDREXW(volatile uint32_t *address)                 { return *address; }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *address) { *address = value; return 0; }
+static inline void __CLREX(void) { }
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq)     { host_nvic_enabled[irq] = 1; }
+static inline void NVIC_DisableIRQ(IRQn_Type irq)    { host_nvic_enabled[irq] = 0; }
+static inline void NVIC_SetPendingIRQ(IRQn_Type irq) { host_nvic_pending[irq] = 1; Host_Model_Access(); }
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irq) { host_nvic_pending[irq] = 0; }
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+	if (irq >= 0)
+	{
+		host_nvic_priority[irq] = priority;
+	}
+}
+
+#endif
@@ -0,0 +1,410 @@
+/**
+ * @file hc06_model.c
+ *
+ * @brief Host model of the HC-06 module, running the HC06 driver of the firmware.
+ *
+ * HC06.c is compiled against the register model in Host_Model, with the UART1 and
+ * SysTick_Delay functions it uses replaced by the ones below. UART1 is the slave side
+ * of a pseudo-terminal: UART1_Set_Baud_Rate sets its speed with tcsetattr, and the
+ * bytes written and read go through the pty. The time is the host's monotonic clock.
+ *
+ * A thread plays the module on the master side of the pty. Like the original firmware
+ * ("linvor"), it takes a command as complete once no byte has arrived for
+ * MODEL_COMMAND_GAP_MS, and answers it if the pty runs at the module's baud rate
+ * (read back with tcgetattr on the master):
+ *  - "AT" is answered with "OK".
+ *  - "AT+BAUDn" is answered with "OK<rate>" at the old rate, then the module moves to
+ *    the new rate.
+ * A command sent at another rate is noise to the module, which ignores it. The module
+ * can be told to never answer (a controller is connected), or to acknowledge a switch
+ * to one rate without moving to it (a module that does not support that rate).
+ *
+ * Each scenario starts the module at a baud rate and runs HC06_Autoconfigure, then checks:
+ *  - The returned rate, the rate in HC06_Status, and the speed of the pty agree, and are
+ *    the rate expected for the scenario.
+ *  - The module answers at that rate (it is never left at a rate UART1 does not use).
+ *  - The number of rejected rates.
+ *  - The time spent, measured and reported in HC06_Status, is within HC06_BOOT_BUDGET_MS.
+ *
+ * A pty has no framing or parity errors, so UART1_Get_Stats reports none.
+ *
+ * Build:
+ *   gcc -O2 -pthread -IHost_Model -I../Keil_Project -o hc06_model \
+ *       hc06_model.c Host_Model/Host_Model.c ../Keil_Project/HC06.c
+ *
+ * Usage:
+ *   hc06_model [scenario]
+ *
+ * @author
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "HC06.h"
+
+// Time without a byte after which the module takes a command as complete
+#define MODEL_COMMAND_GAP_MS  20
+
+// Time HC06_Autoconfigure may take beyond HC06_BOOT_BUDGET_MS: the last command is
+// queued after the budget check, and the host does not run the threads in real time
+#define MODEL_BUDGET_MARGIN_MS 50
+
+typedef struct
+{
+	const char *name;
+
+	// Rate the module is at when the firmware boots
+	uint32_t module_baud_rate;
+
+	// Set if the module never answers
+	uint8_t silent;
+
+	// Rate the module acknowledges with "OK" but does not move to (0: none)
+	uint32_t failing_baud_rate;
+
+	// Expected results of HC06_Autoconfigure
+	uint32_t expected_baud_rate;
+	uint32_t expected_rejected_rates;
+} Model_Scenario;
+
+static const Model_Scenario model_scenarios[] =
+{
+	// First boot: the module is at its factory rate and is moved to the fastest rate
+	{"first boot",    9600,   0, 0,      115200, 0},
+
+	// Every later boot: the first probe succeeds and nothing changes
+	{"later boot",    115200, 0, 0,      115200, 0},
+
+	// Found late in the probe: no time is left to change the rate, which is kept
+	{"late answer",   38400,  0, 0,      38400,  0},
+
+	// No answer (a controller is connected): the module is left alone
+	{"no answer",     9600,   1, 0,      UART1_DEFAULT_BAUD_RATE, 0},
+
+	// The module acknowledges 115200 but stays at 9600: it is found again at 9600
+	{"failed switch", 9600,   0, 115200, 9600,   1},
+
+	// The same, but found late: a change is only started if the module can be found again
+	{"late failed switch", 57600, 0, 115200, 57600, 0}
+};
+
+#define MODEL_SCENARIO_COUNT (sizeof(model_scenarios) / sizeof(model_scenarios[0]))
+
+// Module side (master of the pty)
+static int module_fd = -1;
+static const Model_Scenario *module_scenario;
+static volatile uint32_t module_baud_rate;
+static volatile uint8_t module_running;
+static uint32_t module_ignored;
+
+// Firmware side (slave of the pty)
+static int uart_fd = -1;
+static uint32_t uart_baud_rate;
+static uint8_t uart_rx[64];
+static uint32_t uart_rx_count;
+
+static struct timespec model_start;
+
+static uint32_t tests_failed = 0;
+
+static speed_t Model_Speed(uint32_t baud_rate)
+{
+	switch (baud_rate)
+	{
+		case 1200:   return B1200;
+		case 2400:   return B2400;
+		case 4800:   return B4800;
+		case 9600:   return B9600;
+		case 19200:  return B19200;
+		case 38400:  return B38400;
+		case 57600:  return B57600;
+		case 115200: return B115200;
+		case 230400: return B230400;
+		default:     return B0;
+	}
+}
+
+// Rate of an "AT+BAUDn" argument
+static uint32_t Model_Baud_Code(char code)
+{
+	static const uint32_t rates[] = {1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400};
+
+	if ((code < '1') || (code > '9'))
+	{
+		return 0;
+	}
+
+	return rates[code - '1'];
+}
+
+// Stand-ins of the SysTick_Delay and UART1 functions used by HC06.c
+uint32_t SysTick_Now_ms(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint32_t)(((now.tv_sec - model_start.tv_sec) * 1000) + ((now.tv_nsec - model_start.tv_nsec) / 1000000));
+}
+
+void SysTick_Delay1ms(uint32_t delay_in_ms)
+{
+	struct timespec delay = {delay_in_ms / 1000, (long)(delay_in_ms % 1000) * 1000000};
+
+	nanosleep(&delay, 0);
+}
+
+void UART1_Set_Baud_Rate(uint32_t baud_rate)
+{
+	struct termios settings;
+
+	tcgetattr(uart_fd, &settings);
+	cfmakeraw(&settings);
+	cfsetispeed(&settings, Model_Speed(baud_rate));
+	cfsetospeed(&settings, Model_Speed(baud_rate));
+	tcsetattr(uart_fd, TCSANOW, &settings);
+
+	uart_baud_rate = baud_rate;
+}
+
+uint32_t UART1_Write_String(const char *string)
+{
+	ssize_t written = write(uart_fd, string, strlen(string));
+
+	return (written > 0) ? (uint32_t)written : 0;
+}
+
+static void Model_UART_Receive(void)
+{
+	if (uart_rx_count == 0)
+	{
+		ssize_t received = read(uart_fd, uart_rx, sizeof(uart_rx));
+
+		if (received > 0)
+		{
+			uart_rx_count = (uint32_t)received;
+		}
+		else
+		{
+			// Let the module run while the firmware polls
+			usleep(100);
+		}
+	}
+}
+
+uint32_t UART1_RX_Peek(const uint8_t **data)
+{
+	Model_UART_Receive();
+	*data = uart_rx;
+
+	return uart_rx_count;
+}
+
+void UART1_RX_Consume(uint32_t length)
+{
+	if (length > uart_rx_count)
+	{
+		length = uart_rx_count;
+	}
+
+	memmove(uart_rx, &uart_rx[length], uart_rx_count - length);
+	uart_rx_count -= length;
+}
+
+uint8_t UART1_Read_Byte(uint8_t *data)
+{
+	const uint8_t *available;
+
+	if (UART1_RX_Peek(&available) == 0)
+	{
+		return 0;
+	}
+
+	*data = available[0];
+	UART1_RX_Consume(1);
+
+	return 1;
+}
+
+void UART1_Get_Stats(UART1_Stats *stats)
+{
+	UART1_Stats no_errors = {0};
+
+	*stats = no_errors;
+}
+
+// Answers one complete command, if it was sent at the module's rate
+static void Module_Answer(const char *command)
+{
+	struct termios settings;
+	char answer[16];
+
+	tcgetattr(module_fd, &settings);
+
+	if (module_scenario->silent || (cfgetospeed(&settings) != Model_Speed(module_baud_rate)))
+	{
+		module_ignored++;
+		return;
+	}
+
+	if (strcmp(command, "AT") == 0)
+	{
+		write(module_fd, "OK", 2);
+	}
+	else if ((strncmp(command, "AT+BAUD", 7) == 0) && (strlen(command) == 8) && (Model_Baud_Code(command[7]) != 0))
+	{
+		uint32_t baud_rate = Model_Baud_Code(command[7]);
+
+		snprintf(answer, sizeof(answer), "OK%u", baud_rate);
+		write(module_fd, answer, strlen(answer));
+
+		if (baud_rate != module_scenario->failing_baud_rate)
+		{
+			module_baud_rate = baud_rate;
+		}
+	}
+}
+
+static void *Module_Thread(void *argument)
+{
+	char command[32];
+	uint32_t length = 0;
+
+	(void)argument;
+
+	while (module_running)
+	{
+		struct pollfd input = {module_fd, POLLIN, 0};
+
+		if (poll(&input, 1, MODEL_COMMAND_GAP_MS) <= 0)
+		{
+			// A pause ends the command
+			if (length > 0)
+			{
+				command[length] = '\0';
+				Module_Answer(command);
+				length = 0;
+			}
+			continue;
+		}
+
+		char data;
+
+		if ((read(module_fd, &data, 1) == 1) && (length < (sizeof(command) - 1)))
+		{
+			command[length++] = data;
+		}
+	}
+
+	return 0;
+}
+
+static void Check(int condition, const char *test, const char *message)
+{
+	if (!condition)
+	{
+		printf("FAIL: %s: %s\n", test, message);
+		tests_failed++;
+	}
+}
+
+static void Run_Scenario(const Model_Scenario *scenario)
+{
+	const char *test = scenario->name;
+	pthread_t module_thread;
+	HC06_Status status;
+
+	module_fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if ((module_fd < 0) || (grantpt(module_fd) != 0) || (unlockpt(module_fd) != 0))
+	{
+		printf("FAIL: %s: cannot open a pty\n", test);
+		exit(1);
+	}
+
+	uart_fd = open(ptsname(module_fd), O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (uart_fd < 0)
+	{
+		printf("FAIL: %s: cannot open %s\n", test, ptsname(module_fd));
+		exit(1);
+	}
+
+	// UART1_Init runs at the default rate before the autoconfiguration
+	uart_rx_count = 0;
+	UART1_Set_Baud_Rate(UART1_DEFAULT_BAUD_RATE);
+
+	module_scenario = scenario;
+	module_baud_rate = scenario->module_baud_rate;
+	module_ignored = 0;
+	module_running = 1;
+	pthread_create(&module_thread, 0, Module_Thread, 0);
+
+	uint32_t start_ms = SysTick_Now_ms();
+	uint32_t baud_rate = HC06_Autoconfigure();
+	uint32_t elapsed_ms = SysTick_Now_ms() - start_ms;
+
+	HC06_Get_Status(&status);
+
+	// Let the module take the last command, then check that it answers at the rate UART1 uses
+	SysTick_Delay1ms(2 * MODEL_COMMAND_GAP_MS);
+	uint8_t reachable = !scenario->silent && (module_baud_rate == uart_baud_rate);
+
+	module_running = 0;
+	pthread_join(module_thread, 0);
+	close(uart_fd);
+	close(module_fd);
+
+	Check(baud_rate == scenario->expected_baud_rate, test, "unexpected baud rate");
+	Check((status.active_baud_rate == baud_rate) && (uart_baud_rate == baud_rate), test, "UART1 does not use the returned rate");
+	Check(scenario->silent || reachable, test, "the module was left at a rate UART1 does not use");
+	Check(status.detected_baud_rate == (scenario->silent ? 0 : scenario->module_baud_rate), test, "unexpected detected rate");
+	Check(status.rejected_rates == scenario->expected_rejected_rates, test, "unexpected number of rejected rates");
+	Check((elapsed_ms <= (HC06_BOOT_BUDGET_MS + MODEL_BUDGET_MARGIN_MS)) && (status.boot_time_in_ms <= elapsed_ms),
+		test, "the boot budget was exceeded");
+
+	printf("%s: module at %u -> %u bps in %u ms (%u commands, %u ignored by the module, %u timeouts, %u rejected%s)\n",
+		test, scenario->module_baud_rate, baud_rate, elapsed_ms, status.commands_sent, module_ignored,
+		status.timeouts, status.rejected_rates, status.budget_exhausted ? ", budget exhausted" : "");
+}
+
+int main(int argc, char *argv[])
+{
+	clock_gettime(CLOCK_MONOTONIC, &model_start);
+
+	uint32_t scenarios = 0;
+
+	for (uint32_t i = 0; i < MODEL_SCENARIO_COUNT; i++)
+	{
+		if ((argc > 1) && (strcmp(argv[1], model_scenarios[i].name) != 0))
+		{
+			continue;
+		}
+
+		Run_Scenario(&model_scenarios[i]);
+		scenarios++;
+	}
+
+	if (scenarios == 0)
+	{
+		printf("Unknown scenario: %s\n", argv[1]);
+		return 1;
+	}
+
+	if (tests_failed != 0)
+	{
+		printf("%u checks failed\n", tests_failed);
+		return 1;
+	}
+
+	printf("all checks passed\n");
+
+	return 0;
+}
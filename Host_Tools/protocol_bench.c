@@ -0,0 +1,231 @@
+/**
+ * @file protocol_bench.c
+ *
+ * @brief Host benchmark of the incremental frame parser of the Protocol library.
+ *
+ * A stream of valid frames is fed one byte at a time to Protocol_Parse_Byte:
+ * setpoint frames, which make up most of the traffic to the car, and frames with
+ * random payloads of every length up to PROTOCOL_MAX_PAYLOAD_SIZE. The benchmark reports:
+ *  - The throughput in bytes per second over the whole stream.
+ *  - The worst-case time of a single call, split by the kind of byte (COBS code byte,
+ *    data byte, or delimiter). Each call is timed on every pass over the stream, and the
+ *    fastest pass is kept for each byte, so interrupts and cache misses on the host do
+ *    not show up as a slow byte. The worst case is then the slowest byte of the stream.
+ *
+ * The times are taken with the time-stamp counter on x86 (cycles of the reference
+ * clock), or with clock_gettime in ns on other hosts. They compare parser versions on
+ * the same host; on the car, the PROFILE_COMMAND_PROCESS region measures Command_Process.
+ *
+ * Build:
+ *   gcc -O2 -I../Keil_Project -o protocol_bench protocol_bench.c ../Keil_Project/Protocol.c
+ *
+ * Usage:
+ *   protocol_bench [frames] [passes]
+ *
+ * @author
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Protocol.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+static inline uint64_t Bench_Timestamp(void)
+{
+	unsigned int aux;
+
+	return __rdtscp(&aux);
+}
+#else
+#define BENCH_UNIT "ns"
+static inline uint64_t Bench_Timestamp(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+#endif
+
+enum Bench_Byte_Kinds
+{
+	BENCH_BYTE_CODE      = 0,
+	BENCH_BYTE_DATA      = 1,
+	BENCH_BYTE_DELIMITER = 2,
+	BENCH_BYTE_KINDS     = 3
+};
+
+static const char *const bench_kind_names[BENCH_BYTE_KINDS] = {"code byte", "data byte", "delimiter"};
+
+// Kind of each byte of an encoded frame, found by walking its COBS blocks
+static void Bench_Classify(const uint8_t *frame, uint32_t length, uint8_t *kinds)
+{
+	uint32_t next_code = 0;
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		if (frame[i] == PROTOCOL_DELIMITER)
+		{
+			kinds[i] = BENCH_BYTE_DELIMITER;
+		}
+		else if (i == next_code)
+		{
+			kinds[i] = BENCH_BYTE_CODE;
+			next_code = i + frame[i];
+		}
+		else
+		{
+			kinds[i] = BENCH_BYTE_DATA;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t frame_count = (argc > 1) ? (uint32_t)strtoul(argv[1], 0, 0) : 20000;
+	uint32_t passes = (argc > 2) ? (uint32_t)strtoul(argv[2], 0, 0) : 50;
+
+	uint8_t *stream = malloc((size_t)frame_count * PROTOCOL_MAX_ENCODED_SIZE);
+	uint8_t *kinds = malloc((size_t)frame_count * PROTOCOL_MAX_ENCODED_SIZE);
+	uint64_t length = 0;
+
+	srand(1);
+
+	// Three setpoints for each frame with a random payload
+	for (uint32_t n = 0; n < frame_count; n++)
+	{
+		uint8_t payload[PROTOCOL_MAX_PAYLOAD_SIZE];
+		uint32_t frame_length;
+
+		if ((n % 4) != 3)
+		{
+			Protocol_Setpoint setpoint = {(int16_t)((rand() % 2001) - 1000), (int16_t)((rand() % 2001) - 1000)};
+			uint32_t payload_length = Protocol_Pack_Setpoint(&setpoint, payload);
+
+			frame_length = Protocol_Encode_Frame(PROTOCOL_MSG_SETPOINT, (uint8_t)n, payload, payload_length, &stream[length]);
+		}
+		else
+		{
+			uint32_t payload_length = (n / 4) % (PROTOCOL_MAX_PAYLOAD_SIZE + 1);
+
+			for (uint32_t i = 0; i < payload_length; i++)
+			{
+				payload[i] = (uint8_t)rand();
+			}
+
+			frame_length = Protocol_Encode_Frame(PROTOCOL_MSG_STEERING_TABLE, (uint8_t)n, payload, payload_length, &stream[length]);
+		}
+
+		Bench_Classify(&stream[length], frame_length, &kinds[length]);
+		length += frame_length;
+	}
+
+	uint64_t *fastest = malloc(length * sizeof(uint64_t));
+	Protocol_Parser parser;
+	uint32_t accepted = 0;
+	double best_seconds = 0;
+
+	for (uint64_t i = 0; i < length; i++)
+	{
+		fastest[i] = UINT64_MAX;
+	}
+
+	// Throughput: the parser alone, without timing each call
+	for (uint32_t pass = 0; pass < passes; pass++)
+	{
+		struct timespec start;
+		struct timespec end;
+
+		Protocol_Parser_Reset(&parser);
+		accepted = 0;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+		for (uint64_t i = 0; i < length; i++)
+		{
+			accepted += (Protocol_Parse_Byte(&parser, stream[i]) == PROTOCOL_OK);
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		double seconds = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) * 1e-9);
+
+		if ((pass == 0) || (seconds < best_seconds))
+		{
+			best_seconds = seconds;
+		}
+	}
+
+	if (accepted != frame_count)
+	{
+		printf("FAIL: %u of %u frames accepted\n", accepted, frame_count);
+		return 1;
+	}
+
+	// Time of each call: the fastest of all passes for each byte
+	uint64_t overhead = UINT64_MAX;
+
+	for (uint32_t i = 0; i < 1000; i++)
+	{
+		uint64_t start = Bench_Timestamp();
+		uint64_t end = Bench_Timestamp();
+
+		if ((end - start) < overhead)
+		{
+			overhead = end - start;
+		}
+	}
+
+	for (uint32_t pass = 0; pass < passes; pass++)
+	{
+		Protocol_Parser_Reset(&parser);
+
+		for (uint64_t i = 0; i < length; i++)
+		{
+			uint64_t start = Bench_Timestamp();
+			Protocol_Parse_Byte(&parser, stream[i]);
+			uint64_t elapsed = Bench_Timestamp() - start;
+
+			if (elapsed < fastest[i])
+			{
+				fastest[i] = elapsed;
+			}
+		}
+	}
+
+	uint64_t worst[BENCH_BYTE_KINDS] = {0};
+	uint64_t total[BENCH_BYTE_KINDS] = {0};
+	uint64_t count[BENCH_BYTE_KINDS] = {0};
+
+	for (uint64_t i = 0; i < length; i++)
+	{
+		uint64_t elapsed = (fastest[i] > overhead) ? (fastest[i] - overhead) : 0;
+
+		worst[kinds[i]] = (elapsed > worst[kinds[i]]) ? elapsed : worst[kinds[i]];
+		total[kinds[i]] += elapsed;
+		count[kinds[i]]++;
+	}
+
+	printf("%u frames, %llu bytes, best of %u passes\n", frame_count, (unsigned long long)length, passes);
+	printf("  throughput: %.1f MB/s (%.2f ns per byte)\n",
+		((double)length / best_seconds) / 1e6, (best_seconds * 1e9) / (double)length);
+	printf("  per call (%s, timer overhead of %llu removed):\n", BENCH_UNIT, (unsigned long long)overhead);
+
+	for (uint32_t kind = 0; kind < BENCH_BYTE_KINDS; kind++)
+	{
+		printf("    %-10s mean %5.1f  worst %3llu  (%llu bytes)\n", bench_kind_names[kind],
+			(double)total[kind] / (double)count[kind], (unsigned long long)worst[kind], (unsigned long long)count[kind]);
+	}
+
+	free(fastest);
+	free(kinds);
+	free(stream);
+
+	return 0;
+}
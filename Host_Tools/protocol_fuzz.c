@@ -0,0 +1,315 @@
+/**
+ * @file protocol_fuzz.c
+ *
+ * @brief Host fuzz driver for the incremental frame parser of the Protocol library.
+ *
+ * Random byte streams and mutated valid frames are fed one byte at a time to
+ * Protocol_Parse_Byte, as Command_Process does with the bytes received on UART1.
+ * Every frame that ends at a delimiter is also decoded in one piece with
+ * Protocol_Decode_Frame, which serves as the reference:
+ *  - Both decoders must accept the same frames, with the same header and payload.
+ *  - A valid frame sent after any garbage and a delimiter must be received intact.
+ *  - A frame that the parser accepts is never longer than PROTOCOL_MAX_PAYLOAD_SIZE.
+ *
+ * The mutations are bit flips, byte changes, insertions, deletions, truncations,
+ * delimiters in the middle of a frame, and frames that are made too long. Build with
+ * -fsanitize=address,undefined to also catch out-of-bounds accesses.
+ *
+ * Build:
+ *   gcc -O2 -g -fsanitize=address,undefined -I../Keil_Project -o protocol_fuzz \
+ *       protocol_fuzz.c ../Keil_Project/Protocol.c
+ *
+ * Usage:
+ *   protocol_fuzz [iterations] [seed]
+ *
+ * @author
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Protocol.h"
+
+// Longest stream built by one iteration
+#define FUZZ_MAX_STREAM_SIZE 1024
+
+static uint64_t fuzz_random_state = 1;
+
+static uint32_t Fuzz_Random(uint32_t limit)
+{
+	// xorshift64*
+	fuzz_random_state ^= fuzz_random_state >> 12;
+	fuzz_random_state ^= fuzz_random_state << 25;
+	fuzz_random_state ^= fuzz_random_state >> 27;
+
+	return (uint32_t)(((fuzz_random_state * 0x2545F4914F6CDD1DULL) >> 32) % limit);
+}
+
+static uint32_t Fuzz_Valid_Frame(uint8_t *output)
+{
+	uint8_t payload[PROTOCOL_MAX_PAYLOAD_SIZE];
+	uint32_t payload_length = Fuzz_Random(PROTOCOL_MAX_PAYLOAD_SIZE + 1);
+
+	// Zeros and 0xFF are frequent in real payloads and exercise the COBS blocks
+	for (uint32_t i = 0; i < payload_length; i++)
+	{
+		uint32_t choice = Fuzz_Random(4);
+
+		payload[i] = (choice == 0) ? 0x00 : ((choice == 1) ? 0xFF : (uint8_t)Fuzz_Random(256));
+	}
+
+	return Protocol_Encode_Frame((uint8_t)Fuzz_Random(256), (uint8_t)Fuzz_Random(256), payload, payload_length, output);
+}
+
+static uint32_t Fuzz_Mutate(uint8_t *data, uint32_t length, uint32_t size)
+{
+	uint32_t count = Fuzz_Random(4) + 1;
+
+	for (uint32_t n = 0; n < count; n++)
+	{
+		uint32_t position = (length > 0) ? Fuzz_Random(length) : 0;
+
+		switch (Fuzz_Random(7))
+		{
+			case 0:
+			{
+				if (length > 0)
+				{
+					data[position] ^= (uint8_t)(1 << Fuzz_Random(8));
+				}
+				break;
+			}
+
+			case 1:
+			{
+				if (length > 0)
+				{
+					data[position] = (uint8_t)Fuzz_Random(256);
+				}
+				break;
+			}
+
+			case 2:
+			{
+				if (length < size)
+				{
+					memmove(&data[position + 1], &data[position], length - position);
+					data[position] = (uint8_t)Fuzz_Random(256);
+					length++;
+				}
+				break;
+			}
+
+			case 3:
+			{
+				if (length > 0)
+				{
+					memmove(&data[position], &data[position + 1], length - position - 1);
+					length--;
+				}
+				break;
+			}
+
+			case 4:
+			{
+				length = position;
+				break;
+			}
+
+			case 5:
+			{
+				if (length > 0)
+				{
+					data[position] = PROTOCOL_DELIMITER;
+				}
+				break;
+			}
+
+			default:
+			{
+				// Grow the frame past the largest valid size with non-zero bytes
+				uint32_t extra = Fuzz_Random(2 * PROTOCOL_MAX_ENCODED_SIZE);
+
+				if ((length > 0) && ((length + extra) <= size))
+				{
+					memmove(&data[position + extra], &data[position], length - position);
+					for (uint32_t i = 0; i < extra; i++)
+					{
+						data[position + i] = (uint8_t)(Fuzz_Random(255) + 1);
+					}
+					length += extra;
+				}
+				break;
+			}
+		}
+	}
+
+	return length;
+}
+
+static int Fuzz_Same_Frame(const Protocol_Frame *a, const Protocol_Frame *b)
+{
+	return (a->type == b->type) && (a->sequence == b->sequence) && (a->payload_length == b->payload_length) &&
+		(memcmp(a->payload, b->payload, a->payload_length) == 0);
+}
+
+static void Fuzz_Fail(const char *reason, uint64_t iteration, const uint8_t *stream, uint32_t length)
+{
+	printf("FAIL: iteration %llu: %s\nStream (%u bytes):", (unsigned long long)iteration, reason, length);
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		printf("%s%02X", ((i % 32) == 0) ? "\n  " : " ", stream[i]);
+	}
+
+	printf("\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t iterations = (argc > 1) ? strtoull(argv[1], 0, 0) : 1000000;
+	fuzz_random_state = (argc > 2) ? strtoull(argv[2], 0, 0) : 1;
+
+	if (fuzz_random_state == 0)
+	{
+		fuzz_random_state = 1;
+	}
+
+	static uint8_t stream[FUZZ_MAX_STREAM_SIZE + PROTOCOL_MAX_ENCODED_SIZE];
+	Protocol_Parser parser;
+	uint64_t frames = 0;
+	uint64_t accepted = 0;
+	uint64_t status_counts[PROTOCOL_IN_PROGRESS] = {0};
+
+	for (uint64_t iteration = 0; iteration < iterations; iteration++)
+	{
+		uint32_t length = 0;
+
+		// Garbage: random bytes, or one or more mutated frames
+		switch (Fuzz_Random(3))
+		{
+			case 0:
+			{
+				length = Fuzz_Random(FUZZ_MAX_STREAM_SIZE / 2);
+
+				for (uint32_t i = 0; i < length; i++)
+				{
+					stream[i] = (Fuzz_Random(8) == 0) ? PROTOCOL_DELIMITER : (uint8_t)Fuzz_Random(256);
+				}
+				break;
+			}
+
+			default:
+			{
+				uint32_t count = Fuzz_Random(4) + 1;
+
+				for (uint32_t n = 0; (n < count) && ((length + PROTOCOL_MAX_ENCODED_SIZE) <= (FUZZ_MAX_STREAM_SIZE / 2)); n++)
+				{
+					uint32_t frame_length = Fuzz_Valid_Frame(&stream[length]);
+
+					if (Fuzz_Random(4) != 0)
+					{
+						frame_length = Fuzz_Mutate(&stream[length], frame_length, (FUZZ_MAX_STREAM_SIZE / 2) - length);
+					}
+
+					length += frame_length;
+				}
+				break;
+			}
+		}
+
+		// A delimiter and a valid frame that must survive the garbage
+		stream[length++] = PROTOCOL_DELIMITER;
+
+		uint32_t valid_start = length;
+		length += Fuzz_Valid_Frame(&stream[length]);
+
+		Protocol_Frame expected;
+		if (Protocol_Decode_Frame(&stream[valid_start], length - valid_start - 1, &expected) != PROTOCOL_OK)
+		{
+			Fuzz_Fail("Protocol_Decode_Frame rejects a frame from Protocol_Encode_Frame", iteration, stream, length);
+		}
+
+		// Parse the whole stream from a fresh parser, as after Command_Init
+		Protocol_Parser_Reset(&parser);
+
+		uint32_t frame_start = 0;
+		uint8_t valid_received = 0;
+
+		for (uint32_t i = 0; i < length; i++)
+		{
+			uint8_t status = Protocol_Parse_Byte(&parser, stream[i]);
+
+			if (stream[i] != PROTOCOL_DELIMITER)
+			{
+				if (status != PROTOCOL_IN_PROGRESS)
+				{
+					Fuzz_Fail("a frame ended without a delimiter", iteration, stream, length);
+				}
+				continue;
+			}
+
+			uint32_t frame_length = i - frame_start;
+
+			if (frame_length == 0)
+			{
+				if (status != PROTOCOL_IN_PROGRESS)
+				{
+					Fuzz_Fail("an empty frame was reported", iteration, stream, length);
+				}
+			}
+			else
+			{
+				Protocol_Frame reference;
+				uint8_t reference_status = Protocol_Decode_Frame(&stream[frame_start], frame_length, &reference);
+
+				frames++;
+
+				if (status >= PROTOCOL_IN_PROGRESS)
+				{
+					Fuzz_Fail("no status at the end of a frame", iteration, stream, length);
+				}
+
+				status_counts[status]++;
+
+				if ((status == PROTOCOL_OK) != (reference_status == PROTOCOL_OK))
+				{
+					Fuzz_Fail("the parser and Protocol_Decode_Frame disagree", iteration, stream, length);
+				}
+
+				if (status == PROTOCOL_OK)
+				{
+					accepted++;
+
+					if ((parser.frame.payload_length > PROTOCOL_MAX_PAYLOAD_SIZE) || !Fuzz_Same_Frame(&parser.frame, &reference))
+					{
+						Fuzz_Fail("the parser and Protocol_Decode_Frame decoded different frames", iteration, stream, length);
+					}
+
+					if ((frame_start == valid_start) && Fuzz_Same_Frame(&parser.frame, &expected))
+					{
+						valid_received = 1;
+					}
+				}
+			}
+
+			frame_start = i + 1;
+		}
+
+		if (!valid_received)
+		{
+			Fuzz_Fail("the valid frame after the garbage was lost", iteration, stream, length);
+		}
+	}
+
+	printf("%llu iterations, %llu frames, %llu accepted\n",
+		(unsigned long long)iterations, (unsigned long long)frames, (unsigned long long)accepted);
+	printf("  errors: cobs %llu, length %llu, crc %llu, version %llu, oversize %llu\n",
+		(unsigned long long)status_counts[PROTOCOL_ERROR_COBS], (unsigned long long)status_counts[PROTOCOL_ERROR_LENGTH],
+		(unsigned long long)status_counts[PROTOCOL_ERROR_CRC], (unsigned long long)status_counts[PROTOCOL_ERROR_VERSION],
+		(unsigned long long)status_counts[PROTOCOL_ERROR_OVERSIZE]);
+
+	return 0;
+}
@@ -0,0 +1,775 @@
+/**
+ * @file pwm_model.c
+ *
+ * @brief Host model of the PWM generators, running the PWM driver of the firmware.
+ *
+ * PWM.c is compiled against the register model in Host_Model. This file models
+ * the generators of PWM module 0 as the driver configures them, one PWM clock tick
+ * at a time (PWM_CLOCK_DIVIDER system clock cycles):
+ *  - Each enabled generator counts down from LOAD to 0. At the LOAD event (the tick
+ *    after 0), the outputs act as set by their GENA/GENB actions (high for the driver),
+ *    and the LOAD interrupt of generator 0 is raised (INTCNTLOAD).
+ *  - Outputs change again when the counter matches their compare value on the way down.
+ *  - Compare values in global synchronization mode (CMPAUPD/CMPBUPD) are held until
+ *    GLOBALSYNCn is set in PWMCTL. They are applied when the counter reaches 0, and the
+ *    hardware then clears GLOBALSYNCn. Locally synchronized PWMENABLE bits (PWMENUPD)
+ *    are applied at the same time.
+ *  - Writing SYNCn to PWMSYNC resets the counter of generator n to 0, which applies the
+ *    held values; the next tick is a LOAD event.
+ *  - While a generator is disabled, its compare values apply at once, and once it is
+ *    enabled, its first tick is a LOAD event.
+ *  - An output pin is high only while its generator output is high and its PWMENABLE
+ *    bit is applied.
+ *
+ * Each register access from the firmware costs MODEL_ACCESS_CYCLES. PWM0_0_Handler runs
+ * between two ticks once PRIMASK is clear, and no time passes while it runs.
+ *
+ * The tests record the pulses on each pin (start time and width) and check:
+ *  - The pulse widths after PWM_Init, and after writes at every phase of the period.
+ *  - The update order: values written together by PWM_Set_Outputs start in the same
+ *    period (or at the next period of each generator), and no pulse ever has a width
+ *    other than the old or the new one.
+ *  - The throttle slew limiter: one step per ESC pulse, from neutral to full throttle, with the
+ *    throttle written every ESC_FRAME_US like the control task does.
+ *  - The setpoint-to-pulse latency of PWM_Set_Setpoint with the slew limiter off, for writes
+ *    every ESC_FRAME_US (with some jitter, like the control task) and at random times. Where
+ *    writes restart generator 0 (OneShot125, or PWM_PHASE_RESET_ENABLE), a write made once the
+ *    minimum frame has elapsed starts the new pulse within a few ticks, every other write starts
+ *    it by the next period, and no two pulses start closer than the minimum frame.
+ *  - The pulse range of ESC_Set_Pulse_us: widths inside ESC_MIN_PULSE_US to ESC_MAX_PULSE_US
+ *    (in the units of the signal mode) are sent as set, and widths outside it are clamped.
+ *
+ * Build (default configuration: servo on generator 0):
+ *   gcc -O2 -IHost_Model -I../Keil_Project -DEVENT_TRACE_ENABLE=0 -DPROFILE_ENABLE=0 -o pwm_model \
+ *       pwm_model.c Host_Model/Host_Model.c ../Keil_Project/PWM.c ../Keil_Project/Steering.c
+ *
+ * Add -DPWM_SERVO_GENERATOR=1 (or 2) to model the servo on its own generator, and
+ * -DESC_SIGNAL_MODE=1 -DPWM_SERVO_GENERATOR=1 to model OneShot125. Each configuration can be
+ * built with -DPWM_PHASE_RESET_ENABLE=1 to compare the latencies; with the servo on generator 0,
+ * add -DSERVO_MIN_FRAME_US=3000 (a digital servo) so that generator 0 can be restarted.
+ *
+ * @author
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "PWM.h"
+
+// System clock cycles taken by each register access of the firmware
+#define MODEL_ACCESS_CYCLES 4
+
+// Generators and output pins modeled (M0PWM0 to M0PWM5)
+#define MODEL_GENERATORS    3
+#define MODEL_OUTPUTS       (2 * MODEL_GENERATORS)
+
+// Pulses kept for each output pin
+#define MODEL_PULSE_LOG     64
+
+// Registers of one generator, in the order of PWM0_Type
+enum Model_Generator_Registers
+{
+	MODEL_GEN_CTL   = 0,
+	MODEL_GEN_INTEN = 1,
+	MODEL_GEN_RIS   = 2,
+	MODEL_GEN_ISC   = 3,
+	MODEL_GEN_LOAD  = 4,
+	MODEL_GEN_COUNT = 5,
+	MODEL_GEN_CMPA  = 6,
+	MODEL_GEN_CMPB  = 7,
+	MODEL_GEN_GENA  = 8,
+	MODEL_GEN_GENB  = 9,
+	MODEL_GEN_SIZE  = 16
+};
+
+typedef struct
+{
+	// Rising edge time, in system clock cycles
+	uint64_t start;
+
+	// Width in PWM clock ticks
+	uint32_t width;
+} Model_Pulse;
+
+typedef struct
+{
+	uint32_t count;
+	uint32_t cmpa;
+	uint32_t cmpb;
+
+	// Generator outputs A and B
+	uint8_t output[2];
+} Model_Generator;
+
+static uint64_t model_cycles = 0;
+static uint32_t model_tick_phase = 0;
+static Model_Generator model_generators[MODEL_GENERATORS];
+
+// PWMENABLE bits that drive the pins (after PWMENUPD)
+static uint32_t model_enable = 0;
+
+// Pin levels and recorded pulses of each output
+static uint8_t model_pin[MODEL_OUTPUTS];
+static uint64_t model_pin_rise[MODEL_OUTPUTS];
+static Model_Pulse model_pulses[MODEL_OUTPUTS][MODEL_PULSE_LOG];
+static uint32_t model_pulse_count[MODEL_OUTPUTS];
+
+// Shortest time between two rising edges of each output, in system clock cycles
+static uint64_t model_pin_min_period[MODEL_OUTPUTS];
+
+// Set while an interrupt handler runs
+static uint8_t model_in_handler = 0;
+
+static uint32_t tests_failed = 0;
+
+// Stubs of the drivers used by PWM.c
+void Tracepoint_PWM_Load(void)
+{
+}
+
+uint8_t Executive_Post_Event(uint8_t type, uint32_t data)
+{
+	(void)type;
+	(void)data;
+
+	return 1;
+}
+
+uint32_t SysTick_Now_ms(void)
+{
+	return (uint32_t)(model_cycles / (SYSTEM_CLOCK_HZ / 1000));
+}
+
+static volatile uint32_t *Model_Generator_Registers(uint32_t generator)
+{
+	return &host_pwm[0]._0_CTL + (generator * MODEL_GEN_SIZE);
+}
+
+static uint32_t Random_Below(uint32_t limit)
+{
+	return (uint32_t)(((uint64_t)rand() * limit) / ((uint64_t)RAND_MAX + 1));
+}
+
+static void Model_Update_Pins(void)
+{
+	for (uint32_t pin = 0; pin < MODEL_OUTPUTS; pin++)
+	{
+		uint8_t level = model_generators[pin / 2].output[pin % 2] && (model_enable & (1 << pin));
+
+		if (level && !model_pin[pin])
+		{
+			if ((model_pulse_count[pin] > 0) && ((model_cycles - model_pin_rise[pin]) < model_pin_min_period[pin]))
+			{
+				model_pin_min_period[pin] = model_cycles - model_pin_rise[pin];
+			}
+
+			model_pin_rise[pin] = model_cycles;
+		}
+		else if (!level && model_pin[pin])
+		{
+			Model_Pulse *pulse = &model_pulses[pin][model_pulse_count[pin] % MODEL_PULSE_LOG];
+
+			pulse->start = model_pin_rise[pin];
+			pulse->width = (uint32_t)((model_cycles - model_pin_rise[pin]) / PWM_CLOCK_DIVIDER);
+			model_pulse_count[pin]++;
+		}
+
+		model_pin[pin] = level;
+	}
+}
+
+// Applies a GENA/GENB action (0: none, 1: invert, 2: low, 3: high)
+static void Model_Action(uint8_t *output, uint32_t action)
+{
+	switch (action & 0x03)
+	{
+		case 1:  *output = !*output; break;
+		case 2:  *output = 0;        break;
+		case 3:  *output = 1;        break;
+		default: break;
+	}
+}
+
+// The counter of a generator reached zero: apply the held values
+static void Model_Zero_Event(uint32_t generator)
+{
+	volatile uint32_t *registers = Model_Generator_Registers(generator);
+	Model_Generator *state = &model_generators[generator];
+
+	if (host_pwm[0].CTL & (1 << generator))
+	{
+		state->cmpa = registers[MODEL_GEN_CMPA];
+		state->cmpb = registers[MODEL_GEN_CMPB];
+		host_pwm[0].CTL &= ~(1 << generator);
+	}
+
+	// Locally synchronized enable bits (PWMENUPD field 0x2) of both outputs
+	for (uint32_t pin = 2 * generator; pin < (2 * generator) + 2; pin++)
+	{
+		if (((host_pwm[0].ENUPD >> (2 * pin)) & 0x03) == 0x02)
+		{
+			model_enable = (model_enable & ~(1 << pin)) | (host_pwm[0].ENABLE & (1 << pin));
+		}
+	}
+}
+
+static void Model_Tick(void)
+{
+	for (uint32_t generator = 0; generator < MODEL_GENERATORS; generator++)
+	{
+		volatile uint32_t *registers = Model_Generator_Registers(generator);
+		Model_Generator *state = &model_generators[generator];
+
+		if ((registers[MODEL_GEN_CTL] & 0x01) == 0)
+		{
+			continue;
+		}
+
+		if (state->count == 0)
+		{
+			state->count = registers[MODEL_GEN_LOAD];
+			Model_Action(&state->output[0], registers[MODEL_GEN_GENA] >> 2);
+			Model_Action(&state->output[1], registers[MODEL_GEN_GENB] >> 2);
+
+			if (registers[MODEL_GEN_INTEN] & 0x02)
+			{
+				registers[MODEL_GEN_RIS] |= 0x02;
+			}
+		}
+		else
+		{
+			state->count--;
+
+			if (state->count == 0)
+			{
+				Model_Zero_Event(generator);
+			}
+		}
+
+		// Compare matches while counting down
+		if (state->count == state->cmpa)
+		{
+			Model_Action(&state->output[0], registers[MODEL_GEN_GENA] >> 6);
+			Model_Action(&state->output[1], registers[MODEL_GEN_GENB] >> 6);
+		}
+
+		if (state->count == state->cmpb)
+		{
+			Model_Action(&state->output[0], registers[MODEL_GEN_GENA] >> 10);
+			Model_Action(&state->output[1], registers[MODEL_GEN_GENB] >> 10);
+		}
+
+		registers[MODEL_GEN_COUNT] = state->count;
+	}
+
+	Model_Update_Pins();
+}
+
+// Handles the register writes that have side effects, and runs the pending interrupts
+static void Model_Process(void)
+{
+	for (uint32_t generator = 0; generator < MODEL_GENERATORS; generator++)
+	{
+		volatile uint32_t *registers = Model_Generator_Registers(generator);
+
+		if ((registers[MODEL_GEN_CTL] & 0x01) == 0)
+		{
+			model_generators[generator].cmpa = registers[MODEL_GEN_CMPA];
+			model_generators[generator].cmpb = registers[MODEL_GEN_CMPB];
+		}
+
+		// Write 1 to clear
+		registers[MODEL_GEN_RIS] &= ~registers[MODEL_GEN_ISC];
+		registers[MODEL_GEN_ISC] = 0;
+
+		// PWMSYNC: restart the counter from zero
+		if (host_pwm[0].SYNC & (1 << generator))
+		{
+			model_generators[generator].count = 0;
+			registers[MODEL_GEN_COUNT] = 0;
+			Model_Zero_Event(generator);
+		}
+	}
+
+	host_pwm[0].SYNC = 0;
+
+	// Immediate enable bits (PWMENUPD field 0x0)
+	for (uint32_t pin = 0; pin < MODEL_OUTPUTS; pin++)
+	{
+		if (((host_pwm[0].ENUPD >> (2 * pin)) & 0x03) == 0x00)
+		{
+			model_enable = (model_enable & ~(1 << pin)) | (host_pwm[0].ENABLE & (1 << pin));
+		}
+	}
+
+	Model_Update_Pins();
+
+	uint8_t load_pending = (host_pwm[0]._0_RIS & 0x02) && (host_pwm[0].INTEN & 0x01) && host_nvic_enabled[PWM0_0_IRQn];
+
+	if (load_pending && (host_primask == 0) && !model_in_handler)
+	{
+		model_in_handler = 1;
+		PWM0_0_Handler();
+		model_in_handler = 0;
+
+		Model_Process();
+	}
+}
+
+static void Model_Advance(uint32_t cycles)
+{
+	while (cycles > 0)
+	{
+		cycles--;
+		model_cycles++;
+		model_tick_phase++;
+
+		if (model_tick_phase == PWM_CLOCK_DIVIDER)
+		{
+			model_tick_phase = 0;
+			Model_Tick();
+			Model_Process();
+		}
+	}
+}
+
+// Called before each register access of the firmware
+static void Model_Step(void)
+{
+	if (model_in_handler)
+	{
+		return;
+	}
+
+	Model_Process();
+	Model_Advance(MODEL_ACCESS_CYCLES);
+}
+
+static void Model_Run_us(uint32_t time_in_us)
+{
+	Model_Process();
+	Model_Advance(time_in_us * (SYSTEM_CLOCK_HZ / 1000000));
+}
+
+static void Model_Init(void)
+{
+	memset(&host_pwm[0], 0, sizeof(host_pwm[0]));
+	memset(model_generators, 0, sizeof(model_generators));
+	memset(model_pin, 0, sizeof(model_pin));
+	memset(model_pulse_count, 0, sizeof(model_pulse_count));
+	memset(model_pin_min_period, 0xFF, sizeof(model_pin_min_period));
+	model_enable = 0;
+	host_primask = 0;
+
+	host_model_step = Model_Step;
+	PWM_Init();
+	Steering_Init(0);
+}
+
+// Pulses recorded on an output pin since a given count
+static uint32_t Model_Pulses_Since(uint32_t pin, uint32_t first, Model_Pulse *pulses, uint32_t size)
+{
+	uint32_t count = 0;
+
+	for (uint32_t i = first; (i < model_pulse_count[pin]) && (count < size); i++)
+	{
+		pulses[count++] = model_pulses[pin][i % MODEL_PULSE_LOG];
+	}
+
+	return count;
+}
+
+static void Check(int condition, const char *test, const char *message)
+{
+	if (!condition)
+	{
+		printf("FAIL: %s: %s\n", test, message);
+		tests_failed++;
+	}
+}
+
+// Output pins of the ESC and the servo (M0PWMn)
+#define MODEL_ESC_PIN   0
+#if PWM_SERVO_GENERATOR == 0
+#define MODEL_SERVO_PIN 1
+#elif PWM_SERVO_GENERATOR == 1
+#define MODEL_SERVO_PIN 2
+#else
+#define MODEL_SERVO_PIN 4
+#endif
+
+#define MODEL_ESC_PERIOD_CYCLES   ((uint64_t)(PWM_LOAD_VALUE + 1) * PWM_CLOCK_DIVIDER)
+#define MODEL_SERVO_PERIOD_CYCLES ((uint64_t)(SERVO_LOAD_VAL + 1) * PWM_CLOCK_DIVIDER)
+
+// The first pulses after PWM_Init: neutral throttle and centered steering, at the set periods
+static void Test_Init_Pulses(void)
+{
+	const char *test = "init";
+	Model_Pulse pulses[4];
+
+	Model_Init();
+	Model_Run_us(4 * PWM_PERIOD_US);
+
+	uint32_t count = Model_Pulses_Since(MODEL_ESC_PIN, 0, pulses, 4);
+
+	Check(count >= 3, test, "no ESC pulses");
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Check(pulses[i].width == (PWM_LOAD_VALUE - ESC_NEUTRAL_VAL), test, "ESC pulse is not neutral");
+		Check((i == 0) || ((pulses[i].start - pulses[i - 1].start) == MODEL_ESC_PERIOD_CYCLES), test, "ESC period");
+	}
+
+	Model_Run_us(4 * SERVO_PERIOD_US);
+	count = Model_Pulses_Since(MODEL_SERVO_PIN, 0, pulses, 4);
+
+	Check(count >= 3, test, "no servo pulses");
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Check(pulses[i].width == (SERVO_LOAD_VAL - SERVO_CENTER_VAL), test, "servo pulse is not centered");
+		Check((i == 0) || ((pulses[i].start - pulses[i - 1].start) == MODEL_SERVO_PERIOD_CYCLES), test, "servo period");
+	}
+
+	printf("init: ESC %u ticks (%.1f us) every %.1f us, servo %u ticks every %.1f us\n",
+		(uint32_t)(PWM_LOAD_VALUE - ESC_NEUTRAL_VAL), (double)(PWM_LOAD_VALUE - ESC_NEUTRAL_VAL) * 1e6 / PWM_CLOCK_HZ,
+		(double)MODEL_ESC_PERIOD_CYCLES * 1e6 / SYSTEM_CLOCK_HZ, (uint32_t)(SERVO_LOAD_VAL - SERVO_CENTER_VAL),
+		(double)MODEL_SERVO_PERIOD_CYCLES * 1e6 / SYSTEM_CLOCK_HZ);
+}
+
+// Checks that a channel switches from old_width to new_width at its first period after the write
+// (write_time is when the write returned; a phase reset may start the new pulse before that).
+// Returns the start of the first new pulse
+static uint64_t Check_Switch(const char *test, uint32_t pin, uint32_t first, uint64_t write_time,
+	uint64_t period_cycles, uint32_t old_width, uint32_t new_width)
+{
+	Model_Pulse pulses[MODEL_PULSE_LOG];
+	uint32_t count = Model_Pulses_Since(pin, first, pulses, MODEL_PULSE_LOG);
+	uint64_t first_new = 0;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (pulses[i].width == new_width)
+		{
+			if (first_new == 0)
+			{
+				first_new = pulses[i].start;
+			}
+		}
+		else
+		{
+			Check((pulses[i].width == old_width) && (first_new == 0), test, "a pulse has neither the old nor the new width");
+		}
+	}
+
+	Check(first_new != 0, test, "the new width never reached the output");
+	// The write takes a few accesses: if the counter reaches zero before GLOBALSYNCn is set,
+	// the values are held for one more period
+	Check((first_new <= write_time) || ((first_new - write_time) <= (period_cycles + (2 * PWM_CLOCK_DIVIDER))), test, "the new width started later than the next period");
+
+	return first_new;
+}
+
+// PWM_Set_Outputs at every phase of the period: both channels switch once, without glitches,
+// and in the same period when they share generator 0
+static void Test_Update_Order(void)
+{
+	const char *test = "update order";
+	uint32_t esc_value = ESC_NEUTRAL_VAL;
+	uint32_t servo_value = SERVO_CENTER_VAL;
+	uint32_t same_period = 0;
+	uint32_t writes = 0;
+
+	Model_Init();
+	Model_Run_us(2 * PWM_PERIOD_US);
+
+	while (writes < 1000)
+	{
+		uint32_t new_esc = ESC_PULSE_US_TO_CMP(1000 + Random_Below(1001));
+		uint32_t new_servo = SERVO_PULSE_US_TO_CMP(1000 + Random_Below(1001));
+
+		// Stop at a random point of the period, often within a few ticks of zero
+		if (Random_Below(2) == 0)
+		{
+			Model_Run_us(Random_Below(PWM_PERIOD_US));
+		}
+		else
+		{
+			while (model_generators[0].count > Random_Below(4))
+			{
+				Model_Advance(PWM_CLOCK_DIVIDER);
+			}
+			Model_Advance(Random_Below(PWM_CLOCK_DIVIDER));
+		}
+
+		if ((new_esc == esc_value) || (new_servo == servo_value))
+		{
+			continue;
+		}
+
+		uint32_t esc_first = model_pulse_count[MODEL_ESC_PIN];
+		uint32_t servo_first = model_pulse_count[MODEL_SERVO_PIN];
+
+		// A pulse in progress is part of the log once it ends
+		if (model_pin[MODEL_ESC_PIN])
+		{
+			esc_first = model_pulse_count[MODEL_ESC_PIN];
+		}
+
+		PWM_Set_Outputs(new_esc, new_servo);
+		uint64_t write_time = model_cycles;
+		writes++;
+
+		Model_Run_us(3 * ((PWM_PERIOD_US > SERVO_PERIOD_US) ? PWM_PERIOD_US : SERVO_PERIOD_US));
+
+		uint64_t esc_start = Check_Switch(test, MODEL_ESC_PIN, esc_first, write_time, MODEL_ESC_PERIOD_CYCLES,
+			PWM_LOAD_VALUE - esc_value, PWM_LOAD_VALUE - new_esc);
+		uint64_t servo_start = Check_Switch(test, MODEL_SERVO_PIN, servo_first, write_time, MODEL_SERVO_PERIOD_CYCLES,
+			SERVO_LOAD_VAL - servo_value, SERVO_LOAD_VAL - new_servo);
+
+#if PWM_SERVO_GENERATOR == 0
+		Check(esc_start == servo_start, test, "the ESC and the servo changed in different periods");
+#endif
+		same_period += (esc_start == servo_start);
+
+		Check(!PWM_Update_Pending(), test, "PWM_Update_Pending after the update");
+
+		esc_value = new_esc;
+		servo_value = new_servo;
+	}
+
+	printf("update order: %u writes at random phases, both channels in the same period in %u\n", writes, same_period);
+}
+
+// ESC_Set_Throttle from neutral to full forward, written every ESC_FRAME_US like the control
+// task does: one step per pulse at the accelerate rate
+static void Test_Slew(void)
+{
+	const char *test = "slew";
+	Model_Pulse pulses[MODEL_PULSE_LOG];
+
+	Model_Init();
+	Model_Run_us(2 * PWM_PERIOD_US);
+
+	uint32_t first = model_pulse_count[MODEL_ESC_PIN];
+	uint32_t step = (uint32_t)((((uint64_t)ESC_ACCELERATE_US_PER_S * ESC_FRAME_US * PWM_TICKS_PER_US_Q16) /
+		(1000000ULL * ESC_PULSE_DIVIDER) + 0x8000) >> 16);
+	uint32_t full = PWM_LOAD_VALUE - ESC_FULL_FORWARD_VAL;
+	uint32_t previous = PWM_LOAD_VALUE - ESC_NEUTRAL_VAL;
+	uint32_t periods = 0;
+
+	while (previous != full)
+	{
+		ESC_Set_Throttle(SETPOINT_FULL_SCALE);
+		Model_Run_us(ESC_FRAME_US);
+
+		uint32_t count = Model_Pulses_Since(MODEL_ESC_PIN, first, pulses, MODEL_PULSE_LOG);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t width = pulses[i].width;
+
+			Check((width >= previous) && ((width - previous) <= step), test, "the throttle moved by more than one step");
+			Check(width <= full, test, "the throttle overshot");
+			previous = width;
+			periods++;
+		}
+
+		first += count;
+
+		if (periods > 1000)
+		{
+			Check(0, test, "full throttle never reached");
+			break;
+		}
+	}
+
+	uint32_t expected = ((full - (PWM_LOAD_VALUE - ESC_NEUTRAL_VAL)) + step - 1) / step;
+
+	Check(periods >= expected, test, "full throttle reached too early");
+	printf("slew: neutral to full forward in %u pulses (%.0f ms), %u ticks per pulse\n",
+		periods, (double)periods * ESC_FRAME_US / 1000.0, step);
+}
+
+static int Compare_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+// Microseconds at a given fraction of sorted latencies (in system clock cycles)
+static double Percentile_us(const uint64_t *sorted, uint32_t count, double fraction)
+{
+	return (double)sorted[(uint32_t)(fraction * (count - 1))] * 1e6 / SYSTEM_CLOCK_HZ;
+}
+
+// Write time and counter values a phase reset needs, in PWM clock ticks: the counter moves
+// by up to this many ticks between the start of PWM_Set_Setpoint and its PWMSYNC write
+#define MODEL_WRITE_TICKS ((64 * MODEL_ACCESS_CYCLES) / PWM_CLOCK_DIVIDER + 1)
+
+// PWM_Set_Setpoint with the slew limiter off, every ESC_FRAME_US (with some jitter) or at random
+// times: time from the call to the start of the first pulse with the new values
+static void Test_Phase_Latency(void)
+{
+	const char *test = "phase latency";
+	static uint64_t esc_latency[500];
+	static uint64_t servo_latency[500];
+	uint32_t esc_value = ESC_NEUTRAL_VAL;
+	uint32_t servo_value = SERVO_CENTER_VAL;
+	uint32_t writes = 0;
+	uint32_t resettable = 0;
+	uint64_t resettable_max = 0;
+
+	Model_Init();
+	ESC_Set_Slew_Rate(0, 0);
+	Model_Run_us(2 * PWM_PERIOD_US);
+
+	while (writes < (sizeof(esc_latency) / sizeof(esc_latency[0])))
+	{
+		int16_t throttle = (int16_t)Random_Below(2 * SETPOINT_FULL_SCALE + 1) - SETPOINT_FULL_SCALE;
+		int16_t steering = (int16_t)Random_Below(2 * SETPOINT_FULL_SCALE + 1) - SETPOINT_FULL_SCALE;
+		uint32_t new_esc = ESC_NEUTRAL_VAL - (uint32_t)(((int32_t)throttle * (int32_t)(ESC_NEUTRAL_VAL - ESC_FULL_FORWARD_VAL)) / SETPOINT_FULL_SCALE);
+		uint32_t new_servo = Steering_Map(steering);
+
+		if (throttle < 0)
+		{
+			new_esc = ESC_NEUTRAL_VAL + (uint32_t)(((int32_t)-throttle * (int32_t)(ESC_FULL_REVERSE_VAL - ESC_NEUTRAL_VAL)) / SETPOINT_FULL_SCALE);
+		}
+
+		// Like the control task, or at any phase
+		if (Random_Below(2) == 0)
+		{
+			Model_Run_us(ESC_FRAME_US - (ESC_FRAME_US / 10) + Random_Below(ESC_FRAME_US / 5));
+		}
+		else
+		{
+			Model_Run_us(Random_Below(3 * PWM_PERIOD_US));
+		}
+
+		if ((new_esc == esc_value) || (new_servo == servo_value))
+		{
+			continue;
+		}
+
+		uint32_t esc_first = model_pulse_count[MODEL_ESC_PIN];
+		uint32_t servo_first = model_pulse_count[MODEL_SERVO_PIN];
+		uint32_t count = model_generators[0].count;
+
+		uint64_t call_time = model_cycles;
+		PWM_Set_Setpoint(throttle, steering);
+		uint64_t write_time = model_cycles;
+
+		Model_Run_us(3 * ((PWM_PERIOD_US > SERVO_PERIOD_US) ? PWM_PERIOD_US : SERVO_PERIOD_US));
+
+		uint64_t esc_start = Check_Switch(test, MODEL_ESC_PIN, esc_first, write_time, MODEL_ESC_PERIOD_CYCLES,
+			PWM_LOAD_VALUE - esc_value, PWM_LOAD_VALUE - new_esc);
+		uint64_t servo_start = Check_Switch(test, MODEL_SERVO_PIN, servo_first, write_time, MODEL_SERVO_PERIOD_CYCLES,
+			SERVO_LOAD_VAL - servo_value, SERVO_LOAD_VAL - new_servo);
+
+		esc_latency[writes] = esc_start - call_time;
+		servo_latency[writes] = servo_start - call_time;
+		writes++;
+
+#if PWM0_PHASE_RESET
+		// Far enough from both limits that the counter is still inside them at the PWMSYNC write
+		if ((count <= PWM0_PHASE_RESET_COUNT) && (count >= (PWM_PHASE_RESET_GUARD_TICKS + MODEL_WRITE_TICKS)))
+		{
+			Check(esc_start <= (write_time + (2 * PWM_CLOCK_DIVIDER)), test, "a write after the minimum frame did not restart the period");
+			resettable++;
+
+			if ((esc_start - call_time) > resettable_max)
+			{
+				resettable_max = esc_start - call_time;
+			}
+		}
+#else
+		(void)count;
+#endif
+
+		esc_value = new_esc;
+		servo_value = new_servo;
+	}
+
+	Check(model_pin_min_period[MODEL_ESC_PIN] >= (PWM_US_TO_TICKS(PWM0_MIN_FRAME_US) * PWM_CLOCK_DIVIDER), test, "two ESC pulses started closer than the minimum frame");
+	Check(model_pin_min_period[MODEL_SERVO_PIN] >= (PWM_US_TO_TICKS(SERVO_MIN_FRAME_US) * PWM_CLOCK_DIVIDER), test, "two servo pulses started closer than the minimum frame");
+
+	qsort(esc_latency, writes, sizeof(esc_latency[0]), Compare_u64);
+	qsort(servo_latency, writes, sizeof(servo_latency[0]), Compare_u64);
+
+	printf("phase latency: %u writes, ESC p50 %.1f us, p90 %.1f us, max %.1f us; servo p50 %.1f us, max %.1f us\n",
+		writes, Percentile_us(esc_latency, writes, 0.5), Percentile_us(esc_latency, writes, 0.9),
+		Percentile_us(esc_latency, writes, 1.0), Percentile_us(servo_latency, writes, 0.5), Percentile_us(servo_latency, writes, 1.0));
+	printf("phase latency: %u writes after the minimum frame (ESC max %.1f us), shortest pulse spacing ESC %.1f us, servo %.1f us\n",
+		resettable, (double)resettable_max * 1e6 / SYSTEM_CLOCK_HZ, (double)model_pin_min_period[MODEL_ESC_PIN] * 1e6 / SYSTEM_CLOCK_HZ,
+		(double)model_pin_min_period[MODEL_SERVO_PIN] * 1e6 / SYSTEM_CLOCK_HZ);
+}
+
+// ESC_Set_Pulse_us over and beyond the pulse range of the signal mode
+static void Test_Pulse_Clamp(void)
+{
+	const char *test = "pulse clamp";
+	static const uint32_t requests[] = {0, 500, 999, 1000, 1001, 1500, 1999, 2000, 2001, 2500, 20000, 0xFFFFFFFF};
+	Model_Pulse pulses[MODEL_PULSE_LOG];
+	double shortest = 1e9;
+	double longest = 0;
+
+	Model_Init();
+	Model_Run_us(2 * PWM_PERIOD_US);
+
+	for (uint32_t i = 0; i < (sizeof(requests) / sizeof(requests[0])); i++)
+	{
+		uint32_t request = requests[i];
+
+		ESC_Set_Pulse_us(request);
+		Model_Run_us(2 * PWM_PERIOD_US);
+
+		uint32_t first = model_pulse_count[MODEL_ESC_PIN];
+		Model_Run_us(2 * PWM_PERIOD_US);
+		uint32_t count = Model_Pulses_Since(MODEL_ESC_PIN, first, pulses, MODEL_PULSE_LOG);
+
+		// Width the ESC should see, in microseconds of the signal
+		double expected = (double)request / ESC_PULSE_DIVIDER;
+		if (expected < ESC_MIN_PULSE_US) expected = ESC_MIN_PULSE_US;
+		if (expected > ESC_MAX_PULSE_US) expected = ESC_MAX_PULSE_US;
+
+		Check(count >= 1, test, "no ESC pulses");
+		for (uint32_t j = 0; j < count; j++)
+		{
+			double width = (double)pulses[j].width * 1e6 / PWM_CLOCK_HZ;
+
+			// The conversion rounds down to a PWM clock tick
+			Check((width <= expected) && ((expected - width) <= (1e6 / PWM_CLOCK_HZ)), test, "the pulse is not the requested width");
+			Check((width > (ESC_MIN_PULSE_US - (1e6 / PWM_CLOCK_HZ))) && (width <= ESC_MAX_PULSE_US), test, "the pulse is outside the ESC range");
+
+			if (width < shortest) shortest = width;
+			if (width > longest) longest = width;
+		}
+	}
+
+	printf("pulse clamp: ESC pulses from %.2f to %.2f us every %u us\n", shortest, longest, PWM_PERIOD_US);
+}
+
+int main(void)
+{
+	srand(1);
+
+	printf("ESC_SIGNAL_MODE %d, PWM_SERVO_GENERATOR %d, PWM_PHASE_RESET_ENABLE %d\n",
+		ESC_SIGNAL_MODE, PWM_SERVO_GENERATOR, PWM_PHASE_RESET_ENABLE);
+
+	Test_Init_Pulses();
+	Test_Update_Order();
+	Test_Slew();
+	Test_Phase_Latency();
+	Test_Pulse_Clamp();
+
+	if (tests_failed != 0)
+	{
+		printf("%u checks failed\n", tests_failed);
+		return 1;
+	}
+
+	printf("all checks passed\n");
+
+	return 0;
+}
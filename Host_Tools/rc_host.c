@@ -0,0 +1,1095 @@
+/**
+ * @file rc_host.c
+ *
+ * @brief Host-side tool for the Bluetooth RC car.
+ *
+ * This program runs on a PC (Linux or macOS) that is paired with the HC-06 module
+ * and talks to the car through the serial port of the Bluetooth link (e.g. /dev/rfcomm0).
+ * It uses the same Protocol library as the firmware to build and check frames.
+ *
+ * Build:
+ *   gcc -O2 -I../Keil_Project -o rc_host rc_host.c ../Keil_Project/Protocol.c
+ *
+ * Usage:
+ *   rc_host <device> <baud_rate> drive <throttle> <steering> [rate_hz] [count]
+ *
+ *   rc_host <device> <baud_rate> telemetry [seconds]
+ *   rc_host <device> <baud_rate> ping [count] [rate_hz]
+ *   rc_host <device> <baud_rate> histogram <id> [reset]
+ *   rc_host <device> <baud_rate> breakdown [reset]
+ *   rc_host <device> <baud_rate> profile [reset]
+ *   rc_host <device> <baud_rate> trace <output.json> [restart]
+ *   rc_host <device> <baud_rate> steering <expo_percent> [left_us center_us right_us]
+ *   rc_host <device> <baud_rate> stop [clear]
+ *
+ *   drive      Sends setpoint frames. Throttle and steering range from -1000 to +1000.
+ *              By default, one frame is sent every 20 ms (50 Hz) until interrupted.
+ *
+ *   telemetry  Prints the decoded telemetry samples and counts the acknowledgements
+ *              received from the car, until interrupted or for the given number of seconds.
+ *
+ *   ping       Sends pings (100 by default, at 20 Hz) and prints the p50/p99/max round-trip
+ *              time and the estimated offset between the car clock and the host clock.
+ *              Each ping reports the round-trip time of the previous one to the car.
+ *
+ *   histogram  Reads a latency histogram kept by the car and prints its p50/p99/max.
+ *              IDs: 0 = round trip, 1 = ping turnaround, 2 = command to PWM,
+ *              3 = RX to decode, 4 = decode to publish, 5 = compare write to PWM LOAD,
+ *              6 = RX to PWM LOAD. With "reset", the histogram is cleared after it is read.
+ *
+ *   breakdown  Prints the latency of each stage of a setpoint command, from the bytes seen
+ *              by the car to the PWM edge that applies it (histograms 3, 4, 2, 5, and 6).
+ *
+ *   profile    Dumps the DWT cycle counts of the profiled regions (see Profile_Regions.h).
+ *              With "reset", the table is cleared after it is read.
+ *
+ *   trace      Dumps the event trace buffer of the car (see Event_Trace_Events.h) to a JSON
+ *              file in the Trace Event Format, which can be opened with chrome://tracing or
+ *              https://ui.perfetto.dev. Interrupt handlers and tasks appear as slices on their
+ *              own tracks, received frames as instant events, and PWM compare values as counters.
+ *              Reading the buffer stops the recording on the car; with "restart", the buffer is
+ *              cleared and the recording resumes after the dump.
+ *
+ *   steering   Uploads a steering curve: y = (1 - e) * x + e * x^3 with e = expo / 100,
+ *              scaled onto the pulse widths of full left, center, and full right
+ *              (1000, 1500, and 2000 us by default). The car clamps every point to the
+ *              mechanical limits of the servo and switches to the new curve at once.
+ *
+ *   stop       Emergency stop: the car drives the ESC and servo outputs low until the stop is
+ *              released with "clear". The outputs come back one second after the release,
+ *              once the fault input on the car is released too, and the ESC arms again.
+ *
+ * @author
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Protocol.h"
+#include "Profile_Regions.h"
+#include "Event_Trace_Events.h"
+
+static uint8_t tx_sequence = 0;
+
+static speed_t Baud_Rate_To_Speed(long baud_rate)
+{
+	switch (baud_rate)
+	{
+		case 9600:   return B9600;
+		case 19200:  return B19200;
+		case 38400:  return B38400;
+		case 57600:  return B57600;
+		case 115200: return B115200;
+		case 230400: return B230400;
+		default:     return 0;
+	}
+}
+
+static int Serial_Open(const char *device, long baud_rate)
+{
+	speed_t speed = Baud_Rate_To_Speed(baud_rate);
+	if (speed == 0)
+	{
+		fprintf(stderr, "Unsupported baud rate: %ld\n", baud_rate);
+		return -1;
+	}
+
+	int fd = open(device, O_RDWR | O_NOCTTY);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Cannot open %s: %s\n", device, strerror(errno));
+		return -1;
+	}
+
+	struct termios tty;
+	if (tcgetattr(fd, &tty) != 0)
+	{
+		fprintf(stderr, "tcgetattr failed: %s\n", strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	// Raw 8-N-1, reads return after 100 ms without data
+	cfmakeraw(&tty);
+	cfsetispeed(&tty, speed);
+	cfsetospeed(&tty, speed);
+	tty.c_cflag |= CLOCAL | CREAD;
+	tty.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+	tty.c_cc[VMIN] = 0;
+	tty.c_cc[VTIME] = 1;
+
+	if (tcsetattr(fd, TCSANOW, &tty) != 0)
+	{
+		fprintf(stderr, "tcsetattr failed: %s\n", strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static int Send_Frame(int fd, uint8_t type, const uint8_t *payload, uint32_t payload_length)
+{
+	uint8_t encoded[PROTOCOL_MAX_ENCODED_SIZE];
+	uint32_t length = Protocol_Encode_Frame(type, tx_sequence, payload, payload_length, encoded);
+
+	tx_sequence = tx_sequence + 1;
+
+	return (write(fd, encoded, length) == (ssize_t)length) ? 0 : -1;
+}
+
+static double Now_s(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static void Sleep_us(long microseconds)
+{
+	struct timespec delay;
+	delay.tv_sec = microseconds / 1000000;
+	delay.tv_nsec = (microseconds % 1000000) * 1000;
+	nanosleep(&delay, NULL);
+}
+
+static const char *telemetry_field_names[PROTOCOL_TELEMETRY_FIELD_COUNT] =
+{
+	"esc_cmp", "servo_cmp", "adc_mv", "ctl_exec_us", "ctl_jitter_us",
+	"frames", "frame_errors", "sp_dropped", "rx_overruns", "esc_state",
+	"battery_mv"
+};
+
+// Decodes and prints a telemetry batch; returns 0 if the payload is malformed
+static int Print_Telemetry(const Protocol_Frame *frame)
+{
+	const uint8_t *data = frame->payload;
+	uint32_t length = frame->payload_length;
+	uint32_t offset = 1;
+	uint32_t time_ms;
+	int32_t values[PROTOCOL_TELEMETRY_FIELD_COUNT] = {0};
+
+	if (length < 1)
+	{
+		return 0;
+	}
+
+	uint32_t used = Protocol_Get_Varint(&data[offset], length - offset, &time_ms);
+	if (used == 0)
+	{
+		return 0;
+	}
+	offset += used;
+
+	for (uint32_t sample = 0; sample < data[0]; sample++)
+	{
+		if (sample != 0)
+		{
+			uint32_t delta_ms;
+			used = Protocol_Get_Varint(&data[offset], length - offset, &delta_ms);
+			if (used == 0)
+			{
+				return 0;
+			}
+			offset += used;
+			time_ms += delta_ms;
+		}
+
+		printf("%10u ms", time_ms);
+
+		for (uint32_t i = 0; i < PROTOCOL_TELEMETRY_FIELD_COUNT; i++)
+		{
+			uint32_t zigzag;
+			used = Protocol_Get_Varint(&data[offset], length - offset, &zigzag);
+			if (used == 0)
+			{
+				return 0;
+			}
+			offset += used;
+			values[i] += Protocol_Zigzag_Decode(zigzag);
+
+			printf("  %s=%d", telemetry_field_names[i], values[i]);
+		}
+
+		printf("\n");
+	}
+
+	return 1;
+}
+
+static int Command_Telemetry(int fd, int argc, char **argv)
+{
+	double duration = (argc > 0) ? atof(argv[0]) : -1.0;
+	double start = Now_s();
+	Protocol_Parser parser;
+	uint8_t buffer[256];
+	unsigned long acks = 0;
+	unsigned long errors = 0;
+
+	Protocol_Parser_Reset(&parser);
+
+	while ((duration < 0) || ((Now_s() - start) < duration))
+	{
+		ssize_t count = read(fd, buffer, sizeof(buffer));
+		if (count < 0)
+		{
+			fprintf(stderr, "read failed: %s\n", strerror(errno));
+			return 1;
+		}
+
+		for (ssize_t i = 0; i < count; i++)
+		{
+			uint8_t status = Protocol_Parse_Byte(&parser, buffer[i]);
+
+			if (status == PROTOCOL_IN_PROGRESS)
+			{
+				continue;
+			}
+
+			if (status != PROTOCOL_OK)
+			{
+				errors++;
+			}
+			else if (parser.frame.type == PROTOCOL_MSG_ACK)
+			{
+				acks++;
+			}
+			else if ((parser.frame.type == PROTOCOL_MSG_TELEMETRY) && !Print_Telemetry(&parser.frame))
+			{
+				errors++;
+			}
+		}
+	}
+
+	printf("acks=%lu frame_errors=%lu\n", acks, errors);
+
+	return 0;
+}
+
+static uint32_t Now_us(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint32_t)(((uint64_t)now.tv_sec * 1000000) + (now.tv_nsec / 1000));
+}
+
+// Waits for a valid frame of the given type; returns 1 if one arrived before the timeout
+static int Receive_Frame(int fd, Protocol_Parser *parser, uint8_t type, double timeout_s, Protocol_Frame *frame)
+{
+	double start = Now_s();
+	uint8_t data;
+
+	while ((Now_s() - start) < timeout_s)
+	{
+		ssize_t count = read(fd, &data, 1);
+		if (count < 0)
+		{
+			fprintf(stderr, "read failed: %s\n", strerror(errno));
+			return 0;
+		}
+
+		if ((count == 1) && (Protocol_Parse_Byte(parser, data) == PROTOCOL_OK) && (parser->frame.type == type))
+		{
+			*frame = parser->frame;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int Compare_U32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static int Command_Ping(int fd, int argc, char **argv)
+{
+	long count = (argc > 0) ? atol(argv[0]) : 100;
+	long rate_hz = (argc > 1) ? atol(argv[1]) : 20;
+	Protocol_Parser parser;
+	uint32_t previous_rtt_us = 0;
+	long received = 0;
+
+	// Offset estimate from the ping with the smallest round-trip time, which has the least queuing delay
+	uint32_t best_rtt_us = UINT32_MAX;
+	int64_t best_offset_us = 0;
+
+	if ((count <= 0) || (rate_hz <= 0))
+	{
+		fprintf(stderr, "ping needs a positive count and rate\n");
+		return 1;
+	}
+
+	uint32_t *rtt_us = malloc(count * sizeof(uint32_t));
+	if (rtt_us == NULL)
+	{
+		return 1;
+	}
+
+	Protocol_Parser_Reset(&parser);
+
+	for (long i = 0; i < count; i++)
+	{
+		uint8_t payload[PROTOCOL_PING_PAYLOAD_SIZE];
+		Protocol_Frame pong;
+
+		uint32_t t1 = Now_us();
+		Protocol_Put_U32(t1, &payload[0]);
+		Protocol_Put_U32(previous_rtt_us, &payload[4]);
+		previous_rtt_us = 0;
+
+		if (Send_Frame(fd, PROTOCOL_MSG_PING, payload, PROTOCOL_PING_PAYLOAD_SIZE) != 0)
+		{
+			fprintf(stderr, "write failed: %s\n", strerror(errno));
+			break;
+		}
+
+		// Ignore late pongs of earlier pings
+		while (Receive_Frame(fd, &parser, PROTOCOL_MSG_PONG, 1.0, &pong))
+		{
+			if ((pong.payload_length == PROTOCOL_PONG_PAYLOAD_SIZE) && (Protocol_Get_U32(&pong.payload[0]) == t1))
+			{
+				uint32_t t4 = Now_us();
+				uint32_t t2 = Protocol_Get_U32(&pong.payload[4]);
+				uint32_t t3 = Protocol_Get_U32(&pong.payload[8]);
+
+				uint32_t rtt = t4 - t1;
+				rtt_us[received] = rtt;
+				received++;
+				previous_rtt_us = rtt;
+
+				if (rtt < best_rtt_us)
+				{
+					// offset = car clock - host clock, assuming symmetric link delays
+					best_rtt_us = rtt;
+					best_offset_us = ((int64_t)(int32_t)(t2 - t1) + (int64_t)(int32_t)(t3 - t4)) / 2;
+				}
+				break;
+			}
+		}
+
+		Sleep_us(1000000 / rate_hz);
+	}
+
+	printf("sent=%ld received=%ld\n", count, received);
+
+	if (received > 0)
+	{
+		qsort(rtt_us, received, sizeof(uint32_t), Compare_U32);
+
+		printf("rtt p50=%.2f ms p99=%.2f ms max=%.2f ms\n",
+			rtt_us[(received - 1) / 2] / 1000.0,
+			rtt_us[((received * 99) + 99) / 100 - 1] / 1000.0,
+			rtt_us[received - 1] / 1000.0);
+		printf("clock offset (car - host, mod 2^32 us) = %" PRId64 " us +/- %.2f ms\n",
+			best_offset_us, best_rtt_us / 2000.0);
+	}
+
+	free(rtt_us);
+
+	return (received > 0) ? 0 : 1;
+}
+
+typedef struct
+{
+	uint32_t buckets[PROTOCOL_HISTOGRAM_BUCKETS];
+	uint32_t total;
+	uint32_t max_us;
+} Histogram;
+
+// Reads a latency histogram from the car in several parts; returns 0 on success
+static int Fetch_Histogram(int fd, Protocol_Parser *parser, uint8_t histogram_id, int reset, Histogram *histogram)
+{
+	uint32_t next_bucket = 0;
+
+	memset(histogram, 0, sizeof(*histogram));
+
+	while (next_bucket < PROTOCOL_HISTOGRAM_BUCKETS)
+	{
+		uint8_t request[PROTOCOL_HISTOGRAM_REQUEST_PAYLOAD_SIZE] = {histogram_id, (uint8_t)next_bucket, 0};
+		Protocol_Frame reply;
+
+		if (Send_Frame(fd, PROTOCOL_MSG_HISTOGRAM_REQUEST, request, sizeof(request)) != 0)
+		{
+			fprintf(stderr, "write failed: %s\n", strerror(errno));
+			return 1;
+		}
+
+		if (!Receive_Frame(fd, parser, PROTOCOL_MSG_HISTOGRAM, 1.0, &reply) || (reply.payload_length < 3) ||
+		    (reply.payload[0] != histogram_id) || (reply.payload[1] != next_bucket) || (reply.payload[2] == 0))
+		{
+			fprintf(stderr, "no valid reply for histogram %u\n", histogram_id);
+			return 1;
+		}
+
+		uint32_t offset = 3;
+		uint32_t used = Protocol_Get_Varint(&reply.payload[offset], reply.payload_length - offset, &histogram->total);
+		offset += used;
+		used = (used == 0) ? 0 : Protocol_Get_Varint(&reply.payload[offset], reply.payload_length - offset, &histogram->max_us);
+		offset += used;
+
+		for (uint32_t i = 0; (used != 0) && (i < reply.payload[2]); i++)
+		{
+			used = Protocol_Get_Varint(&reply.payload[offset], reply.payload_length - offset, &histogram->buckets[next_bucket + i]);
+			offset += used;
+		}
+
+		if (used == 0)
+		{
+			fprintf(stderr, "malformed histogram reply\n");
+			return 1;
+		}
+
+		next_bucket += reply.payload[2];
+	}
+
+	// Only clear the histogram once every part has been read
+	if (reset)
+	{
+		uint8_t request[PROTOCOL_HISTOGRAM_REQUEST_PAYLOAD_SIZE] = {histogram_id, PROTOCOL_HISTOGRAM_BUCKETS - 1, PROTOCOL_HISTOGRAM_FLAG_RESET};
+		Protocol_Frame reply;
+
+		Send_Frame(fd, PROTOCOL_MSG_HISTOGRAM_REQUEST, request, sizeof(request));
+		Receive_Frame(fd, parser, PROTOCOL_MSG_HISTOGRAM, 1.0, &reply);
+	}
+
+	return 0;
+}
+
+// Returns the upper limit of the bucket that contains the given percentile, in microseconds
+static uint32_t Histogram_Percentile(const Histogram *histogram, uint32_t percentile)
+{
+	uint64_t rank = (((uint64_t)histogram->total * percentile) + 99) / 100;
+	uint64_t cumulative = 0;
+	uint32_t bucket = 0;
+
+	while ((bucket < (PROTOCOL_HISTOGRAM_BUCKETS - 1)) && ((cumulative + histogram->buckets[bucket]) < rank))
+	{
+		cumulative += histogram->buckets[bucket];
+		bucket++;
+	}
+
+	uint32_t limit = Protocol_Histogram_Bucket_Limit(bucket);
+
+	return (limit < histogram->max_us) ? limit : histogram->max_us;
+}
+
+static void Print_Histogram(const char *name, const Histogram *histogram)
+{
+	if (histogram->total == 0)
+	{
+		printf("%-18s count=0\n", name);
+		return;
+	}
+
+	printf("%-18s count=%-8u p50<=%9.3f ms  p99<=%9.3f ms  max=%9.3f ms\n", name, histogram->total,
+		Histogram_Percentile(histogram, 50) / 1000.0,
+		Histogram_Percentile(histogram, 99) / 1000.0,
+		histogram->max_us / 1000.0);
+}
+
+static const char *histogram_names[PROTOCOL_HISTOGRAM_COUNT] =
+{
+	"round_trip", "ping_turnaround", "command_to_pwm",
+	"rx_to_decode", "decode_to_publish", "cmp_to_load", "rx_to_load"
+};
+
+static int Command_Histogram(int fd, int argc, char **argv)
+{
+	if (argc < 1)
+	{
+		fprintf(stderr, "histogram needs <id>\n");
+		return 1;
+	}
+
+	uint8_t histogram_id = (uint8_t)atoi(argv[0]);
+	int reset = (argc > 1) && (strcmp(argv[1], "reset") == 0);
+	Protocol_Parser parser;
+	Histogram histogram;
+
+	if (histogram_id >= PROTOCOL_HISTOGRAM_COUNT)
+	{
+		fprintf(stderr, "unknown histogram %u\n", histogram_id);
+		return 1;
+	}
+
+	Protocol_Parser_Reset(&parser);
+
+	if (Fetch_Histogram(fd, &parser, histogram_id, reset, &histogram) != 0)
+	{
+		return 1;
+	}
+
+	Print_Histogram(histogram_names[histogram_id], &histogram);
+
+	return 0;
+}
+
+// Prints the stages of a setpoint command in the order it goes through them
+static int Command_Breakdown(int fd, int argc, char **argv)
+{
+	static const uint8_t stages[] =
+	{
+		PROTOCOL_HISTOGRAM_RX_TO_DECODE,
+		PROTOCOL_HISTOGRAM_DECODE_TO_PUBLISH,
+		PROTOCOL_HISTOGRAM_COMMAND_TO_PWM,
+		PROTOCOL_HISTOGRAM_CMP_TO_LOAD,
+		PROTOCOL_HISTOGRAM_RX_TO_LOAD
+	};
+	int reset = (argc > 0) && (strcmp(argv[0], "reset") == 0);
+	Protocol_Parser parser;
+
+	Protocol_Parser_Reset(&parser);
+
+	for (uint32_t i = 0; i < sizeof(stages); i++)
+	{
+		Histogram histogram;
+
+		if (Fetch_Histogram(fd, &parser, stages[i], reset, &histogram) != 0)
+		{
+			return 1;
+		}
+
+		Print_Histogram(histogram_names[stages[i]], &histogram);
+	}
+
+	return 0;
+}
+
+static int Command_Drive(int fd, int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "drive needs <throttle> <steering>\n");
+		return 1;
+	}
+
+	Protocol_Setpoint setpoint;
+	setpoint.throttle = (int16_t)atoi(argv[0]);
+	setpoint.steering = (int16_t)atoi(argv[1]);
+
+	long rate_hz = (argc > 2) ? atol(argv[2]) : 50;
+	long count = (argc > 3) ? atol(argv[3]) : -1;
+
+	if (rate_hz <= 0)
+	{
+		rate_hz = 50;
+	}
+
+	uint8_t payload[PROTOCOL_MAX_PAYLOAD_SIZE];
+	uint32_t payload_length = Protocol_Pack_Setpoint(&setpoint, payload);
+
+	for (long sent = 0; (count < 0) || (sent < count); sent++)
+	{
+		if (Send_Frame(fd, PROTOCOL_MSG_SETPOINT, payload, payload_length) != 0)
+		{
+			fprintf(stderr, "write failed: %s\n", strerror(errno));
+			return 1;
+		}
+
+		Sleep_us(1000000 / rate_hz);
+	}
+
+	return 0;
+}
+
+#define PROFILE_REGION_NAME(id, name) name,
+
+static const char *profile_region_names[PROFILE_REGION_COUNT] =
+{
+	PROFILE_REGION_LIST(PROFILE_REGION_NAME)
+};
+
+static int Command_Profile(int fd, int argc, char **argv)
+{
+	uint8_t flags = ((argc > 0) && (strcmp(argv[0], "reset") == 0)) ? PROTOCOL_PROFILE_FLAG_RESET : 0;
+	uint32_t next_region = 0;
+	Protocol_Parser parser;
+
+	Protocol_Parser_Reset(&parser);
+
+	printf("%-26s %10s %10s %10s %10s %10s\n", "region", "count", "min_us", "mean_us", "max_us", "max_cyc");
+
+	while (next_region < PROFILE_REGION_COUNT)
+	{
+		uint8_t request[PROTOCOL_PROFILE_REQUEST_PAYLOAD_SIZE] = {(uint8_t)next_region, 0};
+		Protocol_Frame reply;
+		uint32_t clock_hz;
+
+		if (Send_Frame(fd, PROTOCOL_MSG_PROFILE_REQUEST, request, sizeof(request)) != 0)
+		{
+			fprintf(stderr, "write failed: %s\n", strerror(errno));
+			return 1;
+		}
+
+		if (!Receive_Frame(fd, &parser, PROTOCOL_MSG_PROFILE, 1.0, &reply) || (reply.payload_length < 2) ||
+		    (reply.payload[0] != next_region))
+		{
+			fprintf(stderr, "no valid profile reply\n");
+			return 1;
+		}
+
+		uint32_t offset = 2;
+		uint32_t used = Protocol_Get_Varint(&reply.payload[offset], reply.payload_length - offset, &clock_hz);
+		offset += used;
+
+		if ((used == 0) || (clock_hz == 0))
+		{
+			fprintf(stderr, "malformed profile reply\n");
+			return 1;
+		}
+
+		if (reply.payload[1] == 0)
+		{
+			fprintf(stderr, "profiling is compiled out (PROFILE_ENABLE = 0)\n");
+			return 1;
+		}
+
+		for (uint32_t i = 0; i < reply.payload[1]; i++)
+		{
+			uint32_t fields[4];
+
+			for (uint32_t f = 0; f < 4; f++)
+			{
+				used = Protocol_Get_Varint(&reply.payload[offset], reply.payload_length - offset, &fields[f]);
+				if (used == 0)
+				{
+					fprintf(stderr, "malformed profile reply\n");
+					return 1;
+				}
+				offset += used;
+			}
+
+			uint32_t region = next_region + i;
+			double us_per_cycle = 1e6 / clock_hz;
+
+			printf("%-26s %10u %10.2f %10.2f %10.2f %10u\n",
+				(region < PROFILE_REGION_COUNT) ? profile_region_names[region] : "?",
+				fields[0], fields[1] * us_per_cycle, fields[3] * us_per_cycle, fields[2] * us_per_cycle, fields[2]);
+		}
+
+		next_region += reply.payload[1];
+	}
+
+	if (flags != 0)
+	{
+		uint8_t request[PROTOCOL_PROFILE_REQUEST_PAYLOAD_SIZE] = {PROFILE_REGION_COUNT - 1, flags};
+		Protocol_Frame reply;
+
+		Send_Frame(fd, PROTOCOL_MSG_PROFILE_REQUEST, request, sizeof(request));
+		Receive_Frame(fd, &parser, PROTOCOL_MSG_PROFILE, 1.0, &reply);
+	}
+
+	return 0;
+}
+
+#define EVENT_TRACE_NAME(id, name) name,
+
+static const char *event_trace_source_names[EVENT_TRACE_SOURCE_COUNT] =
+{
+	EVENT_TRACE_SOURCE_LIST(EVENT_TRACE_NAME)
+};
+
+typedef struct
+{
+	// Cycles since the first record, with the 32-bit cycle counter unwrapped
+	int64_t cycles;
+	uint32_t index;
+	uint8_t event;
+	uint8_t arg;
+	uint16_t data;
+} Trace_Record;
+
+static int Compare_Trace_Records(const void *a, const void *b)
+{
+	const Trace_Record *x = a;
+	const Trace_Record *y = b;
+
+	if (x->cycles != y->cycles)
+	{
+		return (x->cycles < y->cycles) ? -1 : 1;
+	}
+
+	return (x->index < y->index) ? -1 : (x->index > y->index);
+}
+
+static int Command_Trace(int fd, int argc, char **argv)
+{
+	if (argc < 1)
+	{
+		fprintf(stderr, "trace needs <output.json>\n");
+		return 1;
+	}
+
+	uint8_t flags = ((argc > 1) && (strcmp(argv[1], "restart") == 0)) ? PROTOCOL_TRACE_FLAG_RESTART : 0;
+	Trace_Record *records = 0;
+	uint32_t record_count = 0;
+	uint32_t available = 1;
+	uint32_t written = 0;
+	uint32_t clock_hz = 0;
+	uint32_t previous_cycles = 0;
+	int64_t cycles = 0;
+	Protocol_Parser parser;
+
+	Protocol_Parser_Reset(&parser);
+
+	while (record_count < available)
+	{
+		uint8_t request[PROTOCOL_TRACE_REQUEST_PAYLOAD_SIZE] = {record_count & 0xFF, (record_count >> 8) & 0xFF, 0};
+		Protocol_Frame reply;
+
+		if (Send_Frame(fd, PROTOCOL_MSG_TRACE_REQUEST, request, sizeof(request)) != 0)
+		{
+			fprintf(stderr, "write failed: %s\n", strerror(errno));
+			free(records);
+			return 1;
+		}
+
+		if (!Receive_Frame(fd, &parser, PROTOCOL_MSG_TRACE, 1.0, &reply) ||
+		    (reply.payload_length < PROTOCOL_TRACE_HEADER_SIZE) ||
+		    ((uint32_t)(reply.payload[0] | (reply.payload[1] << 8)) != record_count) ||
+		    (reply.payload_length != PROTOCOL_TRACE_HEADER_SIZE + (reply.payload[4] * PROTOCOL_TRACE_RECORD_SIZE)))
+		{
+			fprintf(stderr, "no valid trace reply\n");
+			free(records);
+			return 1;
+		}
+
+		available = reply.payload[2] | (reply.payload[3] << 8);
+		clock_hz = Protocol_Get_U32(&reply.payload[5]);
+		written = Protocol_Get_U32(&reply.payload[9]);
+
+		if (records == 0)
+		{
+			records = calloc((available != 0) ? available : 1, sizeof(Trace_Record));
+			if (records == 0)
+			{
+				fprintf(stderr, "out of memory\n");
+				return 1;
+			}
+		}
+
+		if ((reply.payload[4] == 0) || (clock_hz == 0))
+		{
+			break;
+		}
+
+		for (uint32_t i = 0; (i < reply.payload[4]) && (record_count < available); i++)
+		{
+			const uint8_t *packed = &reply.payload[PROTOCOL_TRACE_HEADER_SIZE + (i * PROTOCOL_TRACE_RECORD_SIZE)];
+			uint32_t record_cycles = Protocol_Get_U32(packed);
+
+			// Records are in claim order, which can differ slightly from timestamp order,
+			// so the difference to the previous record is signed
+			if (record_count != 0)
+			{
+				cycles += (int32_t)(record_cycles - previous_cycles);
+			}
+			previous_cycles = record_cycles;
+
+			Trace_Record *record = &records[record_count];
+			record->cycles = cycles;
+			record->index = record_count;
+			record->event = packed[4];
+			record->arg = packed[5];
+			record->data = (uint16_t)(packed[6] | (packed[7] << 8));
+
+			record_count++;
+		}
+	}
+
+	if (flags != 0)
+	{
+		uint8_t request[PROTOCOL_TRACE_REQUEST_PAYLOAD_SIZE] = {available & 0xFF, (available >> 8) & 0xFF, flags};
+		Protocol_Frame reply;
+
+		Send_Frame(fd, PROTOCOL_MSG_TRACE_REQUEST, request, sizeof(request));
+		Receive_Frame(fd, &parser, PROTOCOL_MSG_TRACE, 1.0, &reply);
+	}
+
+	if (record_count == 0)
+	{
+		fprintf(stderr, "the trace buffer is empty (or tracing is compiled out with EVENT_TRACE_ENABLE = 0)\n");
+		free(records);
+		return 1;
+	}
+
+	qsort(records, record_count, sizeof(Trace_Record), Compare_Trace_Records);
+
+	FILE *file = fopen(argv[0], "w");
+	if (file == 0)
+	{
+		fprintf(stderr, "cannot open %s: %s\n", argv[0], strerror(errno));
+		free(records);
+		return 1;
+	}
+
+	// Track 1 is the main loop (tasks and frames); each interrupt handler has its own track
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	fprintf(file, "{\"ph\":\"M\",\"pid\":1,\"tid\":1,\"name\":\"thread_name\",\"args\":{\"name\":\"main loop\"}}");
+
+	for (uint32_t i = 0; i < EVENT_TRACE_SOURCE_COUNT; i++)
+	{
+		fprintf(file, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+			i + 2, event_trace_source_names[i]);
+	}
+
+	uint32_t isr_counts[EVENT_TRACE_SOURCE_COUNT] = {0};
+	uint32_t frame_count = 0;
+	uint32_t pwm_update_count = 0;
+	uint32_t pwm_fault_count = 0;
+	int64_t first_cycles = records[0].cycles;
+
+	for (uint32_t i = 0; i < record_count; i++)
+	{
+		const Trace_Record *record = &records[i];
+		double ts_us = (double)(record->cycles - first_cycles) * 1e6 / clock_hz;
+		const char *source = (record->arg < EVENT_TRACE_SOURCE_COUNT) ? event_trace_source_names[record->arg] : "?";
+
+		switch (record->event)
+		{
+			case EVENT_TRACE_ISR_ENTER:
+			case EVENT_TRACE_ISR_EXIT:
+				fprintf(file, ",\n{\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"name\":\"%s\"}",
+					(record->event == EVENT_TRACE_ISR_ENTER) ? "B" : "E", record->arg + 2, ts_us, source);
+				if ((record->event == EVENT_TRACE_ISR_ENTER) && (record->arg < EVENT_TRACE_SOURCE_COUNT))
+				{
+					isr_counts[record->arg]++;
+				}
+				break;
+
+			case EVENT_TRACE_TASK_START:
+			case EVENT_TRACE_TASK_STOP:
+				fprintf(file, ",\n{\"ph\":\"%s\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"name\":\"task %u\"}",
+					(record->event == EVENT_TRACE_TASK_START) ? "B" : "E", ts_us, record->arg);
+				break;
+
+			case EVENT_TRACE_FRAME_RECEIVED:
+				fprintf(file, ",\n{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":1,\"ts\":%.3f,"
+					"\"name\":\"frame 0x%02X\",\"args\":{\"sequence\":%u}}", ts_us, record->arg, record->data);
+				frame_count++;
+				break;
+
+			case EVENT_TRACE_PWM_UPDATE:
+				fprintf(file, ",\n{\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"name\":\"%s compare\",\"args\":{\"value\":%u}}",
+					ts_us, (record->arg == EVENT_TRACE_CHANNEL_ESC) ? "ESC" : "servo", record->data);
+				pwm_update_count++;
+				break;
+
+			case EVENT_TRACE_PWM_FAULT:
+				fprintf(file, ",\n{\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"ts\":%.3f,"
+					"\"name\":\"emergency stop (%s)\",\"args\":{\"count\":%u}}",
+					ts_us, (record->arg == EVENT_TRACE_FAULT_SOFTWARE) ? "software" : "input", record->data);
+				pwm_fault_count++;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+
+	double span_s = (double)(records[record_count - 1].cycles - first_cycles) / clock_hz;
+
+	printf("%u records over %.3f ms written to %s (%u older records were overwritten)\n",
+		record_count, span_s * 1e3, argv[0], written - record_count);
+
+	for (uint32_t i = 0; i < EVENT_TRACE_SOURCE_COUNT; i++)
+	{
+		printf("%-20s %8u entries %12.1f /s\n", event_trace_source_names[i], isr_counts[i],
+			(span_s > 0) ? isr_counts[i] / span_s : 0.0);
+	}
+
+	printf("%-20s %8u\n", "frames received", frame_count);
+	printf("%-20s %8u\n", "PWM updates", pwm_update_count);
+	printf("%-20s %8u\n", "emergency stops", pwm_fault_count);
+
+	free(records);
+
+	return 0;
+}
+
+static int Command_Steering(int fd, int argc, char **argv)
+{
+	if (argc < 1)
+	{
+		fprintf(stderr, "steering needs <expo_percent>\n");
+		return 1;
+	}
+
+	double expo = atof(argv[0]) / 100.0;
+	double left_us = (argc > 3) ? atof(argv[1]) : 1000.0;
+	double center_us = (argc > 3) ? atof(argv[2]) : 1500.0;
+	double right_us = (argc > 3) ? atof(argv[3]) : 2000.0;
+	uint16_t points[PROTOCOL_STEERING_POINTS];
+	Protocol_Parser parser;
+
+	Protocol_Parser_Reset(&parser);
+
+	for (uint32_t i = 0; i < PROTOCOL_STEERING_POINTS; i++)
+	{
+		double x = -1.0 + ((2.0 * i) / (PROTOCOL_STEERING_POINTS - 1));
+		double y = ((1.0 - expo) * x) + (expo * x * x * x);
+		double pulse_us = center_us + ((y < 0) ? (-y * (left_us - center_us)) : (y * (right_us - center_us)));
+
+		points[i] = (uint16_t)(pulse_us + 0.5);
+	}
+
+	for (uint32_t first = 0; first < PROTOCOL_STEERING_POINTS; first += PROTOCOL_STEERING_POINTS_PER_FRAME)
+	{
+		uint8_t payload[PROTOCOL_STEERING_TABLE_PAYLOAD_SIZE] = {0};
+		int last = (first + PROTOCOL_STEERING_POINTS_PER_FRAME) >= PROTOCOL_STEERING_POINTS;
+		Protocol_Frame ack;
+
+		payload[0] = (uint8_t)first;
+		payload[1] = last ? PROTOCOL_STEERING_FLAG_COMMIT : 0;
+
+		for (uint32_t i = 0; (i < PROTOCOL_STEERING_POINTS_PER_FRAME) && ((first + i) < PROTOCOL_STEERING_POINTS); i++)
+		{
+			payload[2 + (2 * i)] = (uint8_t)(points[first + i] & 0xFF);
+			payload[3 + (2 * i)] = (uint8_t)(points[first + i] >> 8);
+		}
+
+		if (Send_Frame(fd, PROTOCOL_MSG_STEERING_TABLE, payload, sizeof(payload)) != 0)
+		{
+			fprintf(stderr, "write failed: %s\n", strerror(errno));
+			return 1;
+		}
+
+		if (!Receive_Frame(fd, &parser, PROTOCOL_MSG_ACK, 1.0, &ack) || (ack.payload[0] != PROTOCOL_MSG_STEERING_TABLE))
+		{
+			fprintf(stderr, "steering table not acknowledged\n");
+			return 1;
+		}
+	}
+
+	for (uint32_t i = 0; i < PROTOCOL_STEERING_POINTS; i++)
+	{
+		printf("%5d %6u us\n", PROTOCOL_SETPOINT_MIN + (int)((i * (PROTOCOL_SETPOINT_MAX - PROTOCOL_SETPOINT_MIN)) / (PROTOCOL_STEERING_POINTS - 1)),
+			points[i]);
+	}
+
+	return 0;
+}
+
+static int Command_Stop(int fd, int argc, char **argv)
+{
+	int clear = (argc > 0) && (strcmp(argv[0], "clear") == 0);
+	uint8_t payload[PROTOCOL_EMERGENCY_STOP_PAYLOAD_SIZE];
+	Protocol_Parser parser;
+	Protocol_Frame ack;
+
+	Protocol_Parser_Reset(&parser);
+	payload[0] = clear ? PROTOCOL_EMERGENCY_STOP_CLEAR : PROTOCOL_EMERGENCY_STOP_SET;
+
+	if (Send_Frame(fd, PROTOCOL_MSG_EMERGENCY_STOP, payload, sizeof(payload)) != 0)
+	{
+		fprintf(stderr, "write failed: %s\n", strerror(errno));
+		return 1;
+	}
+
+	if (!Receive_Frame(fd, &parser, PROTOCOL_MSG_ACK, 1.0, &ack) || (ack.payload[0] != PROTOCOL_MSG_EMERGENCY_STOP))
+	{
+		fprintf(stderr, "emergency stop not acknowledged\n");
+		return 1;
+	}
+
+	printf(clear ? "emergency stop released\n" : "emergency stop set\n");
+
+	return 0;
+}
+
+static void Print_Usage(void)
+{
+	fprintf(stderr,
+		"Usage: rc_host <device> <baud_rate> <command> [arguments]\n"
+		"Commands:\n"
+		"  drive <throttle> <steering> [rate_hz] [count]\n"
+		"  telemetry [seconds]\n"
+		"  ping [count] [rate_hz]\n"
+		"  histogram <id> [reset]\n"
+		"  breakdown [reset]\n"
+		"  profile [reset]\n"
+		"  trace <output.json> [restart]\n"
+		"  steering <expo_percent> [left_us center_us right_us]\n"
+		"  stop [clear]\n");
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 4)
+	{
+		Print_Usage();
+		return 1;
+	}
+
+	int fd = Serial_Open(argv[1], atol(argv[2]));
+	if (fd < 0)
+	{
+		return 1;
+	}
+
+	int result;
+	const char *command = argv[3];
+
+	if (strcmp(command, "drive") == 0)
+	{
+		result = Command_Drive(fd, argc - 4, &argv[4]);
+	}
+	else if (strcmp(command, "telemetry") == 0)
+	{
+		result = Command_Telemetry(fd, argc - 4, &argv[4]);
+	}
+	else if (strcmp(command, "ping") == 0)
+	{
+		result = Command_Ping(fd, argc - 4, &argv[4]);
+	}
+	else if (strcmp(command, "histogram") == 0)
+	{
+		result = Command_Histogram(fd, argc - 4, &argv[4]);
+	}
+	else if (strcmp(command, "breakdown") == 0)
+	{
+		result = Command_Breakdown(fd, argc - 4, &argv[4]);
+	}
+	else if (strcmp(command, "profile") == 0)
+	{
+		result = Command_Profile(fd, argc - 4, &argv[4]);
+	}
+	else if (strcmp(command, "trace") == 0)
+	{
+		result = Command_Trace(fd, argc - 4, &argv[4]);
+	}
+	else if (strcmp(command, "steering") == 0)
+	{
+		result = Command_Steering(fd, argc - 4, &argv[4]);
+	}
+	else if (strcmp(command, "stop") == 0)
+	{
+		result = Command_Stop(fd, argc - 4, &argv[4]);
+	}
+	else
+	{
+		Print_Usage();
+		result = 1;
+	}
+
+	close(fd);
+
+	return result;
+}
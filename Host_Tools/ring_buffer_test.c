@@ -0,0 +1,247 @@
+/**
+ * @file ring_buffer_test.c
+ *
+ * @brief Host stress test of the Ring_Buffer driver with two threads.
+ *
+ * The firmware driver is compiled against the register model in Host_Model, where
+ * __DMB is a full memory barrier. A producer thread and a consumer thread run
+ * at the same time on one small buffer, so it is full or empty most of the time
+ * and both indices wrap around many times. The producer writes a pseudo-random
+ * byte sequence with Ring_Buffer_Put and Ring_Buffer_Write, and the consumer reads
+ * it back with Ring_Buffer_Get, Ring_Buffer_Read, and Ring_Buffer_Peek/Consume,
+ * each call with a random length.
+ *
+ * The consumer checks every byte against the same sequence, so a lost, repeated,
+ * or stale byte fails the test. Ring_Buffer_Count and Ring_Buffer_Free must always
+ * stay within the size of the buffer.
+ *
+ * Build:
+ *   gcc -O2 -pthread -IHost_Model -I../Keil_Project -o ring_buffer_test \
+ *       ring_buffer_test.c Host_Model/Host_Model.c ../Keil_Project/Ring_Buffer.c
+ *
+ * Usage:
+ *   ring_buffer_test [megabytes] [buffer_size]
+ *
+ * @author
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "Ring_Buffer.h"
+
+// Largest number of bytes moved by one call
+#define TEST_MAX_CHUNK 48
+
+static Ring_Buffer test_ring_buffer;
+static uint32_t test_size = 64;
+static uint64_t test_length = 0;
+
+// Set by either thread when a check fails
+static volatile int test_failed = 0;
+
+// Byte i of the test sequence
+static uint8_t Test_Byte(uint64_t i)
+{
+	uint64_t x = (i + 1) * 0x9E3779B97F4A7C15ULL;
+
+	return (uint8_t)((x >> 32) ^ (x >> 56));
+}
+
+static uint32_t Test_Random(uint32_t *state, uint32_t limit)
+{
+	// xorshift32
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+
+	return x % limit;
+}
+
+static void Test_Check_Levels(const char *thread)
+{
+	uint32_t count = Ring_Buffer_Count(&test_ring_buffer);
+	uint32_t free_bytes = Ring_Buffer_Free(&test_ring_buffer);
+
+	if ((count > test_size) || (free_bytes > test_size))
+	{
+		printf("FAIL: %s: count %u, free %u in a buffer of %u\n", thread, count, free_bytes, test_size);
+		test_failed = 1;
+	}
+}
+
+static void *Producer(void *argument)
+{
+	(void)argument;
+
+	uint32_t random_state = 0x12345678;
+	uint8_t chunk[TEST_MAX_CHUNK];
+	uint64_t written = 0;
+
+	while ((written < test_length) && !test_failed)
+	{
+		uint64_t previous = written;
+
+		Test_Check_Levels("producer");
+
+		if (Test_Random(&random_state, 2) == 0)
+		{
+			written += Ring_Buffer_Put(&test_ring_buffer, Test_Byte(written));
+		}
+		else
+		{
+			uint32_t length = Test_Random(&random_state, TEST_MAX_CHUNK) + 1;
+
+			if (length > (test_length - written))
+			{
+				length = (uint32_t)(test_length - written);
+			}
+
+			for (uint32_t i = 0; i < length; i++)
+			{
+				chunk[i] = Test_Byte(written + i);
+			}
+
+			written += Ring_Buffer_Write(&test_ring_buffer, chunk, length);
+		}
+
+		// Let the consumer run when the buffer is full (needed on a single CPU)
+		if (written == previous)
+		{
+			sched_yield();
+		}
+	}
+
+	return 0;
+}
+
+static int Consumer_Check(uint64_t *read_count, const uint8_t *data, uint32_t length)
+{
+	for (uint32_t i = 0; i < length; i++)
+	{
+		if (data[i] != Test_Byte(*read_count + i))
+		{
+			printf("FAIL: byte %llu is 0x%02X instead of 0x%02X\n",
+				(unsigned long long)(*read_count + i), data[i], Test_Byte(*read_count + i));
+			test_failed = 1;
+			return 0;
+		}
+	}
+
+	*read_count += length;
+
+	return 1;
+}
+
+static void *Consumer(void *argument)
+{
+	uint64_t *read_count = argument;
+	uint32_t random_state = 0x9ABCDEF1;
+	uint8_t chunk[TEST_MAX_CHUNK];
+
+	while ((*read_count < test_length) && !test_failed)
+	{
+		uint64_t previous = *read_count;
+
+		Test_Check_Levels("consumer");
+
+		switch (Test_Random(&random_state, 3))
+		{
+			case 0:
+			{
+				if (Ring_Buffer_Get(&test_ring_buffer, chunk))
+				{
+					Consumer_Check(read_count, chunk, 1);
+				}
+				break;
+			}
+
+			case 1:
+			{
+				uint32_t length = Ring_Buffer_Read(&test_ring_buffer, chunk, Test_Random(&random_state, TEST_MAX_CHUNK) + 1);
+
+				Consumer_Check(read_count, chunk, length);
+				break;
+			}
+
+			default:
+			{
+				const uint8_t *data;
+				uint32_t length = Ring_Buffer_Peek(&test_ring_buffer, &data);
+				uint32_t limit = Test_Random(&random_state, TEST_MAX_CHUNK) + 1;
+
+				if (length > limit)
+				{
+					length = limit;
+				}
+
+				if (Consumer_Check(read_count, data, length))
+				{
+					Ring_Buffer_Consume(&test_ring_buffer, length);
+				}
+				break;
+			}
+		}
+
+		// Let the producer run when the buffer is empty
+		if (*read_count == previous)
+		{
+			sched_yield();
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t megabytes = (argc > 1) ? strtoull(argv[1], 0, 0) : 64;
+
+	test_size = (argc > 2) ? (uint32_t)strtoul(argv[2], 0, 0) : 64;
+	test_length = megabytes << 20;
+
+	if ((test_size == 0) || ((test_size & (test_size - 1)) != 0))
+	{
+		printf("The buffer size must be a power of two\n");
+		return 1;
+	}
+
+	uint8_t *storage = malloc(test_size);
+
+	Ring_Buffer_Init(&test_ring_buffer, storage, test_size);
+
+	struct timespec start;
+	struct timespec end;
+	uint64_t read_count = 0;
+	pthread_t producer;
+	pthread_t consumer;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	pthread_create(&consumer, 0, Consumer, &read_count);
+	pthread_create(&producer, 0, Producer, 0);
+	pthread_join(producer, 0);
+	pthread_join(consumer, 0);
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	free(storage);
+
+	if (test_failed)
+	{
+		return 1;
+	}
+
+	double seconds = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) * 1e-9);
+
+	printf("%llu bytes through a %u-byte buffer in order (%.1f MB/s)\n",
+		(unsigned long long)read_count, test_size, ((double)read_count / seconds) / 1e6);
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file systick_model.c
+ *
+ * @brief Host test of the 64-bit timebase of the SysTick_Delay driver.
+ *
+ * The firmware driver is compiled against the register model in Host_Model. The
+ * model SysTick counts down from LOAD, reloads, and sets PENDSTSET in SCB->ICSR
+ * when it reaches 0. SysTick_Handler runs at a later register access once PRIMASK
+ * is clear, and sometimes only several accesses later, like a SysTick that waits
+ * behind a higher-priority interrupt.
+ *
+ * The counter advances by a random number of cycles at each register access, and
+ * before each read the time is often moved to a few cycles before the reload, so
+ * the reload falls between the reads of the rollover count, VAL, and ICSR in
+ * SysTick_Now_Cycles. Some reads are made with interrupts masked by the caller.
+ *
+ * Each result must lie between the model time before and after the call, and
+ * must never be lower than the previous one.
+ *
+ * Interrupts must not be masked for a whole reload period (1 ms), since a second
+ * reload would be lost; the test keeps its masked sections shorter than that.
+ *
+ * Build:
+ *   gcc -O2 -IHost_Model -I../Keil_Project -DEVENT_TRACE_ENABLE=0 -o systick_model \
+ *       systick_model.c Host_Model/Host_Model.c ../Keil_Project/SysTick_Delay.c
+ *
+ * Usage:
+ *   systick_model [reads] [seed]
+ *
+ * @author
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include "SysTick_Delay.h"
+
+// Model time in SysTick cycles since the counter was enabled
+static uint64_t model_cycles = 0;
+
+// Largest number of cycles that pass between two register accesses
+static uint32_t model_max_step = 8;
+
+// Number of accesses for which a pending SysTick interrupt is held back
+static uint32_t model_handler_delay = 0;
+
+static uint32_t Random_Below(uint32_t limit)
+{
+	return (uint32_t)(((uint64_t)rand() * limit) / ((uint64_t)RAND_MAX + 1));
+}
+
+static void Model_Update_VAL(void)
+{
+	uint32_t period = host_systick.LOAD + 1;
+
+	host_systick.VAL = host_systick.LOAD - (uint32_t)(model_cycles % period);
+}
+
+static void Model_Advance(uint32_t cycles)
+{
+	uint32_t period = host_systick.LOAD + 1;
+	uint64_t reloads = ((model_cycles + cycles) / period) - (model_cycles / period);
+
+	model_cycles += cycles;
+	Model_Update_VAL();
+
+	if (reloads > 1)
+	{
+		printf("FAIL: the model skipped %" PRIu64 " reloads in one step\n", reloads);
+		exit(1);
+	}
+
+	if (reloads == 1)
+	{
+		host_scb.ICSR |= SCB_ICSR_PENDSTSET_Msk;
+		model_handler_delay = Random_Below(4);
+	}
+}
+
+static void Model_Step(void)
+{
+	if ((host_systick.CTRL & 0x01) == 0)
+	{
+		return;
+	}
+
+	Model_Advance(Random_Below(model_max_step + 1));
+
+	if ((host_scb.ICSR & SCB_ICSR_PENDSTSET_Msk) && (host_primask == 0))
+	{
+		if (model_handler_delay > 0)
+		{
+			model_handler_delay--;
+		}
+		else
+		{
+			// Taking the exception clears the pending bit
+			host_scb.ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+			SysTick_Handler();
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t reads = (argc > 1) ? strtoull(argv[1], 0, 0) : 20000000;
+	unsigned int seed = (argc > 2) ? (unsigned int)strtoul(argv[2], 0, 0) : 1;
+
+	srand(seed);
+
+	host_model_step = Model_Step;
+	SysTick_Delay_Init();
+
+	// The counter starts at LOAD when it is enabled
+	model_cycles = 0;
+	Model_Update_VAL();
+
+	uint64_t previous = 0;
+	uint64_t pending_reads = 0;
+	uint64_t masked_reads = 0;
+	uint32_t max_error = 0;
+
+	for (uint64_t i = 0; i < reads; i++)
+	{
+		uint32_t period = SYSTICK_CYCLES_PER_TICK;
+		uint32_t phase = (uint32_t)(model_cycles % period);
+
+		// Move close to the next reload in most reads, once the previous one was handled
+		if (((host_scb.ICSR & SCB_ICSR_PENDSTSET_Msk) == 0) && (Random_Below(4) != 0))
+		{
+			uint32_t before_reload = Random_Below(16) + 1;
+
+			if ((period - phase) > before_reload)
+			{
+				Model_Advance((period - phase) - before_reload);
+			}
+		}
+
+		uint8_t masked = (Random_Below(8) == 0);
+
+		if (masked)
+		{
+			__disable_irq();
+			masked_reads++;
+		}
+
+		if (host_scb.ICSR & SCB_ICSR_PENDSTSET_Msk)
+		{
+			pending_reads++;
+		}
+
+		uint64_t start = model_cycles;
+		uint64_t now = SysTick_Now_Cycles();
+		uint64_t end = model_cycles;
+
+		if (masked)
+		{
+			__enable_irq();
+		}
+
+		if ((now < start) || (now > end))
+		{
+			printf("FAIL: read %" PRIu64 ": %" PRIu64 " cycles outside of [%" PRIu64 ", %" PRIu64 "]\n",
+				i, now, start, end);
+			return 1;
+		}
+
+		if (now < previous)
+		{
+			printf("FAIL: read %" PRIu64 ": %" PRIu64 " cycles after %" PRIu64 "\n", i, now, previous);
+			return 1;
+		}
+
+		if ((uint32_t)(end - start) > max_error)
+		{
+			max_error = (uint32_t)(end - start);
+		}
+
+		previous = now;
+	}
+
+	printf("%" PRIu64 " reads over %" PRIu64 " ms: monotonic\n", reads, model_cycles / SYSTICK_CYCLES_PER_TICK);
+	printf("  %" PRIu64 " reads with interrupts masked, %" PRIu64 " with a reload pending\n", masked_reads, pending_reads);
+	printf("  longest read: %" PRIu32 " cycles\n", max_error);
+
+	return 0;
+}
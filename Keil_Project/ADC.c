@@ -6,16 +6,18 @@
  * This file contains the function definitions for the ADC driver.
  *
  * ADC Module 0 is used to sample the potentiometer and the analog
- * light sensor that are connected on the EduBase board. ADC Module 0
- * is configured to sample the potentiometer first and the light sensor after.
+ * light sensor that are connected on the EduBase board, and the battery
+ * through a voltage divider. Timer 1A triggers Sample Sequencer 0, which
+ * converts the three channels in a row.
  *
- * After the light sensor is sampled, an interrupt signal is set to 
- * indicate that the sampling sequence has ended. After the conversion
- * results have been read from the corresponding FIFO, the interrupt is cleared.
+ * After the last channel is sampled, an interrupt signal is set to
+ * indicate that the sampling sequence has ended. ADC0SS0_Handler reads the
+ * conversion results from the FIFO into a double buffer and clears the interrupt.
  *
  * The following pins are used:
  *  - Potentiometer   <-->  Tiva LaunchPad Pin PE2 (Channel 1)
  *  - Light Sensor    <-->  Tiva LaunchPad Pin PE1 (Channel 2)
+ *  - Battery         <-->  Tiva LaunchPad Pin PE3 (Channel 0)
  *
  * @author
  *
@@ -23,80 +25,130 @@
 
 #include "ADC.h"
 
+// Written only by ADC0SS0_Handler
+// The handler fills adc_frames[(adc_sequence + 1) & 1] and then increments adc_sequence,
+// so the latest complete frame is always adc_frames[adc_sequence & 1]
+static volatile uint16_t adc_frames[2][ADC_CHANNEL_COUNT];
+static volatile uint32_t adc_sequence = 0;
+
 void ADC_Init(void)
 {
-	
+	adc_sequence = 0;
+
+	// 1. Enable the clocks to ADC Module 0, Timer 1, and Port E
 	SYSCTL->RCGCADC |= 0x01;
+	SYSCTL->RCGCTIMER |= 0x02;
 	SysTick_Delay1ms(1);
 	SYSCTL->RCGCGPIO |= 0x10;
-	GPIOE->DIR &= ~0x04;	
-	GPIOE->DEN &= ~0x04;
-	GPIOE->AMSEL |= 0x04;
-	GPIOE->AFSEL |= 0x04;
-	ADC0->ACTSS &= ~0x1;
-	ADC0->EMUX &= ~0x000F;
-	ADC0->SSMUX0 &= ~0xFFFFFFFF;
-	ADC0->SSMUX0 |= 0x00000001;
-	ADC0->SSCTL0 |= 0x00000002;
-	ADC0->SSCTL0 |= 0x00000004;
-	ADC0->ACTSS |= 0x1;
-	/*T1:
-		// 1. Enable the clock to ADC Module 0
-    SYSCTL->RCGCADC |= 0x01;
-    SysTick_Delay1ms(1);
-
-    // 2. Enable the clock to Port E
-    SYSCTL->RCGCGPIO |= 0x10;
-
-    // 3. Configure PE2 (Potentiometer) and PE1 (Light Sensor) as inputs
-    // Clearing bits 1 and 2
-    GPIOE->DIR &= ~0x06;
-
-    // 4. Disable digital functionality for PE2 and PE1
-    GPIOE->DEN &= ~0x06;
-
-    // 5. Enable analog functionality for PE2 and PE1
-    GPIOE->AMSEL |= 0x06;
-
-    // 6. Select alternate function for PE2 and PE1
-    GPIOE->AFSEL |= 0x06;
-
-    // 7. Disable Sample Sequencer 0 (SS0) before configuration
-    ADC0->ACTSS &= ~0x01;
-
-    // 8. Configure trigger event for SS0 to be the processor (default 0)
-    ADC0->EMUX &= ~0x000F;
-
-    // 9. Clear SS0 input multiplexer select register
-    ADC0->SSMUX0 &= ~0xFFFFFFFF;
-
-    // 10. Configure the sampling sequence:
-    // 1st Sample (MUX0): Channel 1 (PE2/Potentiometer) -> Write 0x1 to bits 3:0
-    // 2nd Sample (MUX1): Channel 2 (PE1/Light Sensor)  -> Write 0x2 to bits 7:4
-    ADC0->SSMUX0 |= 0x00000021;
-
-    // 11. Configure sample control bits (ADCSSCTL0):
-    // 1st Sample (Bit 0-3): No interrupt, not end of sequence. (All 0s)
-    // 2nd Sample (Bit 4-7): Enable Interrupt (IE1 at bit 6), End of Sequence (END1 at bit 5)
-    // Binary: 0110 0000 = 0x60
-    ADC0->SSCTL0 = 0x00000060;
-
-    // 13. Enable Sample Sequencer 0
-    ADC0->ACTSS |= 0x01;
-		*/
+
+	// 2. Configure PE1 (Light Sensor), PE2 (Potentiometer), and PE3 (Battery) as analog inputs
+	GPIOE->DIR &= ~0x0E;
+	GPIOE->DEN &= ~0x0E;
+	GPIOE->AMSEL |= 0x0E;
+	GPIOE->AFSEL |= 0x0E;
+
+	// 3. Disable Sample Sequencer 0 (SS0) before configuration
+	ADC0->ACTSS &= ~0x01;
+
+	// 4. Configure the trigger event for SS0 to be a timer (EM0 = 0x5)
+	ADC0->EMUX = (ADC0->EMUX & ~0x000F) | 0x0005;
+
+	// 5. Configure the sampling sequence (in the order of ADC_Channels):
+	// 1st Sample (MUX0): Channel 1 (PE2/Potentiometer)
+	// 2nd Sample (MUX1): Channel 2 (PE1/Light Sensor)
+	// 3rd Sample (MUX2): Channel 0 (PE3/Battery)
+	ADC0->SSMUX0 = 0x00000021;
+
+	// 6. Configure sample control bits (ADCSSCTL0):
+	// 3rd Sample (Bit 8-11): Enable Interrupt (IE2 at bit 10), End of Sequence (END2 at bit 9)
+	ADC0->SSCTL0 = 0x00000600;
+
+	// 7. Average 16 conversions per sample (the sequence takes 48 us at 1 Msps)
+	ADC0->SAC = 0x4;
+
+	// 8. Clear and enable the SS0 interrupt
+	ADC0->ISC = 0x01;
+	ADC0->IM |= 0x01;
+	NVIC_SetPriority(ADC0SS0_IRQn, ADC_INTERRUPT_PRIORITY);
+	NVIC_EnableIRQ(ADC0SS0_IRQn);
+
+	// 9. Enable Sample Sequencer 0
+	ADC0->ACTSS |= 0x01;
+
+	// 10. Configure Timer 1A as a 32-bit periodic timer (TAMR = 0x2) at ADC_SAMPLE_RATE_HZ
+	while ((SYSCTL->PRTIMER & 0x02) == 0);
+	TIMER1->CTL &= ~0x01;
+	TIMER1->CFG = 0x0;
+	TIMER1->TAMR = 0x2;
+
+	TIMER1->TAILR = (SYSTEM_CLOCK_HZ / ADC_SAMPLE_RATE_HZ) - 1;
+
+	// 11. Trigger the ADC on each time-out (TAOTE) and enable Timer 1A
+	TIMER1->CTL |= 0x20;
+	TIMER1->CTL |= 0x01;
+}
+
+uint8_t ADC_Read(ADC_Frame *frame)
+{
+	for (uint32_t attempt = 0; attempt < ADC_READ_ATTEMPTS; attempt++)
+	{
+		uint32_t start = adc_sequence;
+
+		if (start == 0)
+		{
+			return 0;
+		}
+
+		__DMB();
+		for (uint32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+		{
+			frame->raw[i] = adc_frames[start & 1][i];
+		}
+		__DMB();
+
+		// The next frame goes to the other buffer: the copy is overwritten only
+		// if the handler published two frames during it
+		if ((adc_sequence - start) < 2)
+		{
+			frame->sequence = start;
+
+			return 1;
+		}
+	}
+
+	return 0;
 }
 
-void ADC_Sample(double analog_value_buffer[])
+uint32_t ADC_Raw_To_mV(uint16_t raw)
 {
-	ADC0->PSSI |= 0x01;
-	while((ADC0->RIS & 0x01) == 0);
-	// First read is the Potentiometer (1st sample in sequence)
-  uint32_t potentiometer_sample_result = ADC0->SSFIFO0;
-  //Second read is the Light Sensor (2nd sample in sequence)
-  //T1: uint32_t light_sensor_sample_result = ADC0->SSFIFO0;
-	ADC0->ISC |= 0x01;
-	// Index 0: Potentiometer
-	analog_value_buffer[0] = (potentiometer_sample_result * 3.3) / 4096.0;
-	// Index 1: Light Sensor
-  //analog_value_buffer[1] = (light_sensor_sample_result * 3.3) / 4096.0;
+	return ((uint32_t)raw * 3300) / 4096;
+}
+
+void ADC0SS0_Handler(void)
+{
+	EVENT_TRACE_ENTER(EVENT_TRACE_ADC0SS0);
+	PROFILE_BEGIN(PROFILE_ADC0SS0_HANDLER);
+
+	ADC0->ISC = 0x01;
+
+	uint32_t next = adc_sequence + 1;
+
+	for (uint32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+	{
+		adc_frames[next & 1][i] = (uint16_t)(ADC0->SSFIFO0 & 0xFFF);
+	}
+
+	// Drop the results of sequences that overflowed the FIFO, so the next frame starts aligned
+	while ((ADC0->SSFSTAT0 & 0x100) == 0)
+	{
+		(void)ADC0->SSFIFO0;
+	}
+	ADC0->OSTAT = 0x01;
+
+	// Make the frame visible before it is published
+	__DMB();
+	adc_sequence = next;
+
+	PROFILE_END(PROFILE_ADC0SS0_HANDLER);
+	EVENT_TRACE_EXIT(EVENT_TRACE_ADC0SS0);
 }
@@ -6,38 +6,110 @@
  * This file contains the function definitions for the ADC driver.
  *
  * ADC Module 0 is used to sample the potentiometer and the analog
- * light sensor that are connected on the EduBase board. ADC Module 0
- * is configured to sample the potentiometer first and the light sensor after.
+ * light sensor that are connected on the EduBase board, and the battery
+ * through a voltage divider. Sample Sequencer 0 converts the three channels
+ * in a row, triggered by Timer 1A ADC_SAMPLE_RATE_HZ times per second,
+ * so no conversion is started or waited for by the CPU.
  *
- * After the light sensor is sampled, an interrupt signal is set to 
- * indicate that the sampling sequence has ended. After the conversion
- * results have been read from the corresponding FIFO, the interrupt is cleared.
+ * After the last channel is sampled, the sequencer interrupt is set, and
+ * ADC0SS0_Handler moves the conversion results from the FIFO into one of two
+ * frame buffers. The new frame is published only once it is complete, while the
+ * other buffer still holds the previous one, so ADC_Read always returns the latest
+ * complete frame immediately.
  *
  * The following pins are used:
  *  - Potentiometer   <-->  Tiva LaunchPad Pin PE2 (Channel 1)
  *  - Light Sensor    <-->  Tiva LaunchPad Pin PE1 (Channel 2)
+ *  - Battery         <-->  Tiva LaunchPad Pin PE3 (Channel 0), through a divider of ADC_BATTERY_DIVIDER
+ *
+ * Timer 1A is used to trigger the conversions.
  *
  * @author
  *
  */
 
+#ifndef ADC_H
+#define ADC_H
+
 #include "TM4C123GH6PM.h"
+#include "System_Clock.h"
 #include "SysTick_Delay.h"
+#include "Profile.h"
+#include "Event_Trace.h"
+
+// Number of conversion sequences per second (Timer 1A period)
+#define ADC_SAMPLE_RATE_HZ     100
+
+#if (SYSTEM_CLOCK_HZ % ADC_SAMPLE_RATE_HZ) != 0
+#error "SYSTEM_CLOCK_HZ must be a multiple of ADC_SAMPLE_RATE_HZ"
+#endif
+
+// Ratio of the battery voltage to the voltage on PE3: (R1 + R2) / R2, here 20k over 10k (up to 9.9 V)
+#define ADC_BATTERY_DIVIDER    3
+
+// NVIC priority of the Sample Sequencer 0 interrupt (below the PWM and UART1 interrupts)
+#define ADC_INTERRUPT_PRIORITY 3
+
+// Number of times ADC_Read retries a copy that was overwritten by ADC0SS0_Handler
+#define ADC_READ_ATTEMPTS      4
+
+// Channels of a frame, in the order they are converted
+enum ADC_Channels
+{
+	ADC_CHANNEL_POTENTIOMETER = 0,
+	ADC_CHANNEL_LIGHT_SENSOR  = 1,
+	ADC_CHANNEL_BATTERY       = 2,
+	ADC_CHANNEL_COUNT         = 3
+};
+
+typedef struct
+{
+	// Conversion results (0 to 4095 for 0 to 3.3 V), indexed by ADC_Channels
+	uint16_t raw[ADC_CHANNEL_COUNT];
+
+	// Number of frames converted since ADC_Init, up to and including this one
+	uint32_t sequence;
+} ADC_Frame;
 
 /**
- * @brief
+ * @brief The ADC_Init function initializes ADC Module 0 and starts the conversions.
+ *
+ * Sample Sequencer 0 converts the potentiometer, the light sensor, and the battery
+ * each time Timer 1A times out, ADC_SAMPLE_RATE_HZ times per second.
  *
- * @param
+ * @param None
  *
- * @return
+ * @return None
  */
 void ADC_Init(void);
 
 /**
- * @brief
+ * @brief The ADC_Read function copies the latest complete frame without waiting.
  *
- * @param
+ * @param frame A pointer to the frame to fill.
  *
- * @return
-*/
-void ADC_Sample(double analog_value_buffer[]);
+ * @return uint8_t 1 if a frame was copied, 0 if no frame has been converted yet
+ *                 or if every attempt was overwritten by a newer frame (frame may then
+ *                 hold a partial copy and must not be used).
+ */
+uint8_t ADC_Read(ADC_Frame *frame);
+
+/**
+ * @brief The ADC_Raw_To_mV function converts a conversion result to millivolts at the pin.
+ *
+ * @param raw The conversion result (0 to 4095).
+ *
+ * @return uint32_t The voltage in millivolts (0 to 3299).
+ */
+uint32_t ADC_Raw_To_mV(uint16_t raw);
+
+/**
+ * @brief The ADC0SS0_Handler function stores the results of Sample Sequencer 0 and publishes them.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void ADC0SS0_Handler(void);
+
+#endif
@@ -0,0 +1,304 @@
+/**
+ * @file Command.c
+ *
+ * @brief Source code for the Command driver.
+ *
+ * This file contains the function definitions for the Command driver.
+ * It reads the bytes received from the Bluetooth module (UART1) in place and feeds
+ * them one at a time to the incremental frame parser of the Protocol library. Valid
+ * frames are dispatched through a constant table indexed by message type, which holds
+ * the expected payload length and the handler that applies the command.
+ * Setpoints are published to the control loop through the Setpoint_Mailbox driver.
+ * Accepted commands are acknowledged with a PROTOCOL_MSG_ACK frame unless they have their
+ * own reply (pings, histogram, profile, and trace requests), and every valid
+ * frame is reported to the Link_Supervisor driver.
+ *
+ * Nothing is buffered or allocated: the parser decodes each byte directly into its frame
+ * structure, so the cost per byte is constant and a frame is applied as soon as its
+ * delimiter arrives.
+ *
+ * @author
+ */
+
+#include "Command.h"
+
+typedef void (*Command_Handler)(const Protocol_Frame *frame);
+
+typedef struct
+{
+	// Required payload length
+	uint8_t payload_length;
+
+	// Set for commands that are acknowledged with PROTOCOL_MSG_ACK (commands with their own reply are not)
+	uint8_t acknowledge;
+
+	// Function that applies the command, or 0 for message types the car does not handle
+	Command_Handler handler;
+} Command_Entry;
+
+static void Command_Handle_Setpoint(const Protocol_Frame *frame);
+static void Command_Handle_Ping(const Protocol_Frame *frame);
+static void Command_Handle_Histogram_Request(const Protocol_Frame *frame);
+static void Command_Handle_Profile_Request(const Protocol_Frame *frame);
+static void Command_Handle_Trace_Request(const Protocol_Frame *frame);
+static void Command_Handle_Steering_Table(const Protocol_Frame *frame);
+static void Command_Handle_Emergency_Stop(const Protocol_Frame *frame);
+
+// Command table indexed by message type
+static const Command_Entry command_table[] =
+{
+	[PROTOCOL_MSG_SETPOINT]          = {PROTOCOL_SETPOINT_PAYLOAD_SIZE,          1, Command_Handle_Setpoint},
+	[PROTOCOL_MSG_PING]              = {PROTOCOL_PING_PAYLOAD_SIZE,              0, Command_Handle_Ping},
+	[PROTOCOL_MSG_HISTOGRAM_REQUEST] = {PROTOCOL_HISTOGRAM_REQUEST_PAYLOAD_SIZE, 0, Command_Handle_Histogram_Request},
+	[PROTOCOL_MSG_PROFILE_REQUEST]   = {PROTOCOL_PROFILE_REQUEST_PAYLOAD_SIZE,   0, Command_Handle_Profile_Request},
+	[PROTOCOL_MSG_TRACE_REQUEST]     = {PROTOCOL_TRACE_REQUEST_PAYLOAD_SIZE,     0, Command_Handle_Trace_Request},
+	[PROTOCOL_MSG_STEERING_TABLE]    = {PROTOCOL_STEERING_TABLE_PAYLOAD_SIZE,    1, Command_Handle_Steering_Table},
+	[PROTOCOL_MSG_EMERGENCY_STOP]    = {PROTOCOL_EMERGENCY_STOP_PAYLOAD_SIZE,    1, Command_Handle_Emergency_Stop}
+};
+
+#define COMMAND_TABLE_SIZE (sizeof(command_table) / sizeof(command_table[0]))
+
+static Protocol_Parser command_parser;
+
+// Sequence numbers of the next frame of each type sent by the car
+static uint8_t ack_sequence = 0;
+static uint8_t pong_sequence = 0;
+static uint8_t histogram_sequence = 0;
+static uint8_t profile_sequence = 0;
+static uint8_t trace_sequence = 0;
+
+static uint8_t expected_sequence = 0;
+static uint8_t sequence_valid = 0;
+
+static Command_Stats command_stats;
+
+// Tracepoint stamps of the frame being handled
+static uint32_t rx_visible_stamp = 0;
+static uint32_t frame_decoded_stamp = 0;
+
+static void Command_Handle_Setpoint(const Protocol_Frame *frame)
+{
+	Protocol_Setpoint setpoint;
+
+	// The control loop applies the newest setpoint; older ones that it did not read are dropped
+	Protocol_Unpack_Setpoint(frame, &setpoint);
+	Setpoint_Mailbox_Publish(&setpoint);
+
+	Tracepoint_Record(TRACEPOINT_RX_VISIBLE, rx_visible_stamp);
+	Tracepoint_Record(TRACEPOINT_DECODED, frame_decoded_stamp);
+	Tracepoint_Record(TRACEPOINT_PUBLISHED, Tracepoint_Stamp());
+}
+
+// Queues a reply through the normal TX queue, ahead of any telemetry
+// Returns 1 if the frame was queued, 0 if the TX queue did not have room for all of it
+static uint8_t Command_Send_Reply(uint8_t type, uint8_t *sequence, const uint8_t *payload, uint32_t payload_length)
+{
+	uint8_t encoded[PROTOCOL_MAX_ENCODED_SIZE];
+
+	uint32_t length = Protocol_Encode_Frame(type, *sequence, payload, payload_length, encoded);
+
+	// Never queue part of a frame
+	if (UART1_TX_Free() < length)
+	{
+		command_stats.replies_dropped++;
+		return 0;
+	}
+
+	UART1_Write(encoded, length);
+	*sequence = *sequence + 1;
+
+	return 1;
+}
+
+static void Command_Handle_Ping(const Protocol_Frame *frame)
+{
+	uint8_t payload[PROTOCOL_PONG_PAYLOAD_SIZE];
+	uint32_t received_us = (uint32_t)SysTick_Now_us();
+
+	// The controller reports the round-trip time of its previous ping
+	uint32_t round_trip_us = Protocol_Get_U32(&frame->payload[4]);
+	if (round_trip_us != 0)
+	{
+		Latency_Record(PROTOCOL_HISTOGRAM_ROUND_TRIP, round_trip_us);
+	}
+
+	Protocol_Put_U32(Protocol_Get_U32(&frame->payload[0]), &payload[0]);
+	Protocol_Put_U32(received_us, &payload[4]);
+
+	uint32_t sent_us = (uint32_t)SysTick_Now_us();
+	Protocol_Put_U32(sent_us, &payload[8]);
+
+	if (Command_Send_Reply(PROTOCOL_MSG_PONG, &pong_sequence, payload, PROTOCOL_PONG_PAYLOAD_SIZE))
+	{
+		Latency_Record(PROTOCOL_HISTOGRAM_PING_TURNAROUND, sent_us - received_us);
+	}
+}
+
+static void Command_Handle_Histogram_Request(const Protocol_Frame *frame)
+{
+	uint8_t payload[PROTOCOL_MAX_PAYLOAD_SIZE];
+	uint8_t histogram_id = frame->payload[0];
+
+	uint32_t length = Latency_Pack_Histogram(histogram_id, frame->payload[1], payload);
+	if (length == 0)
+	{
+		return;
+	}
+
+	if (Command_Send_Reply(PROTOCOL_MSG_HISTOGRAM, &histogram_sequence, payload, length) &&
+	    (frame->payload[2] & PROTOCOL_HISTOGRAM_FLAG_RESET))
+	{
+		Latency_Reset(histogram_id);
+	}
+}
+
+static void Command_Handle_Profile_Request(const Protocol_Frame *frame)
+{
+	uint8_t payload[PROTOCOL_MAX_PAYLOAD_SIZE];
+
+	uint32_t length = Profile_Pack(frame->payload[0], payload);
+
+	if (Command_Send_Reply(PROTOCOL_MSG_PROFILE, &profile_sequence, payload, length) &&
+	    (frame->payload[1] & PROTOCOL_PROFILE_FLAG_RESET))
+	{
+		Profile_Reset();
+	}
+}
+
+static void Command_Handle_Trace_Request(const Protocol_Frame *frame)
+{
+	uint8_t payload[PROTOCOL_MAX_PAYLOAD_SIZE];
+	uint16_t first_record = (uint16_t)(frame->payload[0] | (frame->payload[1] << 8));
+
+	uint32_t length = Event_Trace_Pack(first_record, payload);
+
+	if (Command_Send_Reply(PROTOCOL_MSG_TRACE, &trace_sequence, payload, length) &&
+	    (frame->payload[2] & PROTOCOL_TRACE_FLAG_RESTART))
+	{
+		Event_Trace_Restart();
+	}
+}
+
+static void Command_Handle_Steering_Table(const Protocol_Frame *frame)
+{
+	uint16_t pulse_in_us[PROTOCOL_STEERING_POINTS_PER_FRAME];
+
+	for (uint32_t i = 0; i < PROTOCOL_STEERING_POINTS_PER_FRAME; i++)
+	{
+		pulse_in_us[i] = (uint16_t)(frame->payload[2 + (2 * i)] | (frame->payload[3 + (2 * i)] << 8));
+	}
+
+	Steering_Load(frame->payload[0], pulse_in_us, PROTOCOL_STEERING_POINTS_PER_FRAME);
+
+	if (frame->payload[1] & PROTOCOL_STEERING_FLAG_COMMIT)
+	{
+		Steering_Commit();
+	}
+}
+
+static void Command_Handle_Emergency_Stop(const Protocol_Frame *frame)
+{
+	// Anything but an explicit clear stops, so a corrupted action never releases the stop
+	if (frame->payload[0] == PROTOCOL_EMERGENCY_STOP_CLEAR)
+	{
+		PWM_Fault_Clear();
+	}
+	else
+	{
+		PWM_Fault_Trigger();
+	}
+}
+
+static void Command_Dispatch(const Protocol_Frame *frame)
+{
+	// Count the frames lost in between (sequence numbers wrap around at 256)
+	if (sequence_valid)
+	{
+		command_stats.sequence_gaps += (uint8_t)(frame->sequence - expected_sequence);
+	}
+	expected_sequence = frame->sequence + 1;
+	sequence_valid = 1;
+
+	if ((frame->type >= COMMAND_TABLE_SIZE) || (command_table[frame->type].handler == 0))
+	{
+		command_stats.unknown_types++;
+		return;
+	}
+
+	const Command_Entry *entry = &command_table[frame->type];
+
+	if (frame->payload_length != entry->payload_length)
+	{
+		command_stats.length_errors++;
+		return;
+	}
+
+	command_stats.frames_accepted++;
+	entry->handler(frame);
+
+	if (entry->acknowledge)
+	{
+		uint8_t payload[PROTOCOL_ACK_PAYLOAD_SIZE];
+
+		payload[0] = frame->type;
+		payload[1] = frame->sequence;
+
+		if (Command_Send_Reply(PROTOCOL_MSG_ACK, &ack_sequence, payload, PROTOCOL_ACK_PAYLOAD_SIZE))
+		{
+			command_stats.acks_sent++;
+		}
+	}
+}
+
+void Command_Init(void)
+{
+	Protocol_Parser_Reset(&command_parser);
+	sequence_valid = 0;
+
+	Command_Stats empty_stats = {0};
+	command_stats = empty_stats;
+}
+
+void Command_Process(void)
+{
+	const uint8_t *data;
+	uint32_t length;
+
+	PROFILE_BEGIN(PROFILE_COMMAND_PROCESS);
+
+	while ((length = UART1_RX_Peek(&data)) != 0)
+	{
+		rx_visible_stamp = Tracepoint_Stamp();
+
+		for (uint32_t i = 0; i < length; i++)
+		{
+			switch (Protocol_Parse_Byte(&command_parser, data[i]))
+			{
+				case PROTOCOL_IN_PROGRESS:    break;
+				case PROTOCOL_OK:
+				{
+					frame_decoded_stamp = Tracepoint_Stamp();
+					EVENT_TRACE(EVENT_TRACE_FRAME_RECEIVED, command_parser.frame.type, command_parser.frame.sequence);
+					Link_Supervisor_Frame_Received();
+					Command_Dispatch(&command_parser.frame);
+					break;
+				}
+				case PROTOCOL_ERROR_COBS:     command_stats.cobs_errors++;     break;
+				case PROTOCOL_ERROR_LENGTH:   command_stats.length_errors++;   break;
+				case PROTOCOL_ERROR_CRC:      command_stats.crc_errors++;      break;
+				case PROTOCOL_ERROR_VERSION:  command_stats.version_errors++;  break;
+				case PROTOCOL_ERROR_OVERSIZE: command_stats.oversize_frames++; break;
+				default: break;
+			}
+		}
+
+		UART1_RX_Consume(length);
+	}
+
+	PROFILE_END(PROFILE_COMMAND_PROCESS);
+}
+
+void Command_Get_Stats(Command_Stats *stats)
+{
+	*stats = command_stats;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file Command.h
+ *
+ * @brief Header file for the Command driver.
+ *
+ * This file contains the function definitions for the Command driver.
+ * It reads the bytes received from the Bluetooth module (UART1), decodes them one byte
+ * at a time with the incremental parser of the Protocol library, and applies the commands
+ * carried by valid frames through a constant command table.
+ *
+ * Corrupted frames are dropped and counted; the receiver resynchronizes at the next delimiter.
+ *
+ * @author
+ */
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include "TM4C123GH6PM.h"
+#include "Protocol.h"
+#include "UART1.h"
+#include "Setpoint_Mailbox.h"
+#include "Link_Supervisor.h"
+#include "Latency.h"
+#include "Tracepoint.h"
+#include "Profile.h"
+#include "Event_Trace.h"
+#include "Steering.h"
+#include "PWM.h"
+
+typedef struct
+{
+	// Frames that passed every check and were applied
+	uint32_t frames_accepted;
+
+	// Frames dropped because of a COBS, length, CRC, or version error
+	// A length error is also counted when the payload length does not match the command table
+	uint32_t cobs_errors;
+	uint32_t length_errors;
+	uint32_t crc_errors;
+	uint32_t version_errors;
+
+	// Frames that decoded to more than PROTOCOL_MAX_FRAME_SIZE bytes
+	uint32_t oversize_frames;
+
+	// Valid frames with a message type that the car does not handle
+	uint32_t unknown_types;
+
+	// Frames missing according to the sequence numbers of the accepted frames
+	uint32_t sequence_gaps;
+
+	// Acknowledgements queued
+	uint32_t acks_sent;
+
+	// Acknowledgements and other replies dropped because the TX queue was full
+	uint32_t replies_dropped;
+} Command_Stats;
+
+/**
+ * @brief The Command_Init function resets the frame receiver and the statistics.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Command_Init(void);
+
+/**
+ * @brief The Command_Process function handles every byte received since the previous call.
+ *
+ * This function reads the received bytes in place from UART1 and passes each one to the
+ * frame parser. A command is applied as soon as the delimiter of its frame arrives.
+ * It does not block and should be called from the main loop.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Command_Process(void);
+
+/**
+ * @brief The Command_Get_Stats function reads the frame statistics.
+ *
+ * @param stats A pointer to the structure that receives the statistics.
+ *
+ * @return None
+ */
+void Command_Get_Stats(Command_Stats *stats);
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file ESC_State.c
+ *
+ * @brief Source code for the ESC_State driver.
+ *
+ * This file contains the function definitions for the ESC_State driver.
+ * It arms the ESC in the background and sequences brake, neutral, and reverse
+ * when the throttle changes from forward to reverse.
+ *
+ * The timed states (arming, brake, and brake release) are ended by a one-shot
+ * Timer_Wheel timer, which is restarted or cancelled on each state change.
+ *
+ * @author
+ */
+
+#include "ESC_State.h"
+
+static uint8_t esc_state = PROTOCOL_ESC_ARMING;
+static int16_t esc_command = 0;
+static int16_t esc_throttle = 0;
+
+// Ends the timed states (arming, brake, and brake release)
+static Soft_Timer esc_state_timer;
+
+static void ESC_State_Enter(uint8_t state);
+
+static void ESC_State_Timer_Expired(void *context)
+{
+	(void)context;
+
+	switch (esc_state)
+	{
+		case PROTOCOL_ESC_ARMING:
+		{
+			ESC_State_Enter(PROTOCOL_ESC_NEUTRAL);
+			break;
+		}
+
+		case PROTOCOL_ESC_BRAKE:
+		{
+			ESC_State_Enter(PROTOCOL_ESC_BRAKE_RELEASE);
+			break;
+		}
+
+		case PROTOCOL_ESC_BRAKE_RELEASE:
+		{
+			// Reverse is allowed from here on
+			ESC_State_Enter((esc_command < 0) ? PROTOCOL_ESC_REVERSE : PROTOCOL_ESC_NEUTRAL);
+			break;
+		}
+
+		default:
+		{
+			break;
+		}
+	}
+}
+
+static void ESC_State_Enter(uint8_t state)
+{
+	esc_state = state;
+
+	switch (state)
+	{
+		case PROTOCOL_ESC_ARMING:
+		{
+			Timer_Wheel_Start(&esc_state_timer, ESC_STATE_ARMING_MS, 0, ESC_State_Timer_Expired, 0);
+			break;
+		}
+
+		case PROTOCOL_ESC_BRAKE:
+		{
+			Timer_Wheel_Start(&esc_state_timer, ESC_STATE_BRAKE_MS, 0, ESC_State_Timer_Expired, 0);
+			break;
+		}
+
+		case PROTOCOL_ESC_BRAKE_RELEASE:
+		{
+			Timer_Wheel_Start(&esc_state_timer, ESC_STATE_BRAKE_RELEASE_MS, 0, ESC_State_Timer_Expired, 0);
+			break;
+		}
+
+		default:
+		{
+			Timer_Wheel_Cancel(&esc_state_timer);
+			break;
+		}
+	}
+}
+
+void ESC_State_Init(void)
+{
+	ESC_State_Enter(PROTOCOL_ESC_ARMING);
+	esc_command = 0;
+	esc_throttle = 0;
+}
+
+void ESC_State_Set_Command(int16_t throttle)
+{
+	esc_command = throttle;
+}
+
+uint8_t ESC_State_Update(void)
+{
+	int16_t command = esc_command;
+	int16_t throttle = 0;
+
+	switch (esc_state)
+	{
+		case PROTOCOL_ESC_ARMING:
+		{
+			break;
+		}
+
+		case PROTOCOL_ESC_NEUTRAL:
+		{
+			if (command > 0)
+			{
+				ESC_State_Enter(PROTOCOL_ESC_FORWARD);
+			}
+			else if (command < 0)
+			{
+				ESC_State_Enter(PROTOCOL_ESC_REVERSE);
+			}
+			throttle = command;
+			break;
+		}
+
+		case PROTOCOL_ESC_FORWARD:
+		{
+			// The ESC remembers the forward direction until it has braked, even at neutral
+			if (command < 0)
+			{
+				ESC_State_Enter(PROTOCOL_ESC_BRAKE);
+			}
+			throttle = command;
+			break;
+		}
+
+		case PROTOCOL_ESC_BRAKE:
+		{
+			if (command > 0)
+			{
+				ESC_State_Enter(PROTOCOL_ESC_FORWARD);
+				throttle = command;
+			}
+			else if (command == 0)
+			{
+				ESC_State_Enter(PROTOCOL_ESC_BRAKE_RELEASE);
+			}
+			else
+			{
+				throttle = command;
+			}
+			break;
+		}
+
+		case PROTOCOL_ESC_BRAKE_RELEASE:
+		{
+			if (command > 0)
+			{
+				ESC_State_Enter(PROTOCOL_ESC_FORWARD);
+				throttle = command;
+			}
+			break;
+		}
+
+		case PROTOCOL_ESC_REVERSE:
+		{
+			if (command > 0)
+			{
+				ESC_State_Enter(PROTOCOL_ESC_FORWARD);
+			}
+			else if (command == 0)
+			{
+				ESC_State_Enter(PROTOCOL_ESC_NEUTRAL);
+			}
+			throttle = command;
+			break;
+		}
+
+		default:
+		{
+			ESC_State_Enter(PROTOCOL_ESC_ARMING);
+			break;
+		}
+	}
+
+	uint8_t changed = (throttle != esc_throttle);
+	esc_throttle = throttle;
+
+	return changed;
+}
+
+int16_t ESC_State_Get_Throttle(void)
+{
+	return esc_throttle;
+}
+
+uint8_t ESC_State_Get(void)
+{
+	return esc_state;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file ESC_State.h
+ *
+ * @brief Header file for the ESC_State driver.
+ *
+ * This file contains the function definitions for the ESC_State driver.
+ * It turns throttle commands into the pulse sequences that hobby ESCs expect,
+ * without ever blocking:
+ *
+ *  - After power-up, the ESC only arms after it has seen neutral pulses for
+ *    ESC_STATE_ARMING_MS. Throttle commands are held at neutral until then.
+ *  - After driving forward, the ESC treats the first reverse pulses as a brake. It only
+ *    drives backwards after the throttle has returned to neutral. A reverse command after
+ *    forward therefore brakes for ESC_STATE_BRAKE_MS, holds neutral for
+ *    ESC_STATE_BRAKE_RELEASE_MS, and then drives backwards.
+ *
+ * The commands are applied by ESC_State_Update, which the control task calls every
+ * period, so the steering keeps following its commands during arming and direction changes.
+ * The timed states end from a Timer_Wheel callback in the main loop, so like the
+ * Timer_Wheel driver, none of the functions in this driver may be called from an interrupt,
+ * and Timer_Wheel_Init must be called before ESC_State_Init.
+ * The states are listed in Protocol_ESC_States and reported in telemetry.
+ *
+ * The throttle returned by ESC_State_Get_Throttle is applied through the PWM driver,
+ * where the slew limiter still applies.
+ *
+ * @author
+ */
+
+#ifndef ESC_STATE_H
+#define ESC_STATE_H
+
+#include "TM4C123GH6PM.h"
+#include "Timer_Wheel.h"
+#include "Protocol.h"
+
+// Neutral hold needed by the ESC to arm after power-up
+#define ESC_STATE_ARMING_MS        3000
+
+// Reverse pulses after forward that the ESC applies as a brake before reverse is allowed
+#define ESC_STATE_BRAKE_MS         150
+
+// Neutral pulses between the brake and reverse (a few periods of the ESC PWM output)
+#define ESC_STATE_BRAKE_RELEASE_MS 50
+
+/**
+ * @brief The ESC_State_Init function starts arming the ESC.
+ *
+ * The throttle is held at neutral for ESC_STATE_ARMING_MS from this call on.
+ * The function returns immediately; the arming ends in Timer_Wheel_Update.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void ESC_State_Init(void);
+
+/**
+ * @brief The ESC_State_Set_Command function sets the throttle requested by the controller.
+ *
+ * @param throttle The throttle, from -1000 (full reverse) to +1000 (full forward).
+ *
+ * @return None
+ */
+void ESC_State_Set_Command(int16_t throttle);
+
+/**
+ * @brief The ESC_State_Update function applies the latest command to the state machine.
+ *
+ * This function should be called from the control task every period.
+ *
+ * @param None
+ *
+ * @return uint8_t 1 if the throttle to apply changed since the previous call, 0 otherwise.
+ */
+uint8_t ESC_State_Update(void);
+
+/**
+ * @brief The ESC_State_Get_Throttle function returns the throttle to apply to the ESC.
+ *
+ * @param None
+ *
+ * @return int16_t The throttle, from -1000 to +1000 (0 while arming or between brake and reverse).
+ */
+int16_t ESC_State_Get_Throttle(void);
+
+/**
+ * @brief The ESC_State_Get function returns the state of the state machine.
+ *
+ * @param None
+ *
+ * @return uint8_t One of the Protocol_ESC_States.
+ */
+uint8_t ESC_State_Get(void);
+
+#endif
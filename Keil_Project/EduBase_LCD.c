@@ -127,6 +127,8 @@ void EduBase_LCD_Write_4_Bits(uint8_t data, uint8_t control_flag)
 
 void EduBase_LCD_Send_Command(uint8_t command)
 {
+	PROFILE_BEGIN(PROFILE_LCD_SEND_COMMAND);
+
 	// Transmit the upper nibble of the command byte
 	EduBase_LCD_Write_4_Bits(command & 0xF0, SEND_COMMAND_FLAG);
 	
@@ -144,6 +146,8 @@ void EduBase_LCD_Send_Command(uint8_t command)
 	{
 		SysTick_Delay1us(37);
 	}
+
+	PROFILE_END(PROFILE_LCD_SEND_COMMAND);
 }
 
 void EduBase_LCD_Send_Data(uint8_t data)
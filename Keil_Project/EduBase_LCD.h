@@ -21,6 +21,7 @@
 
 #include "TM4C123GH6PM.h"
 #include "SysTick_Delay.h"
+#include "Profile.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -0,0 +1,141 @@
+/**
+ * @file Event_Trace.c
+ *
+ * @brief Source code for the Event_Trace driver.
+ *
+ * This file contains the function definitions for the Event_Trace driver.
+ * It records timestamped events in a lock-free ring buffer in RAM and packs
+ * them into PROTOCOL_MSG_TRACE payloads.
+ *
+ * @author
+ */
+
+#include "Event_Trace.h"
+#include "System_Clock.h"
+#include "Protocol.h"
+
+#define EVENT_TRACE_BUFFER_MASK (EVENT_TRACE_BUFFER_SIZE - 1)
+
+#if (EVENT_TRACE_BUFFER_SIZE & EVENT_TRACE_BUFFER_MASK) != 0
+#error "EVENT_TRACE_BUFFER_SIZE must be a power of two"
+#endif
+
+#if EVENT_TRACE_ENABLE
+
+typedef struct
+{
+	uint32_t cycles;
+	uint8_t event;
+	uint8_t arg;
+	uint16_t data;
+} Event_Trace_Entry;
+
+static Event_Trace_Entry event_trace_buffer[EVENT_TRACE_BUFFER_SIZE];
+
+// Number of records written since the buffer was cleared (the write index before masking)
+static volatile uint32_t event_trace_head = 0;
+
+static volatile uint8_t event_trace_recording = 0;
+
+// Write index at the time the recording was stopped
+static uint32_t event_trace_stopped_head = 0;
+
+#endif
+
+void Event_Trace_Init(void)
+{
+#if EVENT_TRACE_ENABLE
+	// Enable the trace and debug blocks (TRCENA), then start the cycle counter (CYCCNTENA)
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	Event_Trace_Restart();
+#endif
+}
+
+void Event_Trace_Record(uint8_t event, uint8_t arg, uint16_t data)
+{
+#if EVENT_TRACE_ENABLE
+	if (!event_trace_recording)
+	{
+		return;
+	}
+
+	uint32_t cycles = DWT->CYCCNT;
+	uint32_t index;
+
+	// Claim a slot; the store fails and is retried if an interrupt claimed one in between
+	do
+	{
+		index = __LDREXW(&event_trace_head);
+	} while (__STREXW(index + 1, &event_trace_head) != 0);
+
+	Event_Trace_Entry *entry = &event_trace_buffer[index & EVENT_TRACE_BUFFER_MASK];
+	entry->cycles = cycles;
+	entry->event = event;
+	entry->arg = arg;
+	entry->data = data;
+#else
+	(void)event;
+	(void)arg;
+	(void)data;
+#endif
+}
+
+void Event_Trace_Restart(void)
+{
+#if EVENT_TRACE_ENABLE
+	event_trace_recording = 0;
+	event_trace_head = 0;
+	event_trace_stopped_head = 0;
+	event_trace_recording = 1;
+#endif
+}
+
+uint32_t Event_Trace_Pack(uint16_t first_record, uint8_t *payload)
+{
+	uint32_t available = 0;
+	uint32_t written = 0;
+	uint32_t count = 0;
+	uint32_t length = PROTOCOL_TRACE_HEADER_SIZE;
+
+#if EVENT_TRACE_ENABLE
+	// Interrupts that were recording when this function was called have returned by now,
+	// so once the flag is cleared, the buffer no longer changes
+	if (event_trace_recording)
+	{
+		event_trace_recording = 0;
+		event_trace_stopped_head = event_trace_head;
+	}
+
+	written = event_trace_stopped_head;
+	available = (written < EVENT_TRACE_BUFFER_SIZE) ? written : EVENT_TRACE_BUFFER_SIZE;
+
+	uint32_t oldest = written - available;
+
+	while (((first_record + count) < available) && (count < PROTOCOL_TRACE_RECORDS_PER_FRAME))
+	{
+		const Event_Trace_Entry *entry = &event_trace_buffer[(oldest + first_record + count) & EVENT_TRACE_BUFFER_MASK];
+
+		Protocol_Put_U32(entry->cycles, &payload[length]);
+		payload[length + 4] = entry->event;
+		payload[length + 5] = entry->arg;
+		payload[length + 6] = (uint8_t)(entry->data & 0xFF);
+		payload[length + 7] = (uint8_t)(entry->data >> 8);
+
+		length += PROTOCOL_TRACE_RECORD_SIZE;
+		count++;
+	}
+#endif
+
+	// The core clock lets the controller convert cycles to time
+	payload[0] = (uint8_t)(first_record & 0xFF);
+	payload[1] = (uint8_t)(first_record >> 8);
+	payload[2] = (uint8_t)(available & 0xFF);
+	payload[3] = (uint8_t)(available >> 8);
+	payload[4] = (uint8_t)count;
+	Protocol_Put_U32(SYSTEM_CLOCK_HZ, &payload[5]);
+	Protocol_Put_U32(written, &payload[9]);
+
+	return length;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file Event_Trace.h
+ *
+ * @brief Header file for the Event_Trace driver.
+ *
+ * This file contains the function definitions for the Event_Trace driver.
+ * It records timestamped events (interrupt entry and exit, task start and stop,
+ * received frames, and PWM updates) in a ring buffer in RAM, so that the timeline
+ * of the firmware can be reconstructed on the host. The events are listed in
+ * Event_Trace_Events.h.
+ *
+ * Each record takes 8 bytes: the DWT cycle counter (core clock cycles), the event,
+ * an 8-bit argument, and 16 bits of data. When the buffer is full, the oldest records
+ * are overwritten, so the buffer always holds the most recent EVENT_TRACE_BUFFER_SIZE events.
+ *
+ * Recording is lock-free: a slot is claimed with an exclusive load and store (LDREX/STREX)
+ * on the write index, so interrupts of any priority can record events without masking
+ * each other. An interrupt that preempts another one between its timestamp and its claim
+ * can leave two records slightly out of timestamp order; the host sorts them.
+ *
+ * The controller reads the buffer over the link with PROTOCOL_MSG_TRACE_REQUEST.
+ * The first request stops the recording until a request with PROTOCOL_TRACE_FLAG_RESTART.
+ *
+ * When EVENT_TRACE_ENABLE is defined as 0 (e.g. -DEVENT_TRACE_ENABLE=0 in the compiler options),
+ * every macro expands to nothing and the buffer is not compiled.
+ *
+ * @author
+ */
+
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include "TM4C123GH6PM.h"
+#include "Event_Trace_Events.h"
+
+#ifndef EVENT_TRACE_ENABLE
+#define EVENT_TRACE_ENABLE 1
+#endif
+
+// Number of records in the buffer (must be a power of two)
+// 512 records of 8 bytes use 4 KB of the 32 KB of SRAM
+#define EVENT_TRACE_BUFFER_SIZE 512
+
+#if EVENT_TRACE_ENABLE
+
+#define EVENT_TRACE(event, arg, data) Event_Trace_Record((event), (arg), (data))
+#define EVENT_TRACE_ENTER(source)     Event_Trace_Record(EVENT_TRACE_ISR_ENTER, (source), 0)
+#define EVENT_TRACE_EXIT(source)      Event_Trace_Record(EVENT_TRACE_ISR_EXIT, (source), 0)
+
+#else
+
+#define EVENT_TRACE(event, arg, data)
+#define EVENT_TRACE_ENTER(source)
+#define EVENT_TRACE_EXIT(source)
+
+#endif
+
+/**
+ * @brief The Event_Trace_Init function enables the DWT cycle counter, clears the buffer, and starts recording.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Event_Trace_Init(void);
+
+/**
+ * @brief The Event_Trace_Record function adds one event to the buffer.
+ *
+ * This function is called by the EVENT_TRACE macros. It can be called from any interrupt.
+ * It does nothing while the recording is stopped.
+ *
+ * @param event One of the Event_Trace_Event_Ids.
+ *
+ * @param arg The argument of the event (see Event_Trace_Events.h).
+ *
+ * @param data The data of the event (see Event_Trace_Events.h).
+ *
+ * @return None
+ */
+void Event_Trace_Record(uint8_t event, uint8_t arg, uint16_t data);
+
+/**
+ * @brief The Event_Trace_Restart function clears the buffer and resumes recording.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Event_Trace_Restart(void);
+
+/**
+ * @brief The Event_Trace_Pack function writes a PROTOCOL_MSG_TRACE payload.
+ *
+ * This function stops the recording if it is active, then packs up to
+ * PROTOCOL_TRACE_RECORDS_PER_FRAME records starting with first_record, where record 0
+ * is the oldest one in the buffer. It must be called from the main loop.
+ *
+ * @param first_record The first record to include.
+ *
+ * @param payload A pointer to a buffer of at least PROTOCOL_MAX_PAYLOAD_SIZE bytes.
+ *
+ * @return uint32_t The payload length.
+ */
+uint32_t Event_Trace_Pack(uint16_t first_record, uint8_t *payload);
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file Event_Trace_Events.h
+ *
+ * @brief Header file for the list of traced events.
+ *
+ * This file contains the list of the events recorded by the Event_Trace driver and of the
+ * interrupt handlers that record their entry and exit. It does not use any hardware, so the
+ * host tool (see Host_Tools/rc_host.c) includes it to decode a PROTOCOL_MSG_TRACE reply.
+ *
+ * Each record holds an event, an 8-bit argument, and 16 bits of data:
+ *
+ *   Event                        Argument                 Data
+ *   EVENT_TRACE_ISR_ENTER        Event_Trace_Sources      -
+ *   EVENT_TRACE_ISR_EXIT         Event_Trace_Sources      -
+ *   EVENT_TRACE_TASK_START       Executive task ID        -
+ *   EVENT_TRACE_TASK_STOP        Executive task ID        -
+ *   EVENT_TRACE_FRAME_RECEIVED   Message type             Sequence number
+ *   EVENT_TRACE_PWM_UPDATE       Event_Trace_Channels     Compare value
+ *   EVENT_TRACE_PWM_FAULT        Event_Trace_Fault_Sources Number of emergency stops
+ *
+ * @author
+ */
+
+#ifndef EVENT_TRACE_EVENTS_H
+#define EVENT_TRACE_EVENTS_H
+
+#define EVENT_TRACE_EVENT_LIST(X) \
+	X(EVENT_TRACE_ISR_ENTER,      "isr_enter") \
+	X(EVENT_TRACE_ISR_EXIT,       "isr_exit") \
+	X(EVENT_TRACE_TASK_START,     "task_start") \
+	X(EVENT_TRACE_TASK_STOP,      "task_stop") \
+	X(EVENT_TRACE_FRAME_RECEIVED, "frame_received") \
+	X(EVENT_TRACE_PWM_UPDATE,     "pwm_update") \
+	X(EVENT_TRACE_PWM_FAULT,      "pwm_fault")
+
+// Interrupt handlers that record EVENT_TRACE_ISR_ENTER and EVENT_TRACE_ISR_EXIT
+#define EVENT_TRACE_SOURCE_LIST(X) \
+	X(EVENT_TRACE_SYSTICK,        "SysTick_Handler") \
+	X(EVENT_TRACE_UART1,          "UART1_Handler") \
+	X(EVENT_TRACE_PWM0_0,         "PWM0_0_Handler") \
+	X(EVENT_TRACE_TIMER0A,        "TIMER0A_Handler") \
+	X(EVENT_TRACE_PWM0_FAULT,     "PMW0_FAULT_Handler") \
+	X(EVENT_TRACE_ADC0SS0,        "ADC0SS0_Handler")
+
+#define EVENT_TRACE_ID(id, name) id,
+
+enum Event_Trace_Event_Ids
+{
+	EVENT_TRACE_EVENT_LIST(EVENT_TRACE_ID)
+	EVENT_TRACE_EVENT_COUNT
+};
+
+enum Event_Trace_Sources
+{
+	EVENT_TRACE_SOURCE_LIST(EVENT_TRACE_ID)
+	EVENT_TRACE_SOURCE_COUNT
+};
+
+#undef EVENT_TRACE_ID
+
+// PWM outputs reported by EVENT_TRACE_PWM_UPDATE
+enum Event_Trace_Channels
+{
+	EVENT_TRACE_CHANNEL_ESC   = 0,
+	EVENT_TRACE_CHANNEL_SERVO = 1
+};
+
+// Causes of an emergency stop reported by EVENT_TRACE_PWM_FAULT
+enum Event_Trace_Fault_Sources
+{
+	EVENT_TRACE_FAULT_INPUT    = 0,
+	EVENT_TRACE_FAULT_SOFTWARE = 1
+};
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * @file Executive.c
+ *
+ * @brief Source code for the Executive driver.
+ *
+ * This file contains the function definitions for the Executive driver.
+ * It provides a cooperative, run-to-completion executive with:
+ *  - Fixed-rate task slots (e.g. 1 kHz control, 100 Hz telemetry)
+ *  - An event queue that interrupt service routines can post to
+ *  - Per-task execution time and release jitter statistics
+ *
+ * Release times and statistics are measured in SysTick cycles (0.25 us)
+ * and converted to microseconds when they are read.
+ *
+ * @author
+ */
+
+#include "Executive.h"
+
+#define EXECUTIVE_EVENT_QUEUE_MASK (EXECUTIVE_EVENT_QUEUE_SIZE - 1)
+
+typedef struct
+{
+	const char *name;
+	Task_Function function;
+	uint32_t period_in_cycles;
+	uint64_t next_release;
+
+	uint32_t run_count;
+	uint32_t missed_count;
+	uint32_t max_exec_cycles;
+	uint64_t total_exec_cycles;
+	uint32_t max_jitter_cycles;
+	uint64_t total_jitter_cycles;
+} Executive_Task;
+
+static Executive_Task tasks[EXECUTIVE_MAX_TASKS];
+static uint8_t task_count = 0;
+
+static Event_Handler event_handlers[EXECUTIVE_MAX_EVENT_TYPES];
+
+// The queue head is only written by Executive_Run_Once (main loop), and the
+// queue tail is only written by Executive_Post_Event with interrupts masked
+static Executive_Event event_queue[EXECUTIVE_EVENT_QUEUE_SIZE];
+static volatile uint32_t event_queue_head = 0;
+static volatile uint32_t event_queue_tail = 0;
+static volatile uint32_t dropped_event_count = 0;
+
+static void Executive_Dispatch_Events(void)
+{
+	while (event_queue_head != event_queue_tail)
+	{
+		Executive_Event event = event_queue[event_queue_head & EXECUTIVE_EVENT_QUEUE_MASK];
+		event_queue_head = event_queue_head + 1;
+
+		if ((event.type < EXECUTIVE_MAX_EVENT_TYPES) && (event_handlers[event.type] != 0))
+		{
+			event_handlers[event.type](&event);
+		}
+	}
+}
+
+static void Executive_Run_Task(Executive_Task *task, uint64_t release_time)
+{
+	EVENT_TRACE(EVENT_TRACE_TASK_START, (uint8_t)(task - tasks), 0);
+
+	uint64_t start_time = SysTick_Now_Cycles();
+	task->function();
+	uint64_t end_time = SysTick_Now_Cycles();
+
+	EVENT_TRACE(EVENT_TRACE_TASK_STOP, (uint8_t)(task - tasks), 0);
+
+	uint32_t exec_cycles = (uint32_t)(end_time - start_time);
+	uint32_t jitter_cycles = (uint32_t)(start_time - release_time);
+
+	task->run_count = task->run_count + 1;
+	task->total_exec_cycles = task->total_exec_cycles + exec_cycles;
+	task->total_jitter_cycles = task->total_jitter_cycles + jitter_cycles;
+
+	if (exec_cycles > task->max_exec_cycles)
+	{
+		task->max_exec_cycles = exec_cycles;
+	}
+
+	if (jitter_cycles > task->max_jitter_cycles)
+	{
+		task->max_jitter_cycles = jitter_cycles;
+	}
+
+	// If the task fell more than a period behind, skip the missed releases
+	// instead of running the task back-to-back to catch up
+	while (task->next_release <= end_time)
+	{
+		task->next_release = task->next_release + task->period_in_cycles;
+		task->missed_count = task->missed_count + 1;
+	}
+}
+
+void Executive_Init(void)
+{
+	task_count = 0;
+
+	for (uint32_t i = 0; i < EXECUTIVE_MAX_EVENT_TYPES; i++)
+	{
+		event_handlers[i] = 0;
+	}
+
+	event_queue_head = 0;
+	event_queue_tail = 0;
+	dropped_event_count = 0;
+}
+
+uint8_t Executive_Add_Task(const char *name, Task_Function function, uint32_t period_in_us)
+{
+	if (task_count >= EXECUTIVE_MAX_TASKS)
+	{
+		return EXECUTIVE_INVALID_TASK;
+	}
+
+	Executive_Task *task = &tasks[task_count];
+
+	task->name = name;
+	task->function = function;
+	task->period_in_cycles = period_in_us * SYSTICK_CYCLES_PER_US;
+	task->next_release = SysTick_Now_Cycles() + task->period_in_cycles;
+
+	task->run_count = 0;
+	task->missed_count = 0;
+	task->max_exec_cycles = 0;
+	task->total_exec_cycles = 0;
+	task->max_jitter_cycles = 0;
+	task->total_jitter_cycles = 0;
+
+	task_count = task_count + 1;
+
+	return task_count - 1;
+}
+
+void Executive_Register_Event_Handler(uint8_t type, Event_Handler handler)
+{
+	if (type < EXECUTIVE_MAX_EVENT_TYPES)
+	{
+		event_handlers[type] = handler;
+	}
+}
+
+uint8_t Executive_Post_Event(uint8_t type, uint32_t data)
+{
+	uint8_t queued = 0;
+
+	// Interrupts of different priorities may post at the same time,
+	// so the tail is claimed with interrupts masked
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if ((event_queue_tail - event_queue_head) < EXECUTIVE_EVENT_QUEUE_SIZE)
+	{
+		Executive_Event *event = &event_queue[event_queue_tail & EXECUTIVE_EVENT_QUEUE_MASK];
+		event->type = type;
+		event->data = data;
+		event_queue_tail = event_queue_tail + 1;
+		queued = 1;
+	}
+	else
+	{
+		dropped_event_count = dropped_event_count + 1;
+	}
+
+	__set_PRIMASK(primask);
+
+	return queued;
+}
+
+void Executive_Run_Once(void)
+{
+	Executive_Dispatch_Events();
+
+	for (uint32_t i = 0; i < task_count; i++)
+	{
+		Executive_Task *task = &tasks[i];
+		uint64_t release_time = task->next_release;
+
+		if (SysTick_Now_Cycles() >= release_time)
+		{
+			task->next_release = release_time + task->period_in_cycles;
+			Executive_Run_Task(task, release_time);
+
+			// Events posted while the task was running are handled before the next task
+			Executive_Dispatch_Events();
+		}
+	}
+}
+
+uint8_t Executive_Get_Task_Count(void)
+{
+	return task_count;
+}
+
+uint8_t Executive_Get_Task_Stats(uint8_t task_id, Executive_Task_Stats *stats)
+{
+	if (task_id >= task_count)
+	{
+		return 0;
+	}
+
+	const Executive_Task *task = &tasks[task_id];
+
+	stats->name = task->name;
+	stats->period_in_us = task->period_in_cycles / SYSTICK_CYCLES_PER_US;
+	stats->run_count = task->run_count;
+	stats->missed_count = task->missed_count;
+	stats->max_exec_in_us = task->max_exec_cycles / SYSTICK_CYCLES_PER_US;
+	stats->max_jitter_in_us = task->max_jitter_cycles / SYSTICK_CYCLES_PER_US;
+
+	if (task->run_count > 0)
+	{
+		stats->mean_exec_in_us = (uint32_t)(task->total_exec_cycles / task->run_count) / SYSTICK_CYCLES_PER_US;
+		stats->mean_jitter_in_us = (uint32_t)(task->total_jitter_cycles / task->run_count) / SYSTICK_CYCLES_PER_US;
+	}
+	else
+	{
+		stats->mean_exec_in_us = 0;
+		stats->mean_jitter_in_us = 0;
+	}
+
+	return 1;
+}
+
+void Executive_Reset_Stats(void)
+{
+	for (uint32_t i = 0; i < task_count; i++)
+	{
+		tasks[i].run_count = 0;
+		tasks[i].missed_count = 0;
+		tasks[i].max_exec_cycles = 0;
+		tasks[i].total_exec_cycles = 0;
+		tasks[i].max_jitter_cycles = 0;
+		tasks[i].total_jitter_cycles = 0;
+	}
+}
+
+uint32_t Executive_Get_Dropped_Event_Count(void)
+{
+	return dropped_event_count;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file Executive.h
+ *
+ * @brief Header file for the Executive driver.
+ *
+ * This file contains the function definitions for the Executive driver.
+ * It provides a cooperative, run-to-completion executive with:
+ *  - Fixed-rate task slots (e.g. 1 kHz control, 100 Hz telemetry)
+ *  - An event queue that interrupt service routines can post to
+ *  - Per-task execution time and release jitter statistics
+ *
+ * Tasks are released from the SysTick timebase (SysTick_Now_us). Tasks are checked
+ * in the order in which they were added, so the fastest task should be added first.
+ * A task always runs to completion; it is never preempted by another task, only by interrupts.
+ *
+ * Events posted from interrupts are dispatched to their handlers before any task
+ * is released, so an interrupt only has to capture data and defer the rest of the work.
+ *
+ * @author
+ */
+
+#ifndef EXECUTIVE_H
+#define EXECUTIVE_H
+
+#include "TM4C123GH6PM.h"
+#include "SysTick_Delay.h"
+#include "Event_Trace.h"
+
+// Maximum number of fixed-rate tasks
+#define EXECUTIVE_MAX_TASKS         8
+
+// Maximum number of event types that can have a handler
+#define EXECUTIVE_MAX_EVENT_TYPES   16
+
+// Number of entries in the event queue (must be a power of two)
+#define EXECUTIVE_EVENT_QUEUE_SIZE  32
+
+// Returned by Executive_Add_Task when there are no free task slots
+#define EXECUTIVE_INVALID_TASK      0xFF
+
+// Event types posted by the interrupt handlers
+enum Executive_Event_Types
+{
+	// PMW0_FAULT_Handler disabled the PWM outputs; data: one of the Event_Trace_Fault_Sources
+	EXECUTIVE_EVENT_PWM_FAULT = 0
+};
+
+// Function called when a task is released
+typedef void (*Task_Function)(void);
+
+typedef struct
+{
+	uint8_t type;
+	uint32_t data;
+} Executive_Event;
+
+// Function called from the main loop when an event of the registered type is dispatched
+typedef void (*Event_Handler)(const Executive_Event *event);
+
+typedef struct
+{
+	const char *name;
+	uint32_t period_in_us;
+
+	// Number of times the task has run
+	uint32_t run_count;
+
+	// Number of releases that were skipped because the task started more than one period late
+	uint32_t missed_count;
+
+	// Execution time in microseconds
+	uint32_t max_exec_in_us;
+	uint32_t mean_exec_in_us;
+
+	// Release jitter (actual start time - scheduled release time) in microseconds
+	uint32_t max_jitter_in_us;
+	uint32_t mean_jitter_in_us;
+} Executive_Task_Stats;
+
+/**
+ * @brief The Executive_Init function initializes the executive.
+ *
+ * This function removes all tasks and event handlers and empties the event queue.
+ * SysTick_Delay_Init must be called before this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Executive_Init(void);
+
+/**
+ * @brief The Executive_Add_Task function adds a fixed-rate task.
+ *
+ * The task is first released one period after it is added. Tasks are checked
+ * in the order in which they were added, so the task with the highest rate
+ * (and the tightest deadline) should be added first.
+ *
+ * @param name A short name for the task, used when reporting statistics.
+ *
+ * @param function The function to call each time the task is released.
+ *
+ * @param period_in_us The period of the task in microseconds.
+ *
+ * @return uint8_t The task ID, or EXECUTIVE_INVALID_TASK if there are no free task slots.
+ */
+uint8_t Executive_Add_Task(const char *name, Task_Function function, uint32_t period_in_us);
+
+/**
+ * @brief The Executive_Register_Event_Handler function sets the handler for an event type.
+ *
+ * @param type The event type (0 to EXECUTIVE_MAX_EVENT_TYPES - 1).
+ *
+ * @param handler The function to call when an event of this type is dispatched.
+ *
+ * @return None
+ */
+void Executive_Register_Event_Handler(uint8_t type, Event_Handler handler);
+
+/**
+ * @brief The Executive_Post_Event function adds an event to the event queue.
+ *
+ * This function may be called from any interrupt or from the main loop. Interrupts
+ * are masked for a few instructions while the event is written to the queue.
+ *
+ * @param type The event type.
+ *
+ * @param data A value passed to the event handler.
+ *
+ * @return uint8_t 1 if the event was queued, 0 if the queue was full and the event was dropped.
+ */
+uint8_t Executive_Post_Event(uint8_t type, uint32_t data);
+
+/**
+ * @brief The Executive_Run_Once function runs one pass of the executive.
+ *
+ * This function dispatches every pending event, then runs each task whose release
+ * time has been reached, in the order in which the tasks were added. It should be
+ * called repeatedly from the main loop.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Executive_Run_Once(void);
+
+/**
+ * @brief The Executive_Get_Task_Count function returns the number of tasks that have been added.
+ *
+ * @param None
+ *
+ * @return uint8_t The number of tasks.
+ */
+uint8_t Executive_Get_Task_Count(void);
+
+/**
+ * @brief The Executive_Get_Task_Stats function reads the statistics of a task.
+ *
+ * @param task_id The task ID returned by Executive_Add_Task.
+ *
+ * @param stats A pointer to the structure that receives the statistics.
+ *
+ * @return uint8_t 1 if the task ID is valid, 0 otherwise.
+ */
+uint8_t Executive_Get_Task_Stats(uint8_t task_id, Executive_Task_Stats *stats);
+
+/**
+ * @brief The Executive_Reset_Stats function clears the statistics of every task.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Executive_Reset_Stats(void);
+
+/**
+ * @brief The Executive_Get_Dropped_Event_Count function returns the number of events dropped because the queue was full.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of dropped events.
+ */
+uint32_t Executive_Get_Dropped_Event_Count(void);
+
+#endif
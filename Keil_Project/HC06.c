@@ -0,0 +1,257 @@
+/**
+ * @file HC06.c
+ *
+ * @brief Source code for the HC06 driver.
+ *
+ * This file contains the function definitions for the HC06 driver.
+ * It configures the baud rate of the HC-06 Bluetooth module at boot with AT commands
+ * sent over UART1.
+ *
+ * @author
+ */
+
+#include "HC06.h"
+
+typedef struct
+{
+	uint32_t baud_rate;
+
+	// Argument of the AT+BAUD command for this rate
+	char code;
+} HC06_Baud_Rate;
+
+// Rates the module can be moved to, from fastest to slowest
+// 115200 bps is 27.13 with a 50 MHz clock, which the fractional divisor reaches with an error below 0.1%
+static const HC06_Baud_Rate HC06_TARGET_BAUD_RATES[] =
+{
+	{115200, '8'},
+	{57600,  '7'},
+	{38400,  '6'}
+};
+
+// Rates the module may currently be at, in the order they are probed
+static const uint32_t HC06_PROBE_BAUD_RATES[] =
+{
+	115200, UART1_DEFAULT_BAUD_RATE, 57600, 38400, 19200, 230400
+};
+
+#define HC06_TARGET_COUNT (sizeof(HC06_TARGET_BAUD_RATES) / sizeof(HC06_TARGET_BAUD_RATES[0]))
+#define HC06_PROBE_COUNT  (sizeof(HC06_PROBE_BAUD_RATES) / sizeof(HC06_PROBE_BAUD_RATES[0]))
+
+static HC06_Status hc06_status;
+
+// SysTick_Now_ms time at which the boot budget runs out
+static uint32_t hc06_deadline_ms;
+
+static uint32_t HC06_Time_Left_ms(void)
+{
+	int32_t time_left = (int32_t)(hc06_deadline_ms - SysTick_Now_ms());
+
+	return (time_left > 0) ? (uint32_t)time_left : 0;
+}
+
+// Waits for delay_in_ms, or until the boot budget runs out
+static void HC06_Wait_ms(uint32_t delay_in_ms)
+{
+	uint32_t time_left = HC06_Time_Left_ms();
+
+	SysTick_Delay1ms((delay_in_ms < time_left) ? delay_in_ms : time_left);
+}
+
+static uint32_t HC06_Receive_Errors(void)
+{
+	UART1_Stats stats;
+	UART1_Get_Stats(&stats);
+
+	return stats.framing_errors + stats.parity_errors + stats.break_errors + stats.overrun_errors;
+}
+
+static void HC06_Flush_Input(void)
+{
+	const uint8_t *data;
+	uint32_t length;
+
+	while ((length = UART1_RX_Peek(&data)) != 0)
+	{
+		UART1_RX_Consume(length);
+	}
+}
+
+// Sends an AT command and waits until the answer contains the expected string
+// Returns 1 if the answer arrived without any receive error before the timeout
+// or the end of the boot budget
+static uint8_t HC06_Send_Command(const char *command, const char *expected)
+{
+	uint32_t matched = 0;
+	uint32_t errors = HC06_Receive_Errors();
+	uint32_t timeout = HC06_Time_Left_ms();
+
+	if (timeout == 0)
+	{
+		hc06_status.budget_exhausted = 1;
+		return 0;
+	}
+
+	if (timeout > HC06_RESPONSE_TIMEOUT_MS)
+	{
+		timeout = HC06_RESPONSE_TIMEOUT_MS;
+	}
+
+	HC06_Flush_Input();
+	UART1_Write_String(command);
+	hc06_status.commands_sent++;
+
+	uint32_t start = SysTick_Now_ms();
+
+	while ((SysTick_Now_ms() - start) < timeout)
+	{
+		uint8_t data;
+
+		if (!UART1_Read_Byte(&data))
+		{
+			continue;
+		}
+
+		// The expected strings have no repeated prefix, so a mismatch restarts the match
+		if (data == (uint8_t)expected[matched])
+		{
+			matched = matched + 1;
+		}
+		else
+		{
+			matched = (data == (uint8_t)expected[0]) ? 1 : 0;
+		}
+
+		if (expected[matched] == '\0')
+		{
+			return (HC06_Receive_Errors() == errors);
+		}
+	}
+
+	hc06_status.timeouts++;
+
+	return 0;
+}
+
+// Returns 1 if the module answers "AT" at a baud rate
+static uint8_t HC06_Answers_At(uint32_t baud_rate)
+{
+	// Only UART1 changes rate here, so no settle time is needed: a command that
+	// is cut by the switch gets no answer and times out
+	UART1_Set_Baud_Rate(baud_rate);
+
+	return HC06_Send_Command("AT", "OK");
+}
+
+// Returns the baud rate the module answers at, or 0 if it does not answer
+// before the end of the boot budget
+static uint32_t HC06_Probe(void)
+{
+	for (uint32_t i = 0; i < HC06_PROBE_COUNT; i++)
+	{
+		if (HC06_Answers_At(HC06_PROBE_BAUD_RATES[i]))
+		{
+			return HC06_PROBE_BAUD_RATES[i];
+		}
+
+		if (HC06_Time_Left_ms() == 0)
+		{
+			hc06_status.budget_exhausted = 1;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+uint32_t HC06_Autoconfigure(void)
+{
+	HC06_Status empty_status = {0};
+	hc06_status = empty_status;
+
+	uint32_t start_ms = SysTick_Now_ms();
+	hc06_deadline_ms = start_ms + HC06_BOOT_BUDGET_MS;
+
+	uint32_t current_baud_rate = HC06_Probe();
+	hc06_status.detected_baud_rate = current_baud_rate;
+
+	// No answer: leave the module alone and use the default rate
+	if (current_baud_rate == 0)
+	{
+		UART1_Set_Baud_Rate(UART1_DEFAULT_BAUD_RATE);
+		hc06_status.active_baud_rate = UART1_DEFAULT_BAUD_RATE;
+		hc06_status.boot_time_in_ms = SysTick_Now_ms() - start_ms;
+		return UART1_DEFAULT_BAUD_RATE;
+	}
+
+	for (uint32_t i = 0; i < HC06_TARGET_COUNT; i++)
+	{
+		const HC06_Baud_Rate *target = &HC06_TARGET_BAUD_RATES[i];
+
+		// Do not move the module to a slower rate than it is already at
+		if (target->baud_rate <= current_baud_rate)
+		{
+			break;
+		}
+
+		// Stay at the current rate rather than be cut in the middle of a change
+		if (HC06_Time_Left_ms() < HC06_RATE_CHANGE_TIME_MS)
+		{
+			hc06_status.budget_exhausted = 1;
+			break;
+		}
+
+		// The module answers "OK<rate>" at the old rate, then switches
+		char command[] = "AT+BAUD?";
+		command[7] = target->code;
+
+		if (!HC06_Send_Command(command, "OK"))
+		{
+			// The command or its answer was lost: the module most likely stayed at the current
+			// rate, but may have switched. Try the next slower rate if it is still there
+			if (HC06_Answers_At(current_baud_rate))
+			{
+				continue;
+			}
+
+			if (HC06_Answers_At(target->baud_rate))
+			{
+				current_baud_rate = target->baud_rate;
+			}
+			break;
+		}
+
+		UART1_Set_Baud_Rate(target->baud_rate);
+		HC06_Wait_ms(HC06_SETTLE_TIME_MS);
+
+		if (HC06_Send_Command("AT", "OK"))
+		{
+			current_baud_rate = target->baud_rate;
+			break;
+		}
+
+		// The module acknowledged the change but does not answer at the new rate.
+		// If it stayed at the current rate (its firmware does not support the new one),
+		// try the next slower rate. Otherwise it did move, so the new rate is the only
+		// one it can still be reached at
+		hc06_status.rejected_rates++;
+
+		if (!HC06_Answers_At(current_baud_rate))
+		{
+			current_baud_rate = target->baud_rate;
+			break;
+		}
+	}
+
+	UART1_Set_Baud_Rate(current_baud_rate);
+	HC06_Flush_Input();
+	hc06_status.active_baud_rate = current_baud_rate;
+	hc06_status.boot_time_in_ms = SysTick_Now_ms() - start_ms;
+
+	return current_baud_rate;
+}
+
+void HC06_Get_Status(HC06_Status *status)
+{
+	*status = hc06_status;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file HC06.h
+ *
+ * @brief Header file for the HC06 driver.
+ *
+ * This file contains the function definitions for the HC06 driver.
+ * It configures the baud rate of the HC-06 Bluetooth module at boot with AT commands
+ * sent over UART1 (see UART1.h).
+ *
+ * The HC-06 only answers AT commands while no device is connected to it, and it keeps the
+ * last baud rate it was set to across power cycles. At boot, the module's current baud rate
+ * is found by sending "AT" at each supported rate until it answers "OK". The module is then
+ * moved to the fastest rate in HC06_TARGET_BAUD_RATES with "AT+BAUDn", and the new rate is
+ * checked with another "AT" before it is kept.
+ *
+ * The commands follow the original HC-06 firmware ("linvor"), which ends a command after
+ * a short pause instead of a line terminator. Host_Tools/hc06_model.c runs the
+ * autoconfiguration against a stand-in of the module on a pty.
+ *
+ * @author
+ */
+
+#ifndef HC06_H
+#define HC06_H
+
+#include "TM4C123GH6PM.h"
+#include "SysTick_Delay.h"
+#include "UART1.h"
+
+// Time to wait for an answer to an AT command
+#define HC06_RESPONSE_TIMEOUT_MS  600
+
+// Pause after the module changed its baud rate before the next command is sent
+#define HC06_SETTLE_TIME_MS       100
+
+// Longest time HC06_Autoconfigure blocks the boot, whatever the module does.
+// Without a budget, a module that never answers (a controller is already connected) is
+// probed at every rate, and each failed rate change probes again, which takes several seconds.
+// The ESC arms in the background for ESC_STATE_ARMING_MS meanwhile, so a budget no longer
+// than that does not delay the first drive command (checked in main.c).
+#define HC06_BOOT_BUDGET_MS       3000
+
+// Time needed to move the module to a new rate, check it, and if the check fails, find the
+// module again at the old rate; a change is not started with less of the budget left,
+// so the module is never left at a rate UART1 does not use
+#define HC06_RATE_CHANGE_TIME_MS  ((3 * HC06_RESPONSE_TIMEOUT_MS) + HC06_SETTLE_TIME_MS)
+
+#if HC06_RATE_CHANGE_TIME_MS > HC06_BOOT_BUDGET_MS
+#error "HC06_BOOT_BUDGET_MS is too short to change the baud rate of the module"
+#endif
+
+typedef struct
+{
+	// Baud rate the module answered at during the probe, or 0 if it did not answer
+	uint32_t detected_baud_rate;
+
+	// Baud rate used by UART1 after autoconfiguration
+	uint32_t active_baud_rate;
+
+	// Number of AT commands sent and number of commands that timed out
+	uint32_t commands_sent;
+	uint32_t timeouts;
+
+	// Number of target baud rates that were set but failed the check and were abandoned
+	uint32_t rejected_rates;
+
+	// Time spent in HC06_Autoconfigure (at most HC06_BOOT_BUDGET_MS)
+	uint32_t boot_time_in_ms;
+
+	// Set if HC06_Autoconfigure stopped because HC06_BOOT_BUDGET_MS ran out
+	uint8_t budget_exhausted;
+} HC06_Status;
+
+/**
+ * @brief The HC06_Autoconfigure function moves the HC-06 module to the fastest stable baud rate.
+ *
+ * This function probes the module's current baud rate, then tries the rates in
+ * HC06_TARGET_BAUD_RATES from fastest to slowest. A rate is kept if the module answers
+ * "OK" at that rate without any UART receive error. If it does not, the module is looked for
+ * at the old rate, and the next slower rate is tried if it is still there; if it is not,
+ * it did move and the new rate is kept. UART1_Set_Baud_Rate reprograms the
+ * baud rate divisors from SYSTEM_CLOCK_HZ at each step.
+ *
+ * If the module does not answer at any rate (for example, because a controller is already
+ * connected, or the module is not fitted), UART1 is set back to UART1_DEFAULT_BAUD_RATE
+ * and the module is left unchanged.
+ *
+ * This function blocks for at most HC06_BOOT_BUDGET_MS (plus the time to queue one command).
+ * When the budget runs out, the probe stops and the last rate the module answered at is kept,
+ * or UART1_DEFAULT_BAUD_RATE if it did not answer. After the first boot, the module is
+ * already at 115200 bps, so the first probe succeeds and no rate change is needed.
+ * It must be called after UART1_Init and before the main loop starts reading UART1.
+ *
+ * @param None
+ *
+ * @return uint32_t The baud rate used by UART1 when the function returns.
+ */
+uint32_t HC06_Autoconfigure(void);
+
+/**
+ * @brief The HC06_Get_Status function reads the result of the last autoconfiguration.
+ *
+ * @param status A pointer to the structure that receives the status.
+ *
+ * @return None
+ */
+void HC06_Get_Status(HC06_Status *status);
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file Latency.c
+ *
+ * @brief Source code for the Latency driver.
+ *
+ * This file contains the function definitions for the Latency driver.
+ * It keeps fixed-bucket latency histograms in RAM and packs them into
+ * PROTOCOL_MSG_HISTOGRAM payloads for the controller.
+ *
+ * @author
+ */
+
+#include "Latency.h"
+
+typedef struct
+{
+	uint32_t buckets[PROTOCOL_HISTOGRAM_BUCKETS];
+	uint32_t count;
+	uint32_t max_in_us;
+} Latency_Histogram;
+
+static Latency_Histogram latency_histograms[PROTOCOL_HISTOGRAM_COUNT];
+
+void Latency_Init(void)
+{
+	for (uint8_t i = 0; i < PROTOCOL_HISTOGRAM_COUNT; i++)
+	{
+		Latency_Reset(i);
+	}
+}
+
+void Latency_Record(uint8_t histogram_id, uint32_t value_in_us)
+{
+	if (histogram_id >= PROTOCOL_HISTOGRAM_COUNT)
+	{
+		return;
+	}
+
+	Latency_Histogram *histogram = &latency_histograms[histogram_id];
+
+	histogram->buckets[Protocol_Histogram_Bucket(value_in_us)]++;
+	histogram->count++;
+
+	if (value_in_us > histogram->max_in_us)
+	{
+		histogram->max_in_us = value_in_us;
+	}
+}
+
+void Latency_Reset(uint8_t histogram_id)
+{
+	if (histogram_id >= PROTOCOL_HISTOGRAM_COUNT)
+	{
+		return;
+	}
+
+	Latency_Histogram empty_histogram = {0};
+	latency_histograms[histogram_id] = empty_histogram;
+}
+
+uint32_t Latency_Pack_Histogram(uint8_t histogram_id, uint8_t first_bucket, uint8_t *payload)
+{
+	if ((histogram_id >= PROTOCOL_HISTOGRAM_COUNT) || (first_bucket >= PROTOCOL_HISTOGRAM_BUCKETS))
+	{
+		return 0;
+	}
+
+	const Latency_Histogram *histogram = &latency_histograms[histogram_id];
+
+	payload[0] = histogram_id;
+	payload[1] = first_bucket;
+
+	uint32_t length = 3;
+	length += Protocol_Put_Varint(histogram->count, &payload[length]);
+	length += Protocol_Put_Varint(histogram->max_in_us, &payload[length]);
+
+	// Add buckets while a worst-case varint still fits
+	uint32_t bucket = first_bucket;
+	while ((bucket < PROTOCOL_HISTOGRAM_BUCKETS) && ((length + PROTOCOL_MAX_VARINT_SIZE) <= PROTOCOL_MAX_PAYLOAD_SIZE))
+	{
+		length += Protocol_Put_Varint(histogram->buckets[bucket], &payload[length]);
+		bucket = bucket + 1;
+	}
+
+	payload[2] = (uint8_t)(bucket - first_bucket);
+
+	return length;
+}
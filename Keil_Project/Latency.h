@@ -0,0 +1,68 @@
+/**
+ * @file Latency.h
+ *
+ * @brief Header file for the Latency driver.
+ *
+ * This file contains the function definitions for the Latency driver.
+ * It keeps fixed-bucket latency histograms in RAM (see Protocol_Histogram_Bucket for
+ * the bucket layout), one for each of the Protocol_Histogram_Ids. The controller reads
+ * them over the link with PROTOCOL_MSG_HISTOGRAM_REQUEST, so the latency of different
+ * baud rates, parsers, and schedulers can be compared on the real car.
+ *
+ * The histograms are only updated and read from the main loop.
+ *
+ * @author
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "TM4C123GH6PM.h"
+#include "Protocol.h"
+
+/**
+ * @brief The Latency_Init function clears every histogram.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Latency_Init(void);
+
+/**
+ * @brief The Latency_Record function adds a sample to a histogram.
+ *
+ * @param histogram_id One of the Protocol_Histogram_Ids.
+ *
+ * @param value_in_us The latency in microseconds.
+ *
+ * @return None
+ */
+void Latency_Record(uint8_t histogram_id, uint32_t value_in_us);
+
+/**
+ * @brief The Latency_Reset function clears one histogram.
+ *
+ * @param histogram_id One of the Protocol_Histogram_Ids.
+ *
+ * @return None
+ */
+void Latency_Reset(uint8_t histogram_id);
+
+/**
+ * @brief The Latency_Pack_Histogram function writes a PROTOCOL_MSG_HISTOGRAM payload.
+ *
+ * The payload holds as many buckets as fit, starting with first_bucket. The controller
+ * requests the next part with the first bucket that was not included.
+ *
+ * @param histogram_id One of the Protocol_Histogram_Ids.
+ *
+ * @param first_bucket The first bucket to include.
+ *
+ * @param payload A pointer to a buffer of at least PROTOCOL_MAX_PAYLOAD_SIZE bytes.
+ *
+ * @return uint32_t The payload length, or 0 if the histogram ID or the first bucket is not valid.
+ */
+uint32_t Latency_Pack_Histogram(uint8_t histogram_id, uint8_t first_bucket, uint8_t *payload);
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @file Link_Supervisor.c
+ *
+ * @brief Source code for the Link_Supervisor driver.
+ *
+ * This file contains the function definitions for the Link_Supervisor driver.
+ * It stops the car when the Bluetooth link is lost by ramping the ESC to neutral
+ * from a periodic Timer 0A interrupt, and keeps link-quality statistics.
+ *
+ * @author
+ */
+
+#include "Link_Supervisor.h"
+
+// Timer Interrupt Mask (IMR) and Interrupt Clear (ICR) bit for the Timer A time-out
+#define TIMER_TATO 0x01
+
+// Upper bounds of the gap histogram buckets in milliseconds (the last bucket has no bound)
+static const uint32_t gap_bucket_limits_ms[LINK_SUPERVISOR_GAP_BUCKETS - 1] =
+{
+	10, 20, 50, 100, 200, 500, 1000
+};
+
+static uint32_t supervisor_timeout_ms = LINK_SUPERVISOR_TIMEOUT_MS;
+static uint32_t supervisor_ramp_ms = LINK_SUPERVISOR_RAMP_MS;
+static uint32_t supervisor_start_ms = 0;
+
+// Written only by the main loop
+static volatile uint32_t last_frame_ms = 0;
+static uint8_t frame_seen = 0;
+
+// Written only by TIMER0A_Handler
+static volatile uint8_t failsafe_active = 1;
+static uint8_t link_was_up = 0;
+static uint8_t ramp_done = 0;
+static uint32_t failsafe_start_ms = 0;
+static uint32_t ramp_start_value = ESC_NEUTRAL_VAL;
+
+static volatile Link_Supervisor_Stats supervisor_stats;
+
+void Link_Supervisor_Init(uint32_t timeout_in_ms, uint32_t ramp_in_ms)
+{
+	supervisor_timeout_ms = timeout_in_ms;
+	supervisor_ramp_ms = ramp_in_ms;
+	supervisor_start_ms = SysTick_Now_ms();
+
+	last_frame_ms = supervisor_start_ms;
+	frame_seen = 0;
+
+	// Start in the failsafe state with the throttle already at neutral
+	failsafe_active = 1;
+	link_was_up = 0;
+	ramp_done = 1;
+	failsafe_start_ms = supervisor_start_ms;
+
+	Link_Supervisor_Stats empty_stats = {0};
+	supervisor_stats = empty_stats;
+
+	// Enable the clock to Timer 0 and wait until it is ready to be accessed
+	SYSCTL->RCGCTIMER |= 0x01;
+	while ((SYSCTL->PRTIMER & 0x01) == 0);
+
+	// Disable Timer 0A before configuration
+	TIMER0->CTL &= ~0x01;
+
+	// Use the 32-bit timer configuration in periodic mode (TAMR = 0x2)
+	TIMER0->CFG = 0x0;
+	TIMER0->TAMR = 0x2;
+
+	TIMER0->TAILR = (SYSTEM_CLOCK_HZ / LINK_SUPERVISOR_TICK_HZ) - 1;
+
+	// Clear and enable the time-out interrupt
+	TIMER0->ICR = TIMER_TATO;
+	TIMER0->IMR |= TIMER_TATO;
+
+	NVIC_SetPriority(TIMER0A_IRQn, LINK_SUPERVISOR_INTERRUPT_PRIORITY);
+	NVIC_EnableIRQ(TIMER0A_IRQn);
+
+	// Enable Timer 0A
+	TIMER0->CTL |= 0x01;
+}
+
+void Link_Supervisor_Frame_Received(void)
+{
+	uint32_t now_ms = SysTick_Now_ms();
+
+	if (frame_seen)
+	{
+		uint32_t gap_ms = now_ms - last_frame_ms;
+		uint32_t bucket = 0;
+
+		while ((bucket < (LINK_SUPERVISOR_GAP_BUCKETS - 1)) && (gap_ms >= gap_bucket_limits_ms[bucket]))
+		{
+			bucket = bucket + 1;
+		}
+
+		supervisor_stats.gap_histogram[bucket]++;
+
+		if (gap_ms > supervisor_stats.max_gap_ms)
+		{
+			supervisor_stats.max_gap_ms = gap_ms;
+		}
+	}
+
+	frame_seen = 1;
+	last_frame_ms = now_ms;
+}
+
+uint8_t Link_Supervisor_Is_Failsafe(void)
+{
+	return failsafe_active;
+}
+
+void Link_Supervisor_Get_Stats(Link_Supervisor_Stats *stats)
+{
+	uint32_t uptime_ms = SysTick_Now_ms() - supervisor_start_ms;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	*stats = supervisor_stats;
+
+	__set_PRIMASK(primask);
+
+	if (uptime_ms != 0)
+	{
+		stats->loss_rate_permille = (uint32_t)(((uint64_t)stats->time_lost_ms * 1000) / uptime_ms);
+	}
+}
+
+static void Link_Supervisor_Check(void)
+{
+	uint32_t now_ms = SysTick_Now_ms();
+	uint32_t frame_ms = last_frame_ms;
+	uint32_t age_ms = now_ms - frame_ms;
+
+	if (!failsafe_active)
+	{
+		if (age_ms <= supervisor_timeout_ms)
+		{
+			return;
+		}
+
+		// Link lost: start the ramp from the throttle value that is applied now
+		failsafe_active = 1;
+		link_was_up = 1;
+		ramp_done = 0;
+		failsafe_start_ms = now_ms;
+		ramp_start_value = ESC_CMP_REGISTER;
+		supervisor_stats.loss_count++;
+	}
+
+	// A valid frame arrived after the failsafe started: the link is restored
+	if ((int32_t)(frame_ms - failsafe_start_ms) > 0)
+	{
+		failsafe_active = 0;
+
+		if (link_was_up)
+		{
+			uint32_t recovery_ms = frame_ms - failsafe_start_ms;
+
+			supervisor_stats.time_lost_ms += recovery_ms;
+			supervisor_stats.recovery_count++;
+			supervisor_stats.last_recovery_ms = recovery_ms;
+
+			if (recovery_ms > supervisor_stats.max_recovery_ms)
+			{
+				supervisor_stats.max_recovery_ms = recovery_ms;
+			}
+		}
+		return;
+	}
+
+	if (ramp_done)
+	{
+		return;
+	}
+
+	uint32_t elapsed_ms = now_ms - failsafe_start_ms;
+
+	if (elapsed_ms >= supervisor_ramp_ms)
+	{
+		ESC_Set_Speed(ESC_NEUTRAL_VAL);
+		ramp_done = 1;
+
+		if (age_ms > supervisor_stats.max_neutral_latency_ms)
+		{
+			supervisor_stats.max_neutral_latency_ms = age_ms;
+		}
+		return;
+	}
+
+	int32_t span = (int32_t)ESC_NEUTRAL_VAL - (int32_t)ramp_start_value;
+	ESC_Set_Speed((uint32_t)((int32_t)ramp_start_value + ((span * (int32_t)elapsed_ms) / (int32_t)supervisor_ramp_ms)));
+}
+
+void TIMER0A_Handler(void)
+{
+	EVENT_TRACE_ENTER(EVENT_TRACE_TIMER0A);
+	PROFILE_BEGIN(PROFILE_TIMER0A_HANDLER);
+
+	TIMER0->ICR = TIMER_TATO;
+	Link_Supervisor_Check();
+
+	PROFILE_END(PROFILE_TIMER0A_HANDLER);
+	EVENT_TRACE_EXIT(EVENT_TRACE_TIMER0A);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file Link_Supervisor.h
+ *
+ * @brief Header file for the Link_Supervisor driver.
+ *
+ * This file contains the function definitions for the Link_Supervisor driver.
+ * It stops the car when the Bluetooth link is lost. The command receiver timestamps
+ * every valid frame, and a periodic Timer 0A interrupt checks the age of the last frame.
+ * When no valid frame has arrived for the timeout, the interrupt ramps the ESC compare
+ * value (CMPA) linearly to neutral (ESC_NEUTRAL_VAL) over the ramp time, so the throttle
+ * is neutral at most timeout + ramp + one tick after the last valid frame.
+ *
+ * The check runs in an interrupt so that it still works if the main loop stalls: frames are
+ * only timestamped after the main loop has decoded them, so a stalled main loop looks
+ * exactly like a lost link.
+ *
+ * The link is considered restored as soon as a valid frame arrives again. The supervisor
+ * also keeps link-quality statistics: a histogram of the gaps between valid frames,
+ * the number and total duration of link losses, and the time each loss took to recover.
+ *
+ * @author
+ */
+
+#ifndef LINK_SUPERVISOR_H
+#define LINK_SUPERVISOR_H
+
+#include "TM4C123GH6PM.h"
+#include "System_Clock.h"
+#include "SysTick_Delay.h"
+#include "PWM.h"
+#include "Profile.h"
+#include "Event_Trace.h"
+
+// Default time without a valid frame before the failsafe starts
+#define LINK_SUPERVISOR_TIMEOUT_MS      50
+
+// Default time taken to ramp the throttle from its last value to neutral
+#define LINK_SUPERVISOR_RAMP_MS         40
+
+// Rate of the Timer 0A supervision interrupt
+#define LINK_SUPERVISOR_TICK_HZ         1000
+
+#if (SYSTEM_CLOCK_HZ % LINK_SUPERVISOR_TICK_HZ) != 0
+#error "SYSTEM_CLOCK_HZ must be a multiple of LINK_SUPERVISOR_TICK_HZ"
+#endif
+
+// NVIC priority of the Timer 0A interrupt (above UART1 so that traffic cannot delay it)
+#define LINK_SUPERVISOR_INTERRUPT_PRIORITY 1
+
+// Number of buckets in the gap histogram
+#define LINK_SUPERVISOR_GAP_BUCKETS     8
+
+#if (LINK_SUPERVISOR_TIMEOUT_MS + LINK_SUPERVISOR_RAMP_MS + (1000 / LINK_SUPERVISOR_TICK_HZ)) >= 100
+#error "The default failsafe must reach neutral throttle within 100 ms of the last valid frame"
+#endif
+
+typedef struct
+{
+	// Number of gaps between consecutive valid frames that fell in each bucket
+	// Upper bounds: 10, 20, 50, 100, 200, 500, 1000 ms, and above
+	uint32_t gap_histogram[LINK_SUPERVISOR_GAP_BUCKETS];
+
+	// Longest gap between consecutive valid frames in milliseconds
+	uint32_t max_gap_ms;
+
+	// Number of times the failsafe started after the link had been up
+	uint32_t loss_count;
+
+	// Total time spent in the failsafe after the link had been up, in milliseconds
+	uint32_t time_lost_ms;
+
+	// Fraction of the time since boot spent in the failsafe, in thousandths
+	uint32_t loss_rate_permille;
+
+	// Time from the start of the failsafe until the next valid frame, in milliseconds
+	uint32_t recovery_count;
+	uint32_t last_recovery_ms;
+	uint32_t max_recovery_ms;
+
+	// Longest time from the last valid frame until the throttle reached neutral, in milliseconds
+	uint32_t max_neutral_latency_ms;
+} Link_Supervisor_Stats;
+
+/**
+ * @brief The Link_Supervisor_Init function starts the link supervision interrupt.
+ *
+ * This function configures Timer 0A as a periodic timer at LINK_SUPERVISOR_TICK_HZ.
+ * The link starts in the failsafe state until the first valid frame arrives.
+ * PWM_Init must be called before this function.
+ *
+ * @param timeout_in_ms The time without a valid frame before the failsafe starts.
+ *
+ * @param ramp_in_ms The time taken to ramp the throttle to neutral.
+ *
+ * @return None
+ */
+void Link_Supervisor_Init(uint32_t timeout_in_ms, uint32_t ramp_in_ms);
+
+/**
+ * @brief The Link_Supervisor_Frame_Received function records the arrival of a valid frame.
+ *
+ * This function must be called from the main loop for every frame that passes the checks.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Link_Supervisor_Frame_Received(void);
+
+/**
+ * @brief The Link_Supervisor_Is_Failsafe function returns whether the failsafe is active.
+ *
+ * While the failsafe is active, the control loop must not write the throttle.
+ *
+ * @param None
+ *
+ * @return uint8_t 1 if the link is lost and the throttle is being held at neutral, 0 otherwise.
+ */
+uint8_t Link_Supervisor_Is_Failsafe(void);
+
+/**
+ * @brief The Link_Supervisor_Get_Stats function reads the link-quality statistics.
+ *
+ * @param stats A pointer to the structure that receives the statistics.
+ *
+ * @return None
+ */
+void Link_Supervisor_Get_Stats(Link_Supervisor_Stats *stats);
+
+/**
+ * @brief The TIMER0A_Handler function is the interrupt service routine for Timer 0A.
+ *
+ * This function compares the age of the last valid frame with the timeout, starts or
+ * ends the failsafe, and moves the throttle one step along the ramp to neutral.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void TIMER0A_Handler(void);
+
+#endif
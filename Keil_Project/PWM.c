@@ -4,55 +4,562 @@
 
 #include "PWM.h"
 
+// Throttle slew limiter (compare values of Comparator A)
+// esc_target is the value the throttle ramps toward, esc_requested is the last value
+// written to CMPA, and esc_applied is the value that drives the output in this period
+static volatile uint32_t esc_target = ESC_NEUTRAL_VAL;
+static volatile uint32_t esc_requested = ESC_NEUTRAL_VAL;
+static volatile uint32_t esc_applied = ESC_NEUTRAL_VAL;
+
+// Largest change of the compare value per period, away from and toward neutral (0 = no limit)
+static uint32_t esc_accelerate_step = 0;
+static uint32_t esc_brake_step = 0;
+
+// Emergency stop: set by PMW0_FAULT_Handler, cleared when PWM_Fault_Update re-arms the outputs
+static volatile uint8_t pwm_fault_active = 0;
+static uint32_t pwm_fault_count = 0;
+
+// Software stop: set by PWM_Fault_Trigger, cleared only by PWM_Fault_Clear
+static volatile uint8_t pwm_software_stop = 0;
+
+// Set by PWM_Fault_Update at the first call that sees the stop released, at pwm_fault_release_ms,
+// and cleared whenever the stop is seen again
+static volatile uint8_t pwm_fault_released = 0;
+static uint32_t pwm_fault_release_ms = 0;
+
 void PWM_Init(void)
 {
+    PROFILE_BEGIN(PROFILE_PWM_INIT);
+
     // 1. Enable Clocks
     SYSCTL->RCGCPWM |= 0x01;       // Enable PWM Module 0
     SYSCTL->RCGCGPIO |= 0x02;      // Enable Port B
     
     // Delay for clock stabilization
 
-    // 2. Configure PWM Clock Divider to /64
-    // System is 80MHz. Max PWM counter speed is usually best around 1-2MHz.
-    // 80MHz / 64 = 1.25MHz. This is perfect.
-    // Bit 20 = 1 (Enable Div), Bits 19:17 = 0x7 (/64)
-    SYSCTL->RCC |= 0x001E0000;
+    // 2. Configure PWM Clock Divider (PWM_CLOCK_DIVIDER, see PWM.h)
+    // System is 50MHz. 50MHz / 64 = 781.25kHz, so a 10ms period fits the 16-bit counter.
+    // (OneShot125: 50MHz / 4 = 12.5MHz, for 0.64us steps of the 1.0 to 2.0 ms equivalent range)
+    // Bit 20 = 1 (Enable Div), Bits 19:17 = PWMDIV
+    SYSCTL->RCC = (SYSCTL->RCC & ~0x000E0000) | 0x00100000 | (PWM_RCC_PWMDIV << 17);
 
+#if PWM_SERVO_GENERATOR == 0
     // 3. Configure PB6 and PB7 Pins
     GPIOB->AFSEL |= 0xC0;          // Enable Alt Function (Pins 6,7)
     GPIOB->PCTL &= ~0xFF000000;    // Clear PCTL
     GPIOB->PCTL |= 0x44000000;     // Set M0PWM0 and M0PWM1
     GPIOB->DEN |= 0xC0;            // Enable Digital
+#else
+    // 3. Configure PB6 (the servo pin is configured with its generator below)
+    GPIOB->AFSEL |= 0x40;          // Enable Alt Function (Pin 6)
+    GPIOB->PCTL &= ~0x0F000000;    // Clear PCTL
+    GPIOB->PCTL |= 0x04000000;     // Set M0PWM0
+    GPIOB->DEN |= 0x40;            // Enable Digital
+#endif
 
     // 4. Configure Generator 0 (Controls PB6 & PB7)
     PWM0->_0_CTL &= ~0x01;         // Disable Generator 0 first
 
+    // Globally synchronized compare updates (CMPAUPD, CMPBUPD): new compare values are held
+    // until a synchronous update is requested, then both are applied when the counter reaches 0
+    PWM0->_0_CTL |= 0x30;
+
     // Configure Count-Down Mode:
     // Drive High on Load, Drive Low on Compare Match
     PWM0->_0_GENA = 0x0000008C;    // For PB6 (Motor)
+#if PWM_SERVO_GENERATOR == 0
     PWM0->_0_GENB = 0x0000080C;    // For PB7 (Servo)
+#endif
     
-    // 5. Set Period and Initial Positions (Using 100Hz values)
-    PWM0->_0_LOAD = SERVO_LOAD_VAL;    // 10ms Period
+    // 5. Set Period and Initial Positions (Using 100Hz values, or 500Hz with OneShot125 when no write restarts it)
+    PWM0->_0_LOAD = PWM_LOAD_VALUE;    // PWM_PERIOD_US (10ms, or 2ms with OneShot125) Period
     
     // Set both to Neutral/Stop initially
-    PWM0->_0_CMPA = SERVO_CENTER_VAL;
-    PWM0->_0_CMPB = SERVO_CENTER_VAL;
+    ESC_CMP_REGISTER = ESC_NEUTRAL_VAL;
+    SERVO_CMP_REGISTER = SERVO_CENTER_VAL;
+    PWM0->CTL |= 0x01 | SERVO_GLOBALSYNC;  // Request the update of the generators (GLOBALSYNCn)
 
-    // 6. Enable Generator and Outputs
-    PWM0->_0_CTL |= 0x01;          // Enable Generator 0
+    esc_target = ESC_NEUTRAL_VAL;
+    esc_requested = ESC_NEUTRAL_VAL;
+    esc_applied = ESC_NEUTRAL_VAL;
+    ESC_Set_Slew_Rate(ESC_ACCELERATE_US_PER_S, ESC_BRAKE_US_PER_S);
+
+    // Emergency stop input (see PWM.h): PD6 as M0FAULT0, pulled up
+    SYSCTL->RCGCGPIO |= 0x08;      // Enable Port D
+    GPIOD->DIR &= ~0x40;
+    GPIOD->PUR |= 0x40;
+    GPIOD->AFSEL |= 0x40;
+    GPIOD->PCTL = (GPIOD->PCTL & ~0x0F000000) | 0x04000000;
+    GPIOD->DEN |= 0x40;
+
+    PWM0->_0_CTL |= 0x00040000;    // Latch the fault input (LATCH), until PWM_Fault_Update clears it
+    PWM0->_0_FLTSEN = 0x01;        // Fault0 is active low
+    PWM0->FAULTVAL &= ~PWM_OUTPUTS;  // Drive both outputs low on a fault
+    PWM0->FAULT |= PWM_OUTPUTS;
+
+    pwm_fault_active = 0;
+    pwm_software_stop = 0;
+    PWM0->ISC = 0x00010000;        // Clear INTFAULT0
+    PWM0->INTEN |= 0x00010000;     // Interrupt on Fault0 (INTFAULT0)
+    NVIC_SetPriority(PWM0_FAULT_IRQn, PWM0_FAULT_INTERRUPT_PRIORITY);
+    NVIC_EnableIRQ(PWM0_FAULT_IRQn);
+
+    // Interrupt on the LOAD event (INTCNTLOAD), where each new pulse starts
+    PWM0->_0_INTEN = 0x02;
+    PWM0->INTEN |= 0x01;           // Route Generator 0 to its interrupt
+    NVIC_SetPriority(PWM0_0_IRQn, PWM0_0_INTERRUPT_PRIORITY);
+    NVIC_EnableIRQ(PWM0_0_IRQn);
+
+#if PWM_SERVO_GENERATOR == 0
+    // 6. Enable Outputs and Generator
+    // The outputs are enabled first, so the first pulse is not cut short
     PWM0->ENABLE |= 0x03;          // Enable Output 0 (PB6) and 1 (PB7)
+    PWM0->_0_CTL |= 0x01;          // Enable Generator 0
+#else
+    // 6. Configure the servo generator: same count-down mode on output A, at SERVO_PERIOD_US
+    SYSCTL->RCGCGPIO |= SERVO_GPIO_CLOCK;
+    SERVO_GPIO->AFSEL |= SERVO_PIN;
+    SERVO_GPIO->PCTL = (SERVO_GPIO->PCTL & ~SERVO_PCTL_MASK) | SERVO_PCTL_VALUE;
+    SERVO_GPIO->DEN |= SERVO_PIN;
+
+    SERVO_GEN_CTL &= ~0x01;        // Disable the generator first
+    SERVO_GEN_CTL |= 0x10;         // Globally synchronized CMPA updates (CMPAUPD)
+    SERVO_GEN_CTL |= 0x00040000;   // Latch the fault input (LATCH)
+    SERVO_GEN_FLTSEN = 0x01;       // Fault0 is active low
+    SERVO_GEN_GENA = 0x0000008C;   // Drive High on Load, Drive Low on Compare A Match
+    SERVO_GEN_LOAD = SERVO_LOAD_VAL;
+
+    // 7. Enable Outputs and Generators
+    // The outputs are enabled first, so the first pulses are not cut short
+    PWM0->ENABLE |= 0x01 | SERVO_OUTPUT_ENABLE;  // Enable Output 0 (PB6) and the servo output
+    PWM0->_0_CTL |= 0x01;          // Enable Generator 0
+    SERVO_GEN_CTL |= 0x01;         // Enable the servo generator
+#endif
+
+    PROFILE_END(PROFILE_PWM_INIT);
+}
+
+#if PWM0_PHASE_RESET || SERVO_PHASE_RESET
+// Restarts the periods of generator 0 and, if with_servo is 1, of the servo generator (see PWM.h)
+// Called with interrupts masked, once the update of the compare values has been requested
+static void PWM_Phase_Reset(uint8_t with_servo)
+{
+    uint32_t generators = 0;
+    uint32_t count;
+
+#if PWM0_PHASE_RESET
+    count = PWM0->_0_COUNT;
+
+    if ((count <= PWM0_PHASE_RESET_COUNT) && (count >= PWM_PHASE_RESET_GUARD_TICKS))
+    {
+        generators |= 0x01;        // SYNC0
+    }
+#endif
+
+#if SERVO_PHASE_RESET
+    count = SERVO_GEN_COUNT;
+
+    if (with_servo && (count <= SERVO_PHASE_RESET_COUNT) && (count >= PWM_PHASE_RESET_GUARD_TICKS))
+    {
+        generators |= SERVO_GLOBALSYNC;  // SYNCn has the bit of GLOBALSYNCn
+    }
+#else
+    (void)with_servo;
+#endif
+
+    if (generators != 0)
+    {
+        PWM0->SYNC = generators;
+    }
 }
+#endif
 
+// The compare registers are globally synchronized, so a write is held until GLOBALSYNCn is set.
+// Interrupts are masked from the first write to the request, so that the link supervisor
+// (Timer 0A) cannot request the update of a half-written pair of compare values.
 void ESC_Set_Speed(uint32_t value)
 {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
     // Write new match value to Comparator A (Datasheet p. 1278)
-    PWM0->_0_CMPA = value;
+    ESC_CMP_REGISTER = value;
+    PWM0->CTL |= 0x01;             // Apply it at the end of the current period (GLOBALSYNC0)
+
+#if ESC_SIGNAL_MODE == ESC_SIGNAL_ONESHOT125
+    // Or right now: OneShot125 sends a pulse after each write
+    PWM_Phase_Reset(0);
+#endif
+
+    // Not slew limited: the target is reached at once and any ramp in progress stops
+    esc_target = value;
+    esc_requested = value;
+
+    __set_PRIMASK(primask);
+
+    EVENT_TRACE(EVENT_TRACE_PWM_UPDATE, EVENT_TRACE_CHANNEL_ESC, (uint16_t)value);
 }
 
 // Helper function to update just the Servo (PB7 / CMPB)
 void Servo_Set_Angle_Value(uint32_t value)
 {
-    // Write new match value to Comparator B (Datasheet p. 1279)
-    PWM0->_0_CMPB = value;
-}
\ No newline at end of file
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // Write new match value to the servo comparator (Comparator B of Generator 0 by default, Datasheet p. 1279)
+    SERVO_CMP_REGISTER = value;
+    PWM0->CTL |= SERVO_GLOBALSYNC; // Apply it at the end of the current period (GLOBALSYNCn)
+
+    __set_PRIMASK(primask);
+
+    EVENT_TRACE(EVENT_TRACE_PWM_UPDATE, EVENT_TRACE_CHANNEL_SERVO, (uint16_t)value);
+}
+
+// Updates both channels so that they change in the same period
+void PWM_Set_Outputs(uint32_t esc_value, uint32_t servo_value)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    ESC_CMP_REGISTER = esc_value;
+    SERVO_CMP_REGISTER = servo_value;
+    PWM0->CTL |= 0x01 | SERVO_GLOBALSYNC;  // Apply both at the end of the current period (GLOBALSYNCn)
+
+#if ESC_SIGNAL_MODE == ESC_SIGNAL_ONESHOT125
+    // Or right now for the ESC: OneShot125 sends a pulse after each write
+    PWM_Phase_Reset(0);
+#endif
+
+    esc_target = esc_value;
+    esc_requested = esc_value;
+
+    __set_PRIMASK(primask);
+
+    EVENT_TRACE(EVENT_TRACE_PWM_UPDATE, EVENT_TRACE_CHANNEL_ESC, (uint16_t)esc_value);
+    EVENT_TRACE(EVENT_TRACE_PWM_UPDATE, EVENT_TRACE_CHANNEL_SERVO, (uint16_t)servo_value);
+}
+
+// The hardware clears GLOBALSYNCn once the held compare values have been applied
+uint8_t PWM_Update_Pending(void)
+{
+    return (PWM0->CTL & (0x01 | SERVO_GLOBALSYNC)) != 0;
+}
+
+// Maps a normalized setpoint (-1000 to +1000) linearly onto a compare value,
+// using separate spans for the negative and positive halves
+static uint32_t PWM_Map_Setpoint(int16_t setpoint, uint32_t negative_val, uint32_t center_val, uint32_t positive_val)
+{
+    int32_t value = setpoint;
+
+    if (value > SETPOINT_FULL_SCALE) value = SETPOINT_FULL_SCALE;
+    if (value < -SETPOINT_FULL_SCALE) value = -SETPOINT_FULL_SCALE;
+
+    if (value >= 0)
+    {
+        return (uint32_t)((int32_t)center_val + ((value * ((int32_t)positive_val - (int32_t)center_val)) / SETPOINT_FULL_SCALE));
+    }
+
+    return (uint32_t)((int32_t)center_val + ((-value * ((int32_t)negative_val - (int32_t)center_val)) / SETPOINT_FULL_SCALE));
+}
+
+// Converts a slew rate in microseconds of pulse width per second to compare ticks per ESC pulse
+// (microseconds of the standard signal, which OneShot125 divides by ESC_PULSE_DIVIDER)
+static uint32_t ESC_Rate_To_Step(uint32_t rate_in_us_per_s)
+{
+    if (rate_in_us_per_s == 0)
+    {
+        return 0;
+    }
+
+    uint64_t step_q16 = ((uint64_t)rate_in_us_per_s * ESC_FRAME_US * PWM_TICKS_PER_US_Q16) / (1000000ULL * ESC_PULSE_DIVIDER);
+    uint32_t step = (uint32_t)((step_q16 + 0x8000) >> 16);
+
+    return (step != 0) ? step : 1;
+}
+
+void ESC_Set_Slew_Rate(uint32_t accelerate_in_us_per_s, uint32_t brake_in_us_per_s)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    esc_accelerate_step = ESC_Rate_To_Step(accelerate_in_us_per_s);
+    esc_brake_step = ESC_Rate_To_Step(brake_in_us_per_s);
+
+    __set_PRIMASK(primask);
+}
+
+// Returns the compare value one period after current_value on the way to target_value.
+// Moving away from neutral uses the accelerate step and moving toward it the brake step.
+// When the direction reverses, the throttle brakes down to neutral before accelerating again.
+static uint32_t ESC_Slew_Step(uint32_t current_value, uint32_t target_value)
+{
+    // Offsets from neutral, positive forward (forward pulses have lower compare values)
+    int32_t current = (int32_t)ESC_NEUTRAL_VAL - (int32_t)current_value;
+    int32_t target = (int32_t)ESC_NEUTRAL_VAL - (int32_t)target_value;
+    int32_t limit = target;
+    int32_t step = (int32_t)esc_accelerate_step;
+
+    if (((current > 0) && (target < current)) || ((current < 0) && (target > current)))
+    {
+        step = (int32_t)esc_brake_step;
+
+        if (((current > 0) && (target < 0)) || ((current < 0) && (target > 0)))
+        {
+            limit = 0;
+        }
+    }
+
+    if (step == 0)
+    {
+        return target_value;
+    }
+
+    if (limit > current)
+    {
+        current = ((limit - current) > step) ? (current + step) : limit;
+    }
+    else
+    {
+        current = ((current - limit) > step) ? (current - step) : limit;
+    }
+
+    return (uint32_t)((int32_t)ESC_NEUTRAL_VAL - current);
+}
+
+// Sets the throttle target and writes the first step toward it (servo_value is written too unless 0)
+// The following steps are written by PWM0_0_Handler, one per period
+static void ESC_Set_Target(uint32_t esc_value, uint32_t servo_value)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // Every step starts from the value that drives the output in this period, so calling
+    // this function several times in one period never moves more than one step
+    uint32_t next_value = ESC_Slew_Step(esc_applied, esc_value);
+
+    esc_target = esc_value;
+    esc_requested = next_value;
+
+    ESC_CMP_REGISTER = next_value;
+    if (servo_value != 0)
+    {
+        SERVO_CMP_REGISTER = servo_value;
+        PWM0->CTL |= SERVO_GLOBALSYNC;
+    }
+    PWM0->CTL |= 0x01;             // Apply at the end of the current period (GLOBALSYNC0)
+
+#if PWM0_PHASE_RESET || SERVO_PHASE_RESET
+    // Or right now, if the period can be restarted
+    PWM_Phase_Reset(servo_value != 0);
+#endif
+
+    __set_PRIMASK(primask);
+
+    EVENT_TRACE(EVENT_TRACE_PWM_UPDATE, EVENT_TRACE_CHANNEL_ESC, (uint16_t)next_value);
+    if (servo_value != 0)
+    {
+        EVENT_TRACE(EVENT_TRACE_PWM_UPDATE, EVENT_TRACE_CHANNEL_SERVO, (uint16_t)servo_value);
+    }
+}
+
+// Throttle: -1000 = full reverse (1.0 ms), 0 = stop (1.5 ms), +1000 = full forward (2.0 ms)
+// Slew limited (see ESC_Set_Slew_Rate)
+void ESC_Set_Throttle(int16_t throttle)
+{
+    ESC_Set_Target(PWM_Map_Setpoint(throttle, ESC_FULL_REVERSE_VAL, ESC_NEUTRAL_VAL, ESC_FULL_FORWARD_VAL), 0);
+}
+
+// Steering: -1000 = full left, 0 = center, +1000 = full right, through the steering curve (see Steering.h)
+void Servo_Set_Steering(int16_t steering)
+{
+    Servo_Set_Angle_Value(Steering_Map(steering));
+}
+
+// Converts a pulse width to PWM clock ticks with a multiply and a shift (no division)
+static uint32_t PWM_Pulse_us_To_Ticks(uint32_t pulse_in_us)
+{
+    return (pulse_in_us * (uint32_t)PWM_TICKS_PER_US_Q16) >> 16;
+}
+
+// Compare value of the servo generator for a pulse width, clamped to SERVO_MIN_PULSE_US to SERVO_MAX_PULSE_US
+uint32_t Servo_Pulse_us_To_CMP(uint32_t pulse_in_us)
+{
+    if (pulse_in_us < SERVO_MIN_PULSE_US) pulse_in_us = SERVO_MIN_PULSE_US;
+    if (pulse_in_us > SERVO_MAX_PULSE_US) pulse_in_us = SERVO_MAX_PULSE_US;
+
+    return SERVO_LOAD_VAL - PWM_Pulse_us_To_Ticks(pulse_in_us);
+}
+
+// The ESC width is that of the standard signal: OneShot125 sends it divided by ESC_PULSE_DIVIDER,
+// and the width sent is clamped to ESC_MIN_PULSE_US to ESC_MAX_PULSE_US
+void ESC_Set_Pulse_us(uint32_t pulse_in_us)
+{
+    if (pulse_in_us < (ESC_MIN_PULSE_US * ESC_PULSE_DIVIDER)) pulse_in_us = ESC_MIN_PULSE_US * ESC_PULSE_DIVIDER;
+    if (pulse_in_us > (ESC_MAX_PULSE_US * ESC_PULSE_DIVIDER)) pulse_in_us = ESC_MAX_PULSE_US * ESC_PULSE_DIVIDER;
+
+    ESC_Set_Speed(PWM_LOAD_VALUE - (PWM_Pulse_us_To_Ticks(pulse_in_us) / ESC_PULSE_DIVIDER));
+}
+
+void Servo_Set_Pulse_us(uint32_t pulse_in_us)
+{
+    Servo_Set_Angle_Value(Servo_Pulse_us_To_CMP(pulse_in_us));
+}
+
+// Throttle and steering together, applied in the same period (the throttle is slew limited)
+void PWM_Set_Setpoint(int16_t throttle, int16_t steering)
+{
+    ESC_Set_Target(PWM_Map_Setpoint(throttle, ESC_FULL_REVERSE_VAL, ESC_NEUTRAL_VAL, ESC_FULL_FORWARD_VAL),
+                   Steering_Map(steering));
+}
+
+// Generator 0 LOAD event: the compare values written before the last zero now drive the outputs
+void PWM0_0_Handler(void)
+{
+    EVENT_TRACE_ENTER(EVENT_TRACE_PWM0_0);
+    PROFILE_BEGIN(PROFILE_PWM0_0_HANDLER);
+
+    PWM0->_0_ISC = 0x02;           // Clear the LOAD interrupt
+
+    // A compare write that arrived after the counter reached zero is still held for the next period
+    if (!(PWM0->CTL & 0x01))
+    {
+        esc_applied = esc_requested;
+        Tracepoint_PWM_Load();
+
+        // Throttle slew limiter: write the next step toward the target for the next period
+        if (esc_requested != esc_target)
+        {
+            uint32_t next_value = ESC_Slew_Step(esc_applied, esc_target);
+
+            ESC_CMP_REGISTER = next_value;
+            PWM0->CTL |= 0x01;     // GLOBALSYNC0
+            esc_requested = next_value;
+
+            EVENT_TRACE(EVENT_TRACE_PWM_UPDATE, EVENT_TRACE_CHANNEL_ESC, (uint16_t)next_value);
+        }
+    }
+
+    PROFILE_END(PROFILE_PWM0_0_HANDLER);
+    EVENT_TRACE_EXIT(EVENT_TRACE_PWM0_0);
+}
+
+// Drives both outputs low at once (PWMENUPD immediate), whatever the fault latch does
+static void PWM_Outputs_Disable(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    PWM0->ENUPD &= ~PWM_OUTPUTS_ENUPD_MASK;
+    PWM0->ENABLE &= ~PWM_OUTPUTS;
+
+    __set_PRIMASK(primask);
+}
+
+// Emergency stop from software: the same safe state as the fault input, held until PWM_Fault_Clear
+void PWM_Fault_Trigger(void)
+{
+    pwm_software_stop = 1;
+    PWM_Outputs_Disable();
+    NVIC_SetPendingIRQ(PWM0_FAULT_IRQn);
+}
+
+// Releases the software stop; PWM_Fault_Update re-arms the outputs PWM_FAULT_REARM_MS later
+// if the fault input is released too
+void PWM_Fault_Clear(void)
+{
+    pwm_software_stop = 0;
+}
+
+// Re-arms the outputs once the fault input and the software stop have been released for
+// PWM_FAULT_REARM_MS in a row, counted from the first call that sees them released
+// Returns 1 on the call that re-arms them: the ESC, which lost its signal, has to arm again
+uint8_t PWM_Fault_Update(void)
+{
+    if (!pwm_fault_active)
+    {
+        return 0;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // The latch holds any assertion since the last call. Clear it; it sets again at once
+    // if the input is still asserted
+    uint8_t asserted = PWM0->_0_FLTSTAT0 & 0x01;
+    PWM0->_0_FLTSTAT0 = 0x01;
+#if PWM_SERVO_GENERATOR != 0
+    SERVO_GEN_FLTSTAT0 = 0x01;
+#endif
+    asserted |= PWM0->_0_FLTSTAT0 & 0x01;
+
+    if (asserted || pwm_software_stop)
+    {
+        pwm_fault_released = 0;
+        __set_PRIMASK(primask);
+
+        return 0;
+    }
+
+    uint32_t now = SysTick_Now_ms();
+
+    if (!pwm_fault_released)
+    {
+        pwm_fault_released = 1;
+        pwm_fault_release_ms = now;
+    }
+
+    if ((now - pwm_fault_release_ms) < PWM_FAULT_REARM_MS)
+    {
+        __set_PRIMASK(primask);
+
+        return 0;
+    }
+
+    // Restart at neutral, without a ramp
+    ESC_Set_Speed(ESC_NEUTRAL_VAL);
+
+    // Enable the outputs when their counters reach zero, so the first pulse is a whole one
+    PWM0->ENUPD = (PWM0->ENUPD & ~PWM_OUTPUTS_ENUPD_MASK) | PWM_OUTPUTS_ENUPD_SYNC;
+    PWM0->ENABLE |= PWM_OUTPUTS;
+
+    pwm_fault_active = 0;
+    pwm_fault_released = 0;
+    PWM0->ISC = 0x00010000;        // Clear INTFAULT0
+    PWM0->INTEN |= 0x00010000;
+
+    __set_PRIMASK(primask);
+
+    return 1;
+}
+
+uint8_t PWM_Fault_Is_Active(void)
+{
+    return pwm_fault_active;
+}
+
+// Fault0 asserted (the hardware has already driven the outputs low) or PWM_Fault_Trigger
+void PMW0_FAULT_Handler(void)
+{
+    EVENT_TRACE_ENTER(EVENT_TRACE_PWM0_FAULT);
+
+    // Keep the outputs low once the latch is cleared, until PWM_Fault_Update re-arms them
+    PWM_Outputs_Disable();
+
+    pwm_fault_active = 1;
+    pwm_fault_released = 0;
+    pwm_fault_count++;
+
+    // INTFAULT0 is only raised by the input (PWM_Fault_Trigger pends the interrupt)
+    uint8_t source = (PWM0->RIS & 0x00010000) ? EVENT_TRACE_FAULT_INPUT : EVENT_TRACE_FAULT_SOFTWARE;
+
+    EVENT_TRACE(EVENT_TRACE_PWM_FAULT, source, (uint16_t)pwm_fault_count);
+
+    // The control loop resets the ESC state machine from the main loop
+    Executive_Post_Event(EXECUTIVE_EVENT_PWM_FAULT, source);
+
+    // Ignore the input until the re-arm, so that a bouncing switch does not retrigger
+    PWM0->ISC = 0x00010000;        // Clear INTFAULT0
+    PWM0->INTEN &= ~0x00010000;
+
+    EVENT_TRACE_EXIT(EVENT_TRACE_PWM0_FAULT);
+}
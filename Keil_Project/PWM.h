@@ -1,31 +1,332 @@
 #include "TM4C123GH6PM.h"
+#include "System_Clock.h"
 #include "SysTick_Delay.h"
+#include "Tracepoint.h"
+#include "Profile.h"
+#include "Event_Trace.h"
+#include "Executive.h"
+#include "Steering.h"
 
-// --- Constants for 50MHz System Clock @ 50 Hz Output ---
-// PWM Clock = 781,250 Hz
-// Period = 20ms (50 Hz)
-// Load Value = 15,625 - 1 = 15,624 ticks
+// --- ESC Signal ---
+// ESC_SIGNAL_MODE selects the pulses sent to the ESC on PB6:
+//   ESC_SIGNAL_STANDARD:   1.0 to 2.0 ms pulses every 10 ms, understood by every ESC (default)
+//   ESC_SIGNAL_ONESHOT125: a 125 to 250 us pulse right after each throttle write, for ESCs
+//                          that support OneShot125
+// OneShot125 pulses are the standard widths divided by ESC_PULSE_DIVIDER, so throttle values,
+// slew rates, and ESC_Set_Pulse_us keep their standard units. Every write of the ESC compare
+// value restarts generator 0 (PWMSYNC, see Phase Reset), so the pulse with the new value starts
+// at once, and the control task writes the throttle after each update, every ESC_FRAME_US
+// (CONTROL_TASK_PERIOD_US in main.c). A new throttle then reaches the ESC within a few
+// microseconds instead of up to 12 ms. A write made less than ESC_MIN_FRAME_US after the last
+// pulse started waits for the end of the period, and without writes, generator 0 repeats the
+// last pulse every PWM_PERIOD_US, so the ESC keeps its signal if the control loop stops.
+// Generator 0 runs too fast for the servo in this mode, which needs a generator of its own
+// (PWM_SERVO_GENERATOR 1 or 2).
+#define ESC_SIGNAL_STANDARD   0
+#define ESC_SIGNAL_ONESHOT125 1
 
-#define SERVO_LOAD_VAL   7811   // Period (20ms)
+#ifndef ESC_SIGNAL_MODE
+#define ESC_SIGNAL_MODE      ESC_SIGNAL_STANDARD
+#endif
+
+// --- Clock Tree ---
+// Everything below is derived from these definitions. PLL_Init (main.c) configures
+// SYSTEM_CLOCK_HZ (System_Clock.h), and PWM_Init divides it by PWM_CLOCK_DIVIDER for the PWM module.
+#if ESC_SIGNAL_MODE == ESC_SIGNAL_ONESHOT125
+#define PWM_CLOCK_DIVIDER    4          // RCC PWMDIV: 2, 4, 8, 16, 32, or 64 (0.08 us per tick)
+#define PWM_PERIOD_US        2000       // 2 ms (500 Hz) without writes, generator 0 (ESC)
+#define ESC_FRAME_US         1000       // Time between two throttle writes (1 kHz)
+#define ESC_PULSE_DIVIDER    8          // 1.0 to 2.0 ms become 125 to 250 us
+#define ESC_MIN_PULSE_US     125        // Shortest and longest pulses sent to the ESC
+#define ESC_MAX_PULSE_US     250
+#define ESC_MIN_FRAME_US     350        // Shortest time between two pulse starts: the longest pulse and a gap
+#else
+#define PWM_CLOCK_DIVIDER    64         // RCC PWMDIV: 2, 4, 8, 16, 32, or 64 (1.28 us per tick)
+#define PWM_PERIOD_US        10000      // 10 ms (100 Hz), generator 0 (ESC)
+#define ESC_FRAME_US         PWM_PERIOD_US  // Time between two ESC pulses
+#define ESC_PULSE_DIVIDER    1
+#define ESC_MIN_PULSE_US     1000       // Shortest and longest pulses sent to the ESC
+#define ESC_MAX_PULSE_US     2000
+#define ESC_MIN_FRAME_US     3000       // Shortest time between two pulse starts (333 Hz)
+#endif
+#define PWM_CLOCK_HZ         (SYSTEM_CLOCK_HZ / PWM_CLOCK_DIVIDER)   // 781,250 Hz at / 64
+
+// --- Generator and Pin Mapping ---
+// PWM_SERVO_GENERATOR selects the output of the steering servo:
+//   0: PB7 (M0PWM1), generator 0 output B, sharing the period of the ESC on PB6 (default)
+//   1: PB4 (M0PWM2), generator 1 output A, with its own period SERVO_PERIOD_US
+//   2: PE4 (M0PWM4), generator 2 output A, with its own period SERVO_PERIOD_US
+// With a generator of its own, a digital servo can run at 333 Hz, so a steering command
+// waits at most 3 ms for the next pulse instead of 10 ms. The ESC always stays on PB6.
+#ifndef PWM_SERVO_GENERATOR
+#define PWM_SERVO_GENERATOR  0
+#endif
+
+#if PWM_SERVO_GENERATOR == 0
+#define SERVO_PERIOD_US      PWM_PERIOD_US
+#define SERVO_CMP_REGISTER   (PWM0->_0_CMPB)
+#define SERVO_GLOBALSYNC     0x01       // GLOBALSYNC0
+#define SERVO_OUTPUT_ENABLE  0x02       // M0PWM1
+#define SERVO_ENUPD_MASK     0x0000000C // ENUPD1
+#elif PWM_SERVO_GENERATOR == 1
+#define SERVO_PERIOD_US      3000       // 333 Hz (digital servo)
+#define SERVO_GPIO           GPIOB
+#define SERVO_GPIO_CLOCK     0x02       // Port B
+#define SERVO_PIN            0x10       // PB4
+#define SERVO_PCTL_MASK      0x000F0000
+#define SERVO_PCTL_VALUE     0x00040000 // M0PWM2
+#define SERVO_GEN_CTL        (PWM0->_1_CTL)
+#define SERVO_GEN_LOAD       (PWM0->_1_LOAD)
+#define SERVO_GEN_COUNT      (PWM0->_1_COUNT)
+#define SERVO_GEN_GENA       (PWM0->_1_GENA)
+#define SERVO_CMP_REGISTER   (PWM0->_1_CMPA)
+#define SERVO_GEN_FLTSEN     (PWM0->_1_FLTSEN)
+#define SERVO_GEN_FLTSTAT0   (PWM0->_1_FLTSTAT0)
+#define SERVO_GLOBALSYNC     0x02       // GLOBALSYNC1
+#define SERVO_OUTPUT_ENABLE  0x04       // M0PWM2
+#define SERVO_ENUPD_MASK     0x00000030 // ENUPD2
+#elif PWM_SERVO_GENERATOR == 2
+#define SERVO_PERIOD_US      3000       // 333 Hz (digital servo)
+#define SERVO_GPIO           GPIOE
+#define SERVO_GPIO_CLOCK     0x10       // Port E
+#define SERVO_PIN            0x10       // PE4
+#define SERVO_PCTL_MASK      0x000F0000
+#define SERVO_PCTL_VALUE     0x00040000 // M0PWM4
+#define SERVO_GEN_CTL        (PWM0->_2_CTL)
+#define SERVO_GEN_LOAD       (PWM0->_2_LOAD)
+#define SERVO_GEN_COUNT      (PWM0->_2_COUNT)
+#define SERVO_GEN_GENA       (PWM0->_2_GENA)
+#define SERVO_CMP_REGISTER   (PWM0->_2_CMPA)
+#define SERVO_GEN_FLTSEN     (PWM0->_2_FLTSEN)
+#define SERVO_GEN_FLTSTAT0   (PWM0->_2_FLTSTAT0)
+#define SERVO_GLOBALSYNC     0x04       // GLOBALSYNC2
+#define SERVO_OUTPUT_ENABLE  0x10       // M0PWM4
+#define SERVO_ENUPD_MASK     0x00000300 // ENUPD4
+#else
+#error "PWM_SERVO_GENERATOR must be 0, 1, or 2"
+#endif
+
+// The ESC is always Comparator A of generator 0
+#define ESC_CMP_REGISTER     (PWM0->_0_CMPA)
+#define ESC_OUTPUT_ENABLE    0x01       // M0PWM0
+#define ESC_ENUPD_MASK       0x00000003 // ENUPD0
+
+// Both outputs, and their PWMENUPD fields (0x2 in a field: locally synchronized, applied at zero)
+#define PWM_OUTPUTS          (ESC_OUTPUT_ENABLE | SERVO_OUTPUT_ENABLE)
+#define PWM_OUTPUTS_ENUPD_MASK (ESC_ENUPD_MASK | SERVO_ENUPD_MASK)
+#define PWM_OUTPUTS_ENUPD_SYNC (PWM_OUTPUTS_ENUPD_MASK & 0xAAAAAAAA)
+
+// Converts a duration in microseconds to PWM clock ticks (rounded down)
+// Usable in #if, so every constant below is checked at compile time
+#define PWM_US_TO_TICKS(us)  ((((us) + 0ULL) * PWM_CLOCK_HZ) / 1000000ULL)
+
+// Each generator counts down from LOAD to 0, so the period is LOAD + 1 ticks.
+// The output goes high at LOAD and low when the counter matches the compare value,
+// so a pulse of N ticks needs a compare value of LOAD - N.
+#define PWM_LOAD_VALUE       (PWM_US_TO_TICKS(PWM_PERIOD_US) - 1)
+#define ESC_PULSE_US_TO_CMP(us) (PWM_LOAD_VALUE - (PWM_US_TO_TICKS(us) / ESC_PULSE_DIVIDER))
+
+#define SERVO_LOAD_VAL       (PWM_US_TO_TICKS(SERVO_PERIOD_US) - 1)   // Servo period (7811 at 10 ms)
+#define SERVO_PULSE_US_TO_CMP(us) (SERVO_LOAD_VAL - PWM_US_TO_TICKS(us))
+
+// PWM clock ticks per microsecond in 16.16 fixed point, for conversions at run time
+#define PWM_TICKS_PER_US_Q16 ((PWM_CLOCK_HZ * 65536ULL + 500000ULL) / 1000000ULL)
 
 // --- Standard RC Pulse Widths ---
 // 1.5ms is Center. 1.0ms and 2.0ms are standard limits.
-#define SERVO_LEFT_SAFE  7030     // 1.0 ms
-#define SERVO_CENTER_VAL 6640    // 1.5 ms (Neutral)
-#define SERVO_RIGHT_SAFE 6249    // 2.0 ms
+// (Compare values in parentheses are for the default 10 ms servo period)
+#define SERVO_LEFT_SAFE  SERVO_PULSE_US_TO_CMP(1000)   // 1.0 ms (7030)
+#define SERVO_CENTER_VAL SERVO_PULSE_US_TO_CMP(1500)   // 1.5 ms (6640, Neutral)
+#define SERVO_RIGHT_SAFE SERVO_PULSE_US_TO_CMP(2000)   // 2.0 ms (6249)
 
 // --- Extended Range (From Datasheet) ---
 // Only use these if your steering mechanism allows 180 degrees
-#define SERVO_MIN_MAX    391     // 0.5 ms
-#define SERVO_MAX_MAX    13671    // 2.5 ms
+#define SERVO_MIN_PULSE_US 500
+#define SERVO_MAX_PULSE_US 2500
+#define SERVO_MIN_MAX    SERVO_PULSE_US_TO_CMP(SERVO_MIN_PULSE_US)   // 0.5 ms (7421)
+#define SERVO_MAX_MAX    SERVO_PULSE_US_TO_CMP(SERVO_MAX_PULSE_US)   // 2.5 ms (5858)
 
 
-//Main motor (50Hz)
+//Main motor (100Hz)
 //1.5ms (not moving)
 //1ms (reverse)
 //2ms (forward)
+// (Compare values in parentheses are for the standard signal; OneShot125 divides the widths by 8)
+#define ESC_NEUTRAL_VAL      ESC_PULSE_US_TO_CMP(1500)   // 1.5 ms (Stop, 6640)
+#define ESC_FULL_REVERSE_VAL ESC_PULSE_US_TO_CMP(1000)   // 1.0 ms (7030)
+#define ESC_FULL_FORWARD_VAL ESC_PULSE_US_TO_CMP(2000)   // 2.0 ms (6249)
+
+// --- Compile-Time Checks ---
+// RCC PWMDIV field for PWM_CLOCK_DIVIDER
+#if PWM_CLOCK_DIVIDER == 2
+#define PWM_RCC_PWMDIV 0x0
+#elif PWM_CLOCK_DIVIDER == 4
+#define PWM_RCC_PWMDIV 0x1
+#elif PWM_CLOCK_DIVIDER == 8
+#define PWM_RCC_PWMDIV 0x2
+#elif PWM_CLOCK_DIVIDER == 16
+#define PWM_RCC_PWMDIV 0x3
+#elif PWM_CLOCK_DIVIDER == 32
+#define PWM_RCC_PWMDIV 0x4
+#elif PWM_CLOCK_DIVIDER == 64
+#define PWM_RCC_PWMDIV 0x5
+#else
+#error "PWM_CLOCK_DIVIDER must be 2, 4, 8, 16, 32, or 64"
+#endif
+
+#if (SYSTEM_CLOCK_HZ % PWM_CLOCK_DIVIDER) != 0
+#error "SYSTEM_CLOCK_HZ must be a multiple of PWM_CLOCK_DIVIDER"
+#endif
+
+#if (PWM_LOAD_VALUE > 0xFFFF) || (SERVO_LOAD_VAL > 0xFFFF)
+#error "PWM_PERIOD_US or SERVO_PERIOD_US does not fit the 16-bit PWM counter; increase PWM_CLOCK_DIVIDER"
+#endif
+
+#if (SERVO_MAX_PULSE_US >= SERVO_PERIOD_US) || (PWM_US_TO_TICKS(SERVO_MIN_PULSE_US) == 0)
+#error "The servo pulse range must fit inside one period of its generator"
+#endif
+
+#if (ESC_MAX_PULSE_US >= PWM_PERIOD_US) || (ESC_MIN_PULSE_US > ESC_MAX_PULSE_US) || (PWM_US_TO_TICKS(ESC_MIN_PULSE_US) == 0)
+#error "The ESC pulse range must fit inside one period of generator 0"
+#endif
+
+#if ((1000 / ESC_PULSE_DIVIDER) < ESC_MIN_PULSE_US) || ((2000 / ESC_PULSE_DIVIDER) > ESC_MAX_PULSE_US)
+#error "ESC_FULL_REVERSE_VAL and ESC_FULL_FORWARD_VAL must lie inside the ESC pulse range"
+#endif
+
+#if (ESC_SIGNAL_MODE != ESC_SIGNAL_STANDARD) && (ESC_SIGNAL_MODE != ESC_SIGNAL_ONESHOT125)
+#error "ESC_SIGNAL_MODE must be ESC_SIGNAL_STANDARD or ESC_SIGNAL_ONESHOT125"
+#endif
+
+#if (ESC_SIGNAL_MODE == ESC_SIGNAL_ONESHOT125) && (PWM_SERVO_GENERATOR == 0)
+#error "OneShot125 needs the servo on a generator of its own (PWM_SERVO_GENERATOR 1 or 2)"
+#endif
+
+#if (ESC_SIGNAL_MODE == ESC_SIGNAL_ONESHOT125) && ((ESC_FRAME_US <= ESC_MIN_FRAME_US) || (ESC_FRAME_US >= PWM_PERIOD_US))
+#error "ESC_FRAME_US must be longer than ESC_MIN_FRAME_US and shorter than PWM_PERIOD_US, so each write restarts generator 0"
+#endif
+
+#if ((SERVO_MAX_PULSE_US * PWM_TICKS_PER_US_Q16) > 0xFFFFFFFF) || ((ESC_MAX_PULSE_US * ESC_PULSE_DIVIDER * PWM_TICKS_PER_US_Q16) > 0xFFFFFFFF)
+#error "SERVO_MAX_PULSE_US or ESC_MAX_PULSE_US overflows the run-time conversion"
+#endif
+
+// --- Phase Reset ---
+// Restarting the period of a generator (PWMSYNC) makes the pulse with the new values start at
+// once instead of at the end of the period: the counter restarts from zero, where the held
+// compare values are applied, and the next pulse starts at the following LOAD event.
+// In OneShot125 mode, every write of the ESC compare value restarts generator 0 (see ESC Signal).
+// When PWM_PHASE_RESET_ENABLE is defined as 1 (e.g. -DPWM_PHASE_RESET_ENABLE=1 in the compiler
+// options), ESC_Set_Throttle and PWM_Set_Setpoint also restart the period of the generators they
+// write to in standard mode, and PWM_Set_Setpoint that of the servo generator in either mode.
+// A period is only restarted once its pulse is over and at least the minimum frame of the
+// channels on the generator has elapsed since the pulse started, so no pulse is cut short
+// and no receiver sees pulses faster than it accepts. Generators whose period is not longer
+// than the minimum frame are never restarted: the servo is only known to accept the period
+// of its generator, so generator 0 is not restarted while it carries the servo, unless
+// SERVO_MIN_FRAME_US declares a digital servo. Where a restart happens, the effect shows in
+// PROTOCOL_HISTOGRAM_CMP_TO_LOAD, and Host_Tools/pwm_model.c measures it in each configuration.
+// A restarted period is shorter, so a throttle ramp in progress also takes its next step earlier.
+#ifndef PWM_PHASE_RESET_ENABLE
+#define PWM_PHASE_RESET_ENABLE 0
+#endif
+
+// Shortest time between two pulse starts accepted by the servo (ESC_MIN_FRAME_US for the ESC).
+// The period of the servo generator by default (10 ms on generator 0, like the baseline);
+// define it lower for a digital servo (e.g. -DSERVO_MIN_FRAME_US=3000 for 333 Hz)
+#ifndef SERVO_MIN_FRAME_US
+#define SERVO_MIN_FRAME_US   SERVO_PERIOD_US
+#endif
+
+// Generator 0 carries the ESC, and the servo by default
+#if (PWM_SERVO_GENERATOR == 0) && (SERVO_MIN_FRAME_US > ESC_MIN_FRAME_US)
+#define PWM0_MIN_FRAME_US    SERVO_MIN_FRAME_US
+#else
+#define PWM0_MIN_FRAME_US    ESC_MIN_FRAME_US
+#endif
+
+// A generator is restarted while its counter is at most the threshold, but not within
+// PWM_PHASE_RESET_GUARD_TICKS of zero, where the period ends by itself before PWMSYNC takes effect
+#define PWM0_PHASE_RESET_COUNT  (PWM_LOAD_VALUE - PWM_US_TO_TICKS(PWM0_MIN_FRAME_US))
+#define SERVO_PHASE_RESET_COUNT (SERVO_LOAD_VAL - PWM_US_TO_TICKS(SERVO_MIN_FRAME_US))
+#define PWM_PHASE_RESET_GUARD_TICKS 8
+
+// Set if writes restart generator 0, and the servo generator (0 if the period is too short)
+#define PWM0_PHASE_RESET     ((PWM_PHASE_RESET_ENABLE || (ESC_SIGNAL_MODE == ESC_SIGNAL_ONESHOT125)) && \
+                              (PWM_US_TO_TICKS(PWM0_MIN_FRAME_US) <= PWM_LOAD_VALUE))
+#define SERVO_PHASE_RESET    (PWM_PHASE_RESET_ENABLE && (PWM_SERVO_GENERATOR != 0) && \
+                              (PWM_US_TO_TICKS(SERVO_MIN_FRAME_US) <= SERVO_LOAD_VAL))
+
+#if (ESC_MAX_PULSE_US >= ESC_MIN_FRAME_US) || (SERVO_MAX_PULSE_US >= SERVO_MIN_FRAME_US)
+#error "The minimum frames must be longer than the longest pulses"
+#endif
+
+#if SERVO_MIN_FRAME_US > SERVO_PERIOD_US
+#error "SERVO_PERIOD_US is shorter than the minimum frame of the servo"
+#endif
+
+// --- Normalized Setpoint Range ---
+// Throttle and steering setpoints from the controller range from -1000 to +1000
+#define SETPOINT_FULL_SCALE  1000
+
+// --- Throttle Slew Limiter ---
+// Default slew rates of the ESC pulse width, in microseconds per second
+// Neutral to full throttle (500 us) takes 0.5 s; full throttle to neutral takes 0.2 s
+#define ESC_ACCELERATE_US_PER_S 1000
+#define ESC_BRAKE_US_PER_S      2500
+
+// --- Interrupts ---
+// NVIC priority of the PWM0 Generator 0 interrupt (LOAD event, once per pulse: 100 Hz, or 1 kHz with OneShot125)
+#define PWM0_0_INTERRUPT_PRIORITY 1
+
+// NVIC priority of the PWM0 fault interrupt (above everything else)
+#define PWM0_FAULT_INTERRUPT_PRIORITY 0
+
+// --- Emergency Stop ---
+// PD6 (M0FAULT0) is a kill input with an internal pull-up: a switch to ground asserts it.
+// The PWM fault logic then drives the ESC and servo outputs low at once, without the CPU,
+// and latches the fault, so no pulse reaches the ESC (which stops) or the servo (which goes
+// limp) even if the main loop or the interrupts are stuck. PWM_Fault_Trigger raises the same
+// stop from software (PROTOCOL_MSG_EMERGENCY_STOP) by disabling the outputs, and latches it
+// until PWM_Fault_Clear is called: the software stop never clears itself.
+// PMW0_FAULT_Handler records the stop (EVENT_TRACE_PWM_FAULT), keeps the outputs disabled,
+// and posts EXECUTIVE_EVENT_PWM_FAULT so the main loop can stop the ESC state machine.
+// PWM_Fault_Update, called by the control task, re-arms them once the input and the software
+// stop have both stayed released for PWM_FAULT_REARM_MS, counted from the first call that sees
+// them released (any assertion in between, even between two calls, restarts the count):
+// the ESC restarts at neutral, at the start of a period.
+#define PWM_FAULT_REARM_MS   1000
+
+// --- Synchronized Updates ---
+// The compare values are globally synchronized: every setter below holds its new values
+// and requests an update, which the generator applies when its counter reaches zero,
+// right before the LOAD event that starts the next pulse. A pulse is never cut short
+// or stretched by a write in the middle of the period, and values written together by
+// PWM_Set_Outputs or PWM_Set_Setpoint always start in the same period (when the servo
+// has its own generator, each channel starts at the next period of its generator).
+// PWM_Update_Pending returns 0 once the last values written drive the outputs.
+//
+// ESC_Set_Throttle and PWM_Set_Setpoint move the throttle toward its new value by at most
+// one step per period: PWM0_0_Handler writes each following step at the LOAD event.
+// Braking (toward neutral) and accelerating (away from it) have separate slopes, set with
+// ESC_Set_Slew_Rate (0 removes the limit). ESC_Set_Speed, ESC_Set_Pulse_us, and
+// PWM_Set_Outputs are not limited, so the link supervisor keeps control of its own ramp.
 
 // --- Function Prototypes ---
 void PWM_Init(void);
 void Servo_Set_Angle_Value(uint32_t value);
-void Motor_Set_Speed(uint32_t value);
+void ESC_Set_Speed(uint32_t value);
+void PWM_Set_Outputs(uint32_t esc_value, uint32_t servo_value);
+uint8_t PWM_Update_Pending(void);
+void ESC_Set_Slew_Rate(uint32_t accelerate_in_us_per_s, uint32_t brake_in_us_per_s);
+void ESC_Set_Throttle(int16_t throttle);
+void Servo_Set_Steering(int16_t steering);
+uint32_t Servo_Pulse_us_To_CMP(uint32_t pulse_in_us);
+void ESC_Set_Pulse_us(uint32_t pulse_in_us);
+void Servo_Set_Pulse_us(uint32_t pulse_in_us);
+void PWM_Set_Setpoint(int16_t throttle, int16_t steering);
+void PWM0_0_Handler(void);
+void PWM_Fault_Trigger(void);
+void PWM_Fault_Clear(void);
+uint8_t PWM_Fault_Update(void);
+uint8_t PWM_Fault_Is_Active(void);
+void PMW0_FAULT_Handler(void);
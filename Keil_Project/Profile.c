@@ -0,0 +1,124 @@
+/**
+ * @file Profile.c
+ *
+ * @brief Source code for the Profile driver.
+ *
+ * This file contains the function definitions for the Profile driver.
+ * It measures code regions with the DWT cycle counter and keeps the minimum,
+ * maximum, and total number of cycles of each region in a static table.
+ *
+ * @author
+ */
+
+#include "Profile.h"
+#include "System_Clock.h"
+#include "Protocol.h"
+
+// Number of bytes needed in a payload for one region (four varints)
+#define PROFILE_REGION_PACKED_SIZE (4 * PROTOCOL_MAX_VARINT_SIZE)
+
+#if PROFILE_ENABLE
+
+typedef struct
+{
+	uint32_t count;
+	uint32_t min_cycles;
+	uint32_t max_cycles;
+	uint64_t total_cycles;
+} Profile_Entry;
+
+static Profile_Entry profile_table[PROFILE_REGION_COUNT];
+
+#endif
+
+void Profile_Init(void)
+{
+#if PROFILE_ENABLE
+	// Enable the trace and debug blocks (TRCENA), then start the cycle counter (CYCCNTENA)
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	Profile_Reset();
+#endif
+}
+
+void Profile_Record(uint8_t region, uint32_t cycles)
+{
+#if PROFILE_ENABLE
+	if (region >= PROFILE_REGION_COUNT)
+	{
+		return;
+	}
+
+	Profile_Entry *entry = &profile_table[region];
+
+	if ((entry->count == 0) || (cycles < entry->min_cycles))
+	{
+		entry->min_cycles = cycles;
+	}
+
+	if (cycles > entry->max_cycles)
+	{
+		entry->max_cycles = cycles;
+	}
+
+	entry->total_cycles += cycles;
+	entry->count++;
+#else
+	(void)region;
+	(void)cycles;
+#endif
+}
+
+void Profile_Reset(void)
+{
+#if PROFILE_ENABLE
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	for (uint32_t i = 0; i < PROFILE_REGION_COUNT; i++)
+	{
+		Profile_Entry empty_entry = {0};
+		profile_table[i] = empty_entry;
+	}
+
+	__set_PRIMASK(primask);
+#endif
+}
+
+uint32_t Profile_Pack(uint8_t first_region, uint8_t *payload)
+{
+	uint32_t length = 2;
+	uint32_t region = first_region;
+
+	// The core clock lets the controller convert cycles to time
+	length += Protocol_Put_Varint(SYSTEM_CLOCK_HZ, &payload[length]);
+
+#if PROFILE_ENABLE
+	while ((region < PROFILE_REGION_COUNT) && ((length + PROFILE_REGION_PACKED_SIZE) <= PROTOCOL_MAX_PAYLOAD_SIZE))
+	{
+		// Copy the entry with interrupts disabled, because interrupt regions update the table too
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+
+		Profile_Entry entry = profile_table[region];
+
+		__set_PRIMASK(primask);
+
+		uint32_t mean_cycles = (entry.count != 0) ? (uint32_t)(entry.total_cycles / entry.count) : 0;
+
+		length += Protocol_Put_Varint(entry.count, &payload[length]);
+		length += Protocol_Put_Varint(entry.min_cycles, &payload[length]);
+		length += Protocol_Put_Varint(entry.max_cycles, &payload[length]);
+		length += Protocol_Put_Varint(mean_cycles, &payload[length]);
+
+		region = region + 1;
+	}
+#endif
+
+	payload[0] = first_region;
+	payload[1] = (uint8_t)(region - first_region);
+
+	return length;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file Profile.h
+ *
+ * @brief Header file for the Profile driver.
+ *
+ * This file contains the function definitions for the Profile driver.
+ * It measures code regions with the DWT cycle counter (CYCCNT) of the Cortex-M4, which
+ * counts core clock cycles. For each region listed in Profile_Regions.h, it keeps the number
+ * of runs and the minimum, maximum, and total number of cycles in a static table.
+ * The controller reads the table over the link with PROTOCOL_MSG_PROFILE_REQUEST.
+ *
+ * A region is measured with:
+ *
+ *   PROFILE_BEGIN(PROFILE_COMMAND_PROCESS);
+ *   ...
+ *   PROFILE_END(PROFILE_COMMAND_PROCESS);
+ *
+ * or, for a block that has no return, break, or goto:
+ *
+ *   PROFILE_SCOPE(PROFILE_COMMAND_PROCESS)
+ *   {
+ *       ...
+ *   }
+ *
+ * The time spent in interrupts that preempt a region is included in its measurement.
+ * Each region must only be measured from one context (main loop or one interrupt).
+ *
+ * When PROFILE_ENABLE is defined as 0 (e.g. -DPROFILE_ENABLE=0 in the compiler options),
+ * every macro expands to nothing and the table is not compiled, so the instrumentation
+ * has no cost at all.
+ *
+ * @author
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "TM4C123GH6PM.h"
+#include "Profile_Regions.h"
+
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE 1
+#endif
+
+#if PROFILE_ENABLE
+
+#define PROFILE_BEGIN(region) uint32_t profile_start_##region = DWT->CYCCNT
+#define PROFILE_END(region)   Profile_Record((region), DWT->CYCCNT - profile_start_##region)
+
+#define PROFILE_SCOPE(region) \
+	for (uint32_t profile_start_##region = DWT->CYCCNT, profile_once_##region = 1; profile_once_##region; \
+	     profile_once_##region = 0, Profile_Record((region), DWT->CYCCNT - profile_start_##region))
+
+#else
+
+#define PROFILE_BEGIN(region)
+#define PROFILE_END(region)
+#define PROFILE_SCOPE(region)
+
+#endif
+
+/**
+ * @brief The Profile_Init function enables the DWT cycle counter and clears the table.
+ *
+ * This function should be called first in main, so that the initialization functions
+ * can be measured too.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profile_Init(void);
+
+/**
+ * @brief The Profile_Record function adds one measurement to a region.
+ *
+ * This function is called by PROFILE_END and PROFILE_SCOPE.
+ *
+ * @param region One of the Profile_Regions.
+ *
+ * @param cycles The number of core clock cycles spent in the region.
+ *
+ * @return None
+ */
+void Profile_Record(uint8_t region, uint32_t cycles);
+
+/**
+ * @brief The Profile_Reset function clears the table.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profile_Reset(void);
+
+/**
+ * @brief The Profile_Pack function writes a PROTOCOL_MSG_PROFILE payload.
+ *
+ * The payload holds as many regions as fit, starting with first_region. The controller
+ * requests the next part with the first region that was not included. When PROFILE_ENABLE
+ * is 0, the payload holds no region.
+ *
+ * @param first_region The first region to include.
+ *
+ * @param payload A pointer to a buffer of at least PROTOCOL_MAX_PAYLOAD_SIZE bytes.
+ *
+ * @return uint32_t The payload length.
+ */
+uint32_t Profile_Pack(uint8_t first_region, uint8_t *payload);
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file Profile_Regions.h
+ *
+ * @brief Header file for the list of profiled regions.
+ *
+ * This file contains the list of the code regions measured by the Profile driver.
+ * It does not use any hardware, so the host tool (see Host_Tools/rc_host.c) includes it
+ * to print the region names of a PROTOCOL_MSG_PROFILE reply.
+ *
+ * Each entry holds the region ID and the name reported to the host. To profile a new region,
+ * add an entry here and wrap the code with PROFILE_BEGIN and PROFILE_END (see Profile.h).
+ *
+ * @author
+ */
+
+#ifndef PROFILE_REGIONS_H
+#define PROFILE_REGIONS_H
+
+#define PROFILE_REGION_LIST(X) \
+	X(PROFILE_PWM_INIT,         "PWM_Init") \
+	X(PROFILE_LCD_SEND_COMMAND, "EduBase_LCD_Send_Command") \
+	X(PROFILE_UART1_HANDLER,    "UART1_Handler") \
+	X(PROFILE_COMMAND_PROCESS,  "Command_Process") \
+	X(PROFILE_CONTROL_TASK,     "Control_Task") \
+	X(PROFILE_TELEMETRY_TASK,   "Telemetry_Task") \
+	X(PROFILE_PWM0_0_HANDLER,   "PWM0_0_Handler") \
+	X(PROFILE_TIMER0A_HANDLER,  "TIMER0A_Handler") \
+	X(PROFILE_ADC0SS0_HANDLER,  "ADC0SS0_Handler")
+
+#define PROFILE_REGION_ID(id, name) id,
+
+enum Profile_Regions
+{
+	PROFILE_REGION_LIST(PROFILE_REGION_ID)
+	PROFILE_REGION_COUNT
+};
+
+#undef PROFILE_REGION_ID
+
+#endif
@@ -0,0 +1,491 @@
+/**
+ * @file Protocol.c
+ *
+ * @brief Source code for the Protocol library.
+ *
+ * This file contains the function definitions for the binary control protocol
+ * used between the car and the controller over the Bluetooth link.
+ * The library does not use any hardware, so the same files are compiled into
+ * the firmware and into the host tool (see Host_Tools/rc_host.c).
+ *
+ * @author
+ */
+
+#include "Protocol.h"
+
+// CRC-16/CCITT-FALSE lookup table (polynomial 0x1021)
+static const uint16_t crc16_table[256] =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+uint16_t Protocol_CRC16_Update(uint16_t crc, uint8_t data)
+{
+	return (uint16_t)((crc << 8) ^ crc16_table[((crc >> 8) ^ data) & 0xFF]);
+}
+
+uint16_t Protocol_CRC16(const uint8_t *data, uint32_t length)
+{
+	uint16_t crc = PROTOCOL_CRC16_INIT;
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		crc = Protocol_CRC16_Update(crc, data[i]);
+	}
+
+	return crc;
+}
+
+uint32_t Protocol_COBS_Encode(const uint8_t *input, uint32_t length, uint8_t *output)
+{
+	uint32_t code_index = 0;
+	uint32_t output_index = 1;
+	uint8_t code = 1;
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		if (input[i] == 0)
+		{
+			// Close the current block: the code byte holds the distance to this zero
+			output[code_index] = code;
+			code_index = output_index;
+			output_index = output_index + 1;
+			code = 1;
+		}
+		else
+		{
+			output[output_index] = input[i];
+			output_index = output_index + 1;
+			code = code + 1;
+
+			// A block can hold at most 254 non-zero bytes
+			if (code == 0xFF)
+			{
+				output[code_index] = code;
+				code_index = output_index;
+				output_index = output_index + 1;
+				code = 1;
+			}
+		}
+	}
+
+	output[code_index] = code;
+
+	return output_index;
+}
+
+uint32_t Protocol_COBS_Decode(const uint8_t *input, uint32_t length, uint8_t *output, uint32_t output_size)
+{
+	uint32_t input_index = 0;
+	uint32_t output_index = 0;
+
+	while (input_index < length)
+	{
+		uint8_t code = input[input_index];
+
+		if ((code == 0) || ((input_index + code) > length))
+		{
+			return 0;
+		}
+
+		input_index = input_index + 1;
+
+		for (uint8_t i = 1; i < code; i++)
+		{
+			if ((input[input_index] == 0) || (output_index >= output_size))
+			{
+				return 0;
+			}
+
+			output[output_index] = input[input_index];
+			output_index = output_index + 1;
+			input_index = input_index + 1;
+		}
+
+		// Every block except the last one and the 254-byte blocks is followed by a zero
+		if ((code != 0xFF) && (input_index < length))
+		{
+			if (output_index >= output_size)
+			{
+				return 0;
+			}
+
+			output[output_index] = 0;
+			output_index = output_index + 1;
+		}
+	}
+
+	return output_index;
+}
+
+uint32_t Protocol_Encode_Frame(uint8_t type, uint8_t sequence, const uint8_t *payload, uint32_t payload_length, uint8_t *output)
+{
+	uint8_t frame[PROTOCOL_MAX_FRAME_SIZE];
+
+	if (payload_length > PROTOCOL_MAX_PAYLOAD_SIZE)
+	{
+		return 0;
+	}
+
+	frame[0] = PROTOCOL_VERSION;
+	frame[1] = type;
+	frame[2] = sequence;
+
+	for (uint32_t i = 0; i < payload_length; i++)
+	{
+		frame[PROTOCOL_HEADER_SIZE + i] = payload[i];
+	}
+
+	uint32_t length = PROTOCOL_HEADER_SIZE + payload_length;
+	uint16_t crc = Protocol_CRC16(frame, length);
+	frame[length] = (uint8_t)(crc & 0xFF);
+	frame[length + 1] = (uint8_t)(crc >> 8);
+	length = length + PROTOCOL_CRC_SIZE;
+
+	uint32_t encoded_length = Protocol_COBS_Encode(frame, length, output);
+	output[encoded_length] = PROTOCOL_DELIMITER;
+
+	return encoded_length + 1;
+}
+
+uint8_t Protocol_Decode_Frame(const uint8_t *input, uint32_t length, Protocol_Frame *frame)
+{
+	uint8_t decoded[PROTOCOL_MAX_FRAME_SIZE];
+
+	uint32_t decoded_length = Protocol_COBS_Decode(input, length, decoded, PROTOCOL_MAX_FRAME_SIZE);
+	if (decoded_length == 0)
+	{
+		return PROTOCOL_ERROR_COBS;
+	}
+
+	if (decoded_length < (PROTOCOL_HEADER_SIZE + PROTOCOL_CRC_SIZE))
+	{
+		return PROTOCOL_ERROR_LENGTH;
+	}
+
+	uint32_t crc_offset = decoded_length - PROTOCOL_CRC_SIZE;
+	uint16_t received_crc = (uint16_t)(decoded[crc_offset] | (decoded[crc_offset + 1] << 8));
+	if (Protocol_CRC16(decoded, crc_offset) != received_crc)
+	{
+		return PROTOCOL_ERROR_CRC;
+	}
+
+	if (decoded[0] != PROTOCOL_VERSION)
+	{
+		return PROTOCOL_ERROR_VERSION;
+	}
+
+	frame->type = decoded[1];
+	frame->sequence = decoded[2];
+	frame->payload_length = (uint8_t)(crc_offset - PROTOCOL_HEADER_SIZE);
+
+	for (uint32_t i = 0; i < frame->payload_length; i++)
+	{
+		frame->payload[i] = decoded[PROTOCOL_HEADER_SIZE + i];
+	}
+
+	return PROTOCOL_OK;
+}
+
+void Protocol_Parser_Reset(Protocol_Parser *parser)
+{
+	parser->state = PROTOCOL_PARSER_CODE;
+	parser->block_remaining = 0;
+	parser->block_adds_zero = 0;
+	parser->decoded_length = 0;
+	parser->crc = PROTOCOL_CRC16_INIT;
+}
+
+// Adds one decoded byte to the frame being received
+// Returns 0 if the frame is too long
+static uint8_t Protocol_Parser_Add_Decoded(Protocol_Parser *parser, uint8_t data)
+{
+	uint32_t length = parser->decoded_length;
+
+	if (length >= PROTOCOL_MAX_FRAME_SIZE)
+	{
+		return 0;
+	}
+
+	// Release the oldest held byte into the CRC and the frame fields
+	if (length >= PROTOCOL_CRC_SIZE)
+	{
+		uint32_t index = length - PROTOCOL_CRC_SIZE;
+		uint8_t released = parser->held_bytes[0];
+
+		parser->crc = Protocol_CRC16_Update(parser->crc, released);
+
+		switch (index)
+		{
+			case 0:  parser->version = released;        break;
+			case 1:  parser->frame.type = released;     break;
+			case 2:  parser->frame.sequence = released; break;
+			default: parser->frame.payload[index - PROTOCOL_HEADER_SIZE] = released; break;
+		}
+	}
+
+	parser->held_bytes[0] = parser->held_bytes[1];
+	parser->held_bytes[1] = data;
+	parser->decoded_length = (uint8_t)(length + 1);
+
+	return 1;
+}
+
+static uint8_t Protocol_Parser_End_Of_Frame(Protocol_Parser *parser)
+{
+	uint32_t length = parser->decoded_length;
+
+	if (parser->state == PROTOCOL_PARSER_DISCARD)
+	{
+		return PROTOCOL_ERROR_OVERSIZE;
+	}
+
+	// The delimiter arrived in the middle of a COBS block
+	if (parser->block_remaining != 0)
+	{
+		return PROTOCOL_ERROR_COBS;
+	}
+
+	if (length < (PROTOCOL_HEADER_SIZE + PROTOCOL_CRC_SIZE))
+	{
+		return PROTOCOL_ERROR_LENGTH;
+	}
+
+	uint16_t received_crc = (uint16_t)(parser->held_bytes[0] | (parser->held_bytes[1] << 8));
+	if (parser->crc != received_crc)
+	{
+		return PROTOCOL_ERROR_CRC;
+	}
+
+	if (parser->version != PROTOCOL_VERSION)
+	{
+		return PROTOCOL_ERROR_VERSION;
+	}
+
+	parser->frame.payload_length = (uint8_t)(length - PROTOCOL_HEADER_SIZE - PROTOCOL_CRC_SIZE);
+
+	return PROTOCOL_OK;
+}
+
+uint8_t Protocol_Parse_Byte(Protocol_Parser *parser, uint8_t data)
+{
+	if (data == PROTOCOL_DELIMITER)
+	{
+		uint8_t status = PROTOCOL_IN_PROGRESS;
+
+		// Back-to-back delimiters are allowed and ignored
+		if ((parser->decoded_length != 0) || (parser->state != PROTOCOL_PARSER_CODE) || parser->block_adds_zero)
+		{
+			status = Protocol_Parser_End_Of_Frame(parser);
+		}
+
+		Protocol_Parser_Reset(parser);
+
+		return status;
+	}
+
+	switch (parser->state)
+	{
+		case PROTOCOL_PARSER_CODE:
+		{
+			// The previous block ended with an implicit 0x00 that is now known not to be the end of the frame
+			if (parser->block_adds_zero && !Protocol_Parser_Add_Decoded(parser, 0x00))
+			{
+				parser->state = PROTOCOL_PARSER_DISCARD;
+				break;
+			}
+
+			parser->block_remaining = data - 1;
+			parser->block_adds_zero = (data != 0xFF);
+
+			if (parser->block_remaining != 0)
+			{
+				parser->state = PROTOCOL_PARSER_DATA;
+			}
+			break;
+		}
+
+		case PROTOCOL_PARSER_DATA:
+		{
+			if (!Protocol_Parser_Add_Decoded(parser, data))
+			{
+				parser->state = PROTOCOL_PARSER_DISCARD;
+				break;
+			}
+
+			parser->block_remaining = parser->block_remaining - 1;
+
+			if (parser->block_remaining == 0)
+			{
+				parser->state = PROTOCOL_PARSER_CODE;
+			}
+			break;
+		}
+
+		default:
+		{
+			break;
+		}
+	}
+
+	return PROTOCOL_IN_PROGRESS;
+}
+
+uint32_t Protocol_Put_Varint(uint32_t value, uint8_t *output)
+{
+	uint32_t length = 0;
+
+	while (value >= 0x80)
+	{
+		output[length] = (uint8_t)(value | 0x80);
+		value = value >> 7;
+		length = length + 1;
+	}
+
+	output[length] = (uint8_t)value;
+
+	return length + 1;
+}
+
+uint32_t Protocol_Get_Varint(const uint8_t *input, uint32_t length, uint32_t *value)
+{
+	uint32_t result = 0;
+
+	for (uint32_t i = 0; (i < length) && (i < PROTOCOL_MAX_VARINT_SIZE); i++)
+	{
+		result |= (uint32_t)(input[i] & 0x7F) << (7 * i);
+
+		if ((input[i] & 0x80) == 0)
+		{
+			*value = result;
+			return i + 1;
+		}
+	}
+
+	return 0;
+}
+
+uint32_t Protocol_Zigzag_Encode(int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t Protocol_Zigzag_Decode(uint32_t value)
+{
+	return (int32_t)(value >> 1) ^ -(int32_t)(value & 0x01);
+}
+
+void Protocol_Put_U32(uint32_t value, uint8_t *output)
+{
+	output[0] = (uint8_t)(value & 0xFF);
+	output[1] = (uint8_t)((value >> 8) & 0xFF);
+	output[2] = (uint8_t)((value >> 16) & 0xFF);
+	output[3] = (uint8_t)(value >> 24);
+}
+
+uint32_t Protocol_Get_U32(const uint8_t *input)
+{
+	return (uint32_t)input[0] | ((uint32_t)input[1] << 8) | ((uint32_t)input[2] << 16) | ((uint32_t)input[3] << 24);
+}
+
+uint32_t Protocol_Histogram_Bucket(uint32_t value)
+{
+	if (value < 2)
+	{
+		return value;
+	}
+
+	// Position of the most significant bit, then the bit below it selects the half
+	uint32_t msb = 31;
+	while ((value & (1UL << msb)) == 0)
+	{
+		msb = msb - 1;
+	}
+
+	uint32_t bucket = (2 * msb) + ((value >> (msb - 1)) & 0x01);
+
+	return (bucket < PROTOCOL_HISTOGRAM_BUCKETS) ? bucket : (PROTOCOL_HISTOGRAM_BUCKETS - 1);
+}
+
+uint32_t Protocol_Histogram_Bucket_Limit(uint32_t bucket)
+{
+	uint32_t next = bucket + 1;
+
+	if (next < 2)
+	{
+		return next;
+	}
+
+	uint32_t msb = next / 2;
+
+	return (1UL << msb) | ((uint32_t)(next & 0x01) << (msb - 1));
+}
+
+static int16_t Protocol_Clamp_Setpoint(int16_t value)
+{
+	if (value > PROTOCOL_SETPOINT_MAX)
+	{
+		return PROTOCOL_SETPOINT_MAX;
+	}
+
+	if (value < PROTOCOL_SETPOINT_MIN)
+	{
+		return PROTOCOL_SETPOINT_MIN;
+	}
+
+	return value;
+}
+
+uint32_t Protocol_Pack_Setpoint(const Protocol_Setpoint *setpoint, uint8_t *payload)
+{
+	payload[0] = (uint8_t)((uint16_t)setpoint->throttle & 0xFF);
+	payload[1] = (uint8_t)((uint16_t)setpoint->throttle >> 8);
+	payload[2] = (uint8_t)((uint16_t)setpoint->steering & 0xFF);
+	payload[3] = (uint8_t)((uint16_t)setpoint->steering >> 8);
+
+	return PROTOCOL_SETPOINT_PAYLOAD_SIZE;
+}
+
+uint8_t Protocol_Unpack_Setpoint(const Protocol_Frame *frame, Protocol_Setpoint *setpoint)
+{
+	if (frame->payload_length != PROTOCOL_SETPOINT_PAYLOAD_SIZE)
+	{
+		return 0;
+	}
+
+	setpoint->throttle = Protocol_Clamp_Setpoint((int16_t)(frame->payload[0] | (frame->payload[1] << 8)));
+	setpoint->steering = Protocol_Clamp_Setpoint((int16_t)(frame->payload[2] | (frame->payload[3] << 8)));
+
+	return 1;
+}
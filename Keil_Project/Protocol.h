@@ -0,0 +1,556 @@
+/**
+ * @file Protocol.h
+ *
+ * @brief Header file for the Protocol library.
+ *
+ * This file contains the function definitions for the binary control protocol
+ * used between the car and the controller over the Bluetooth link.
+ * The library does not use any hardware, so the same files are compiled into
+ * the firmware and into the host tool (see Host_Tools/rc_host.c).
+ *
+ * Frame format (before encoding):
+ *
+ *  Offset  Size  Field
+ *  0       1     Protocol version (PROTOCOL_VERSION)
+ *  1       1     Message type (Protocol_Message_Types)
+ *  2       1     Sequence number (incremented by the sender for every frame)
+ *  3       N     Payload (0 to PROTOCOL_MAX_PAYLOAD_SIZE bytes)
+ *  3 + N   2     CRC-16/CCITT-FALSE of bytes 0 to 2 + N, little-endian
+ *
+ * The frame is then encoded with Consistent Overhead Byte Stuffing (COBS), which
+ * removes every 0x00 byte, and a single 0x00 byte is appended as the frame delimiter.
+ * A receiver can therefore always resynchronize at the next 0x00 byte.
+ *
+ * All multi-byte payload fields are little-endian.
+ *
+ * A setpoint frame (throttle + steering) is 11 bytes on the wire.
+ *
+ * Sequence numbers are counted separately by each sender, and by the car separately
+ * for each message type it sends.
+ *
+ * Telemetry batch payload (PROTOCOL_MSG_TELEMETRY):
+ *
+ *  Field                 Encoding
+ *  Sample count          1 byte
+ *  First timestamp       Varint, milliseconds since boot (lower 32 bits)
+ *  For each sample:
+ *    Timestamp delta     Varint, milliseconds since the previous sample (omitted for the first sample)
+ *    Field values        PROTOCOL_TELEMETRY_FIELD_COUNT zigzag varints, each the difference from
+ *                        the same field in the previous sample (from 0 for the first sample)
+ *
+ * Each batch can be decoded on its own, so a lost batch does not affect the next one.
+ * Varints store 7 bits per byte, least significant group first, with bit 7 set on every byte
+ * except the last. Zigzag encoding maps signed values to unsigned ones (0, -1, 1, -2, ... to
+ * 0, 1, 2, 3, ...) so that small differences of either sign take a single byte.
+ *
+ * @author
+ */
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+
+#define PROTOCOL_VERSION            1
+
+// Frame delimiter that follows every COBS-encoded frame
+#define PROTOCOL_DELIMITER          0x00
+
+#define PROTOCOL_HEADER_SIZE        3
+#define PROTOCOL_CRC_SIZE           2
+#define PROTOCOL_MAX_PAYLOAD_SIZE   64
+
+// Largest frame before COBS encoding
+#define PROTOCOL_MAX_FRAME_SIZE     (PROTOCOL_HEADER_SIZE + PROTOCOL_MAX_PAYLOAD_SIZE + PROTOCOL_CRC_SIZE)
+
+// Largest frame after COBS encoding, including the delimiter
+// COBS adds one byte for every 254 bytes of input, plus one
+#define PROTOCOL_MAX_ENCODED_SIZE   (PROTOCOL_MAX_FRAME_SIZE + (PROTOCOL_MAX_FRAME_SIZE / 254) + 2)
+
+// Initial value of the CRC-16/CCITT-FALSE
+#define PROTOCOL_CRC16_INIT         0xFFFF
+
+// Payload length of a PROTOCOL_MSG_SETPOINT frame
+#define PROTOCOL_SETPOINT_PAYLOAD_SIZE 4
+
+// Payload length of a PROTOCOL_MSG_ACK frame
+#define PROTOCOL_ACK_PAYLOAD_SIZE   2
+
+// Payload lengths of the latency probe frames
+#define PROTOCOL_PING_PAYLOAD_SIZE  8
+#define PROTOCOL_PONG_PAYLOAD_SIZE  12
+#define PROTOCOL_HISTOGRAM_REQUEST_PAYLOAD_SIZE 3
+
+// Number of buckets in a latency histogram
+// Buckets 0 and 1 hold the values 0 and 1. Above that, each power of two is split into
+// two buckets, so the bucket of a value is at most 50% wide. Bucket 39 holds every value
+// from 786432 us (0.79 s) upwards.
+#define PROTOCOL_HISTOGRAM_BUCKETS  40
+
+// Flag of PROTOCOL_MSG_HISTOGRAM_REQUEST: clear the histogram after reading it
+#define PROTOCOL_HISTOGRAM_FLAG_RESET 0x01
+
+// Payload length of a PROTOCOL_MSG_PROFILE_REQUEST frame
+#define PROTOCOL_PROFILE_REQUEST_PAYLOAD_SIZE 2
+
+// Flag of PROTOCOL_MSG_PROFILE_REQUEST: clear the profile table after reading it
+#define PROTOCOL_PROFILE_FLAG_RESET 0x01
+
+// Payload length of a PROTOCOL_MSG_TRACE_REQUEST frame
+#define PROTOCOL_TRACE_REQUEST_PAYLOAD_SIZE 3
+
+// Flag of PROTOCOL_MSG_TRACE_REQUEST: clear the trace buffer and resume recording after the reply
+#define PROTOCOL_TRACE_FLAG_RESTART 0x01
+
+// Size of the header of a PROTOCOL_MSG_TRACE payload and of each packed trace record
+#define PROTOCOL_TRACE_HEADER_SIZE  13
+#define PROTOCOL_TRACE_RECORD_SIZE  8
+
+// Number of trace records in one PROTOCOL_MSG_TRACE frame
+#define PROTOCOL_TRACE_RECORDS_PER_FRAME ((PROTOCOL_MAX_PAYLOAD_SIZE - PROTOCOL_TRACE_HEADER_SIZE) / PROTOCOL_TRACE_RECORD_SIZE)
+
+// Number of points in the steering curve (PROTOCOL_MSG_STEERING_TABLE)
+// Point i is the pulse width for the steering setpoint
+// PROTOCOL_SETPOINT_MIN + i * (PROTOCOL_SETPOINT_MAX - PROTOCOL_SETPOINT_MIN) / (PROTOCOL_STEERING_POINTS - 1)
+#define PROTOCOL_STEERING_POINTS    33
+
+// Number of points in one PROTOCOL_MSG_STEERING_TABLE frame and its payload length
+#define PROTOCOL_STEERING_POINTS_PER_FRAME 16
+#define PROTOCOL_STEERING_TABLE_PAYLOAD_SIZE (2 + (2 * PROTOCOL_STEERING_POINTS_PER_FRAME))
+
+// Flag of PROTOCOL_MSG_STEERING_TABLE: use the received curve from the next steering command on
+#define PROTOCOL_STEERING_FLAG_COMMIT 0x01
+
+// Payload length of a PROTOCOL_MSG_EMERGENCY_STOP frame and its actions
+#define PROTOCOL_EMERGENCY_STOP_PAYLOAD_SIZE 1
+#define PROTOCOL_EMERGENCY_STOP_CLEAR 0x00
+#define PROTOCOL_EMERGENCY_STOP_SET   0x01
+
+// Largest encoded varint (32-bit value)
+#define PROTOCOL_MAX_VARINT_SIZE    5
+
+// Range of the normalized throttle and steering values
+#define PROTOCOL_SETPOINT_MAX       1000
+#define PROTOCOL_SETPOINT_MIN       (-1000)
+
+enum Protocol_Message_Types
+{
+	// Controller -> car: int16 throttle, int16 steering (PROTOCOL_SETPOINT_MIN to PROTOCOL_SETPOINT_MAX)
+	PROTOCOL_MSG_SETPOINT       = 0x01,
+
+	// Controller -> car: uint32 host timestamp in us, uint32 round-trip time of the previous ping in us (0 if none)
+	PROTOCOL_MSG_PING           = 0x02,
+
+	// Controller -> car: uint8 histogram ID, uint8 first bucket, uint8 flags (PROTOCOL_HISTOGRAM_FLAG_RESET)
+	PROTOCOL_MSG_HISTOGRAM_REQUEST = 0x03,
+
+	// Controller -> car: uint8 first region (see Profile_Regions.h), uint8 flags (PROTOCOL_PROFILE_FLAG_RESET)
+	PROTOCOL_MSG_PROFILE_REQUEST = 0x04,
+
+	// Controller -> car: uint16 first record, uint8 flags (PROTOCOL_TRACE_FLAG_RESTART)
+	// The first request stops the recording, so the buffer does not change while it is read
+	PROTOCOL_MSG_TRACE_REQUEST  = 0x05,
+
+	// Controller -> car: uint8 first point, uint8 flags (PROTOCOL_STEERING_FLAG_COMMIT), then
+	// PROTOCOL_STEERING_POINTS_PER_FRAME uint16 pulse widths in us (points past the end are ignored)
+	PROTOCOL_MSG_STEERING_TABLE = 0x06,
+
+	// Controller -> car: uint8 action, PROTOCOL_EMERGENCY_STOP_SET (or any other value but
+	// PROTOCOL_EMERGENCY_STOP_CLEAR) to stop the ESC and the servo, PROTOCOL_EMERGENCY_STOP_CLEAR
+	// to release the stop; the outputs come back PWM_FAULT_REARM_MS later (see PWM.h)
+	PROTOCOL_MSG_EMERGENCY_STOP = 0x07,
+
+	// Car -> controller: uint8 message type and uint8 sequence number of an accepted command
+	PROTOCOL_MSG_ACK            = 0x80,
+
+	// Car -> controller: batch of delta-encoded telemetry samples (see above)
+	PROTOCOL_MSG_TELEMETRY      = 0x81,
+
+	// Car -> controller: uint32 host timestamp copied from the ping, uint32 car time when the ping
+	// was decoded in us, uint32 car time when the pong was queued in us
+	PROTOCOL_MSG_PONG           = 0x82,
+
+	// Car -> controller: uint8 histogram ID, uint8 first bucket, uint8 bucket count N,
+	// varint total sample count, varint largest sample in us, then N varint bucket counts
+	PROTOCOL_MSG_HISTOGRAM      = 0x83,
+
+	// Car -> controller: uint8 first region, uint8 region count N, varint core clock in Hz,
+	// then for each region: varint run count, varint min, max, and mean cycles
+	PROTOCOL_MSG_PROFILE        = 0x84,
+
+	// Car -> controller: uint16 first record, uint16 records in the buffer, uint8 record count N,
+	// uint32 core clock in Hz, uint32 records written since the buffer was cleared, then N records of
+	// uint32 cycle counter, uint8 event, uint8 argument, uint16 data (see Event_Trace_Events.h)
+	PROTOCOL_MSG_TRACE          = 0x85
+};
+
+// Latency histograms kept by the car
+enum Protocol_Histogram_Ids
+{
+	// Round-trip time of the pings, as measured by the controller and reported in the next ping
+	PROTOCOL_HISTOGRAM_ROUND_TRIP        = 0,
+
+	// Time from decoding a ping to queuing its pong
+	PROTOCOL_HISTOGRAM_PING_TURNAROUND   = 1,
+
+	// Time from decoding a setpoint frame to writing the PWM compare values
+	PROTOCOL_HISTOGRAM_COMMAND_TO_PWM    = 2,
+
+	// Stages of a setpoint command, measured by the tracepoints (see Tracepoint.h)
+	// Received bytes seen by the main loop -> frame decoded
+	PROTOCOL_HISTOGRAM_RX_TO_DECODE      = 3,
+
+	// Frame decoded -> setpoint published to the control loop
+	PROTOCOL_HISTOGRAM_DECODE_TO_PUBLISH = 4,
+
+	// PWM compare value written -> next PWM generator LOAD event, where the new pulse starts
+	PROTOCOL_HISTOGRAM_CMP_TO_LOAD       = 5,
+
+	// Received bytes seen by the main loop -> next PWM generator LOAD event
+	PROTOCOL_HISTOGRAM_RX_TO_LOAD        = 6,
+
+	PROTOCOL_HISTOGRAM_COUNT             = 7
+};
+
+// States of the ESC state machine (see ESC_State.h), reported in telemetry
+enum Protocol_ESC_States
+{
+	// Neutral output while the ESC arms after power-up
+	PROTOCOL_ESC_ARMING        = 0,
+
+	// Armed and stopped; a reverse command drives backwards at once
+	PROTOCOL_ESC_NEUTRAL       = 1,
+
+	// Driving forward, or stopped after driving forward (a reverse command brakes first)
+	PROTOCOL_ESC_FORWARD       = 2,
+
+	// Reverse pulses after forward, which the ESC applies as a brake
+	PROTOCOL_ESC_BRAKE         = 3,
+
+	// Neutral pulses between the brake and reverse, so that the ESC accepts reverse
+	PROTOCOL_ESC_BRAKE_RELEASE = 4,
+
+	// Driving backwards
+	PROTOCOL_ESC_REVERSE       = 5,
+
+	PROTOCOL_ESC_STATE_COUNT   = 6
+};
+
+// Fields of a telemetry sample, in the order they are encoded
+enum Protocol_Telemetry_Fields
+{
+	// PWM compare values applied to the ESC (CMPA) and the servo (CMPB)
+	PROTOCOL_TELEMETRY_ESC_CMP          = 0,
+	PROTOCOL_TELEMETRY_SERVO_CMP        = 1,
+
+	// Potentiometer voltage from the latest ADC frame that could be read, in millivolts
+	// (0 until the first conversion, then never 0 because of a failed read)
+	PROTOCOL_TELEMETRY_ADC_MV           = 2,
+
+	// Worst execution time and release jitter of the control task since boot, in microseconds
+	PROTOCOL_TELEMETRY_CONTROL_EXEC_US  = 3,
+	PROTOCOL_TELEMETRY_CONTROL_JITTER_US = 4,
+
+	// Link counters since boot
+	PROTOCOL_TELEMETRY_FRAMES_ACCEPTED  = 5,
+	PROTOCOL_TELEMETRY_FRAME_ERRORS     = 6,
+	PROTOCOL_TELEMETRY_SETPOINTS_DROPPED = 7,
+	PROTOCOL_TELEMETRY_RX_OVERRUNS      = 8,
+
+	// State of the ESC state machine (Protocol_ESC_States)
+	PROTOCOL_TELEMETRY_ESC_STATE        = 9,
+
+	// Battery voltage from the latest ADC frame that could be read, in millivolts
+	PROTOCOL_TELEMETRY_BATTERY_MV       = 10,
+
+	PROTOCOL_TELEMETRY_FIELD_COUNT      = 11
+};
+
+enum Protocol_Decode_Status
+{
+	PROTOCOL_OK                 = 0,
+	PROTOCOL_ERROR_COBS         = 1,
+	PROTOCOL_ERROR_LENGTH       = 2,
+	PROTOCOL_ERROR_CRC          = 3,
+	PROTOCOL_ERROR_VERSION      = 4,
+	PROTOCOL_ERROR_OVERSIZE     = 5,
+
+	// Returned by Protocol_Parse_Byte until a non-empty frame is complete
+	PROTOCOL_IN_PROGRESS        = 6
+};
+
+enum Protocol_Parser_States
+{
+	// Next byte is a COBS code byte
+	PROTOCOL_PARSER_CODE        = 0,
+
+	// Next byte is a data byte of the current COBS block
+	PROTOCOL_PARSER_DATA        = 1,
+
+	// Frame is too long: bytes are ignored until the next delimiter
+	PROTOCOL_PARSER_DISCARD     = 2
+};
+
+typedef struct
+{
+	uint8_t type;
+	uint8_t sequence;
+	uint8_t payload_length;
+	uint8_t payload[PROTOCOL_MAX_PAYLOAD_SIZE];
+} Protocol_Frame;
+
+typedef struct
+{
+	uint8_t state;
+
+	// Data bytes left in the current COBS block
+	uint8_t block_remaining;
+
+	// Set when the current COBS block ends with an implicit 0x00 byte
+	uint8_t block_adds_zero;
+
+	// Number of decoded bytes received so far in the current frame
+	uint8_t decoded_length;
+
+	// The last two decoded bytes are held back, because they are the CRC if the frame ends here
+	uint8_t held_bytes[PROTOCOL_CRC_SIZE];
+
+	// CRC of the decoded bytes that have been released from held_bytes
+	uint16_t crc;
+
+	uint8_t version;
+
+	// Frame being received; complete when Protocol_Parse_Byte returns PROTOCOL_OK
+	Protocol_Frame frame;
+} Protocol_Parser;
+
+typedef struct
+{
+	int16_t throttle;
+	int16_t steering;
+} Protocol_Setpoint;
+
+/**
+ * @brief The Protocol_CRC16_Update function adds one byte to a running CRC-16/CCITT-FALSE.
+ *
+ * The CRC uses the polynomial 0x1021 and a 256-entry lookup table, so each byte
+ * costs one table lookup, one shift, and one XOR.
+ *
+ * @param crc The current CRC value. Start with PROTOCOL_CRC16_INIT.
+ *
+ * @param data The next byte.
+ *
+ * @return uint16_t The updated CRC value.
+ */
+uint16_t Protocol_CRC16_Update(uint16_t crc, uint8_t data);
+
+/**
+ * @brief The Protocol_CRC16 function computes the CRC-16/CCITT-FALSE of a buffer.
+ *
+ * @param data A pointer to the bytes.
+ *
+ * @param length The number of bytes.
+ *
+ * @return uint16_t The CRC value.
+ */
+uint16_t Protocol_CRC16(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief The Protocol_COBS_Encode function encodes a buffer with Consistent Overhead Byte Stuffing.
+ *
+ * The output does not contain any 0x00 byte and is at most length + (length / 254) + 1 bytes long.
+ * The delimiter is not appended.
+ *
+ * @param input A pointer to the bytes to encode.
+ *
+ * @param length The number of bytes to encode.
+ *
+ * @param output A pointer to the buffer that receives the encoded bytes.
+ *
+ * @return uint32_t The number of encoded bytes.
+ */
+uint32_t Protocol_COBS_Encode(const uint8_t *input, uint32_t length, uint8_t *output);
+
+/**
+ * @brief The Protocol_COBS_Decode function decodes a COBS-encoded buffer.
+ *
+ * @param input A pointer to the encoded bytes, without the delimiter.
+ *
+ * @param length The number of encoded bytes.
+ *
+ * @param output A pointer to the buffer that receives the decoded bytes.
+ *
+ * @param output_size The size of the output buffer.
+ *
+ * @return uint32_t The number of decoded bytes, or 0 if the input is not valid COBS or does not fit.
+ */
+uint32_t Protocol_COBS_Decode(const uint8_t *input, uint32_t length, uint8_t *output, uint32_t output_size);
+
+/**
+ * @brief The Protocol_Encode_Frame function builds a complete frame ready to be transmitted.
+ *
+ * This function adds the header and the CRC, encodes the frame with COBS,
+ * and appends the delimiter.
+ *
+ * @param type The message type.
+ *
+ * @param sequence The sequence number.
+ *
+ * @param payload A pointer to the payload bytes.
+ *
+ * @param payload_length The number of payload bytes (at most PROTOCOL_MAX_PAYLOAD_SIZE).
+ *
+ * @param output A pointer to a buffer of at least PROTOCOL_MAX_ENCODED_SIZE bytes.
+ *
+ * @return uint32_t The number of bytes to transmit, or 0 if the payload is too long.
+ */
+uint32_t Protocol_Encode_Frame(uint8_t type, uint8_t sequence, const uint8_t *payload, uint32_t payload_length, uint8_t *output);
+
+/**
+ * @brief The Protocol_Decode_Frame function checks and decodes a received frame.
+ *
+ * @param input A pointer to the encoded bytes, without the delimiter.
+ *
+ * @param length The number of encoded bytes.
+ *
+ * @param frame A pointer to the structure that receives the decoded frame.
+ *
+ * @return uint8_t PROTOCOL_OK if the frame is valid, otherwise one of the Protocol_Decode_Status errors.
+ */
+uint8_t Protocol_Decode_Frame(const uint8_t *input, uint32_t length, Protocol_Frame *frame);
+
+/**
+ * @brief The Protocol_Parser_Reset function prepares a parser for the start of a new frame.
+ *
+ * @param parser A pointer to the parser.
+ *
+ * @return None
+ */
+void Protocol_Parser_Reset(Protocol_Parser *parser);
+
+/**
+ * @brief The Protocol_Parse_Byte function decodes one received byte.
+ *
+ * This function is an incremental version of Protocol_Decode_Frame. It undoes the COBS
+ * encoding, updates the CRC, and stores the header and payload in parser->frame as each
+ * byte arrives, so the encoded frame is never buffered. The work per byte is constant,
+ * and the CRC check only compares two values when the delimiter arrives.
+ *
+ * After an error, the parser resynchronizes at the next delimiter.
+ *
+ * @param parser A pointer to the parser.
+ *
+ * @param data The received byte.
+ *
+ * @return uint8_t PROTOCOL_IN_PROGRESS until a delimiter ends a non-empty frame, then PROTOCOL_OK
+ *                 if parser->frame holds a valid frame, otherwise one of the Protocol_Decode_Status errors.
+ */
+uint8_t Protocol_Parse_Byte(Protocol_Parser *parser, uint8_t data);
+
+/**
+ * @brief The Protocol_Put_Varint function encodes an unsigned value as a varint.
+ *
+ * @param value The value to encode.
+ *
+ * @param output A pointer to a buffer of at least PROTOCOL_MAX_VARINT_SIZE bytes.
+ *
+ * @return uint32_t The number of bytes written (1 to PROTOCOL_MAX_VARINT_SIZE).
+ */
+uint32_t Protocol_Put_Varint(uint32_t value, uint8_t *output);
+
+/**
+ * @brief The Protocol_Get_Varint function decodes a varint.
+ *
+ * @param input A pointer to the encoded bytes.
+ *
+ * @param length The number of bytes available.
+ *
+ * @param value A pointer to the variable that receives the value.
+ *
+ * @return uint32_t The number of bytes read, or 0 if the varint is truncated or longer than PROTOCOL_MAX_VARINT_SIZE.
+ */
+uint32_t Protocol_Get_Varint(const uint8_t *input, uint32_t length, uint32_t *value);
+
+/**
+ * @brief The Protocol_Zigzag_Encode function maps a signed value to an unsigned value for varint encoding.
+ *
+ * @param value The signed value.
+ *
+ * @return uint32_t The zigzag-encoded value.
+ */
+uint32_t Protocol_Zigzag_Encode(int32_t value);
+
+/**
+ * @brief The Protocol_Zigzag_Decode function reverses Protocol_Zigzag_Encode.
+ *
+ * @param value The zigzag-encoded value.
+ *
+ * @return int32_t The signed value.
+ */
+int32_t Protocol_Zigzag_Decode(uint32_t value);
+
+/**
+ * @brief The Protocol_Put_U32 function writes a 32-bit value in little-endian order.
+ *
+ * @param value The value.
+ *
+ * @param output A pointer to a buffer of at least 4 bytes.
+ *
+ * @return None
+ */
+void Protocol_Put_U32(uint32_t value, uint8_t *output);
+
+/**
+ * @brief The Protocol_Get_U32 function reads a 32-bit value in little-endian order.
+ *
+ * @param input A pointer to the 4 bytes.
+ *
+ * @return uint32_t The value.
+ */
+uint32_t Protocol_Get_U32(const uint8_t *input);
+
+/**
+ * @brief The Protocol_Histogram_Bucket function returns the latency histogram bucket of a value.
+ *
+ * @param value The value in microseconds.
+ *
+ * @return uint32_t The bucket index (0 to PROTOCOL_HISTOGRAM_BUCKETS - 1).
+ */
+uint32_t Protocol_Histogram_Bucket(uint32_t value);
+
+/**
+ * @brief The Protocol_Histogram_Bucket_Limit function returns the smallest value of the next bucket.
+ *
+ * Every value in the bucket is below the returned limit, except in the last bucket.
+ *
+ * @param bucket The bucket index (0 to PROTOCOL_HISTOGRAM_BUCKETS - 1).
+ *
+ * @return uint32_t The upper limit of the bucket in microseconds.
+ */
+uint32_t Protocol_Histogram_Bucket_Limit(uint32_t bucket);
+
+/**
+ * @brief The Protocol_Pack_Setpoint function writes a setpoint into a payload buffer.
+ *
+ * @param setpoint A pointer to the setpoint.
+ *
+ * @param payload A pointer to a buffer of at least PROTOCOL_SETPOINT_PAYLOAD_SIZE bytes.
+ *
+ * @return uint32_t The payload length (PROTOCOL_SETPOINT_PAYLOAD_SIZE).
+ */
+uint32_t Protocol_Pack_Setpoint(const Protocol_Setpoint *setpoint, uint8_t *payload);
+
+/**
+ * @brief The Protocol_Unpack_Setpoint function reads a setpoint from a received frame.
+ *
+ * The throttle and steering values are clamped to PROTOCOL_SETPOINT_MIN and PROTOCOL_SETPOINT_MAX.
+ *
+ * @param frame A pointer to a frame of type PROTOCOL_MSG_SETPOINT.
+ *
+ * @param setpoint A pointer to the structure that receives the setpoint.
+ *
+ * @return uint8_t 1 if the payload has the expected length, 0 otherwise.
+ */
+uint8_t Protocol_Unpack_Setpoint(const Protocol_Frame *frame, Protocol_Setpoint *setpoint);
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file Ring_Buffer.c
+ *
+ * @brief Source code for the Ring_Buffer driver.
+ *
+ * This file contains the function definitions for the Ring_Buffer driver.
+ * It provides a lock-free, single-producer/single-consumer (SPSC) byte queue
+ * that can be shared between an interrupt service routine and the main loop.
+ *
+ * A data memory barrier is placed between accessing the storage and publishing
+ * the new index, so the other side never sees an index that runs ahead of the data.
+ *
+ * @author
+ */
+
+#include "Ring_Buffer.h"
+
+void Ring_Buffer_Init(Ring_Buffer *ring_buffer, uint8_t *storage, uint32_t size)
+{
+	ring_buffer->storage = storage;
+	ring_buffer->mask = size - 1;
+	ring_buffer->head = 0;
+	ring_buffer->tail = 0;
+}
+
+uint8_t Ring_Buffer_Put(Ring_Buffer *ring_buffer, uint8_t data)
+{
+	uint32_t head = ring_buffer->head;
+
+	if ((head - ring_buffer->tail) > ring_buffer->mask)
+	{
+		return 0;
+	}
+
+	ring_buffer->storage[head & ring_buffer->mask] = data;
+	__DMB();
+	ring_buffer->head = head + 1;
+
+	return 1;
+}
+
+uint8_t Ring_Buffer_Get(Ring_Buffer *ring_buffer, uint8_t *data)
+{
+	uint32_t tail = ring_buffer->tail;
+
+	if (tail == ring_buffer->head)
+	{
+		return 0;
+	}
+
+	__DMB();
+	*data = ring_buffer->storage[tail & ring_buffer->mask];
+	__DMB();
+	ring_buffer->tail = tail + 1;
+
+	return 1;
+}
+
+uint32_t Ring_Buffer_Write(Ring_Buffer *ring_buffer, const uint8_t *data, uint32_t length)
+{
+	uint32_t head = ring_buffer->head;
+	uint32_t free = (ring_buffer->mask + 1) - (head - ring_buffer->tail);
+
+	if (length > free)
+	{
+		length = free;
+	}
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		ring_buffer->storage[(head + i) & ring_buffer->mask] = data[i];
+	}
+
+	__DMB();
+	ring_buffer->head = head + length;
+
+	return length;
+}
+
+uint32_t Ring_Buffer_Read(Ring_Buffer *ring_buffer, uint8_t *data, uint32_t length)
+{
+	uint32_t tail = ring_buffer->tail;
+	uint32_t count = ring_buffer->head - tail;
+
+	if (length > count)
+	{
+		length = count;
+	}
+
+	__DMB();
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		data[i] = ring_buffer->storage[(tail + i) & ring_buffer->mask];
+	}
+
+	__DMB();
+	ring_buffer->tail = tail + length;
+
+	return length;
+}
+
+uint32_t Ring_Buffer_Peek(const Ring_Buffer *ring_buffer, const uint8_t **data)
+{
+	uint32_t tail = ring_buffer->tail;
+	uint32_t count = ring_buffer->head - tail;
+	uint32_t offset = tail & ring_buffer->mask;
+	uint32_t contiguous = (ring_buffer->mask + 1) - offset;
+
+	__DMB();
+
+	*data = &ring_buffer->storage[offset];
+
+	return (count < contiguous) ? count : contiguous;
+}
+
+void Ring_Buffer_Consume(Ring_Buffer *ring_buffer, uint32_t length)
+{
+	__DMB();
+	ring_buffer->tail = ring_buffer->tail + length;
+}
+
+uint32_t Ring_Buffer_Count(const Ring_Buffer *ring_buffer)
+{
+	return ring_buffer->head - ring_buffer->tail;
+}
+
+uint32_t Ring_Buffer_Free(const Ring_Buffer *ring_buffer)
+{
+	return (ring_buffer->mask + 1) - (ring_buffer->head - ring_buffer->tail);
+}
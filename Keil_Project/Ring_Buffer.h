@@ -0,0 +1,146 @@
+/**
+ * @file Ring_Buffer.h
+ *
+ * @brief Header file for the Ring_Buffer driver.
+ *
+ * This file contains the function definitions for the Ring_Buffer driver.
+ * It provides a lock-free, single-producer/single-consumer (SPSC) byte queue
+ * that can be shared between an interrupt service routine and the main loop.
+ *
+ * The producer only writes the head index and the consumer only writes the tail index.
+ * Both indices are free-running 32-bit counters, so the number of stored bytes is
+ * always (head - tail) and the queue never needs a lock or a disabled interrupt,
+ * as long as there is exactly one producer and exactly one consumer.
+ *
+ * The storage is provided by the caller and its size must be a power of two.
+ *
+ * @author
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "TM4C123GH6PM.h"
+
+typedef struct
+{
+	uint8_t *storage;
+	uint32_t mask;
+
+	// Written only by the producer
+	volatile uint32_t head;
+
+	// Written only by the consumer
+	volatile uint32_t tail;
+} Ring_Buffer;
+
+/**
+ * @brief The Ring_Buffer_Init function initializes an empty ring buffer.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param storage A pointer to the memory used to hold the bytes.
+ *
+ * @param size The size of the storage in bytes. It must be a power of two.
+ *
+ * @return None
+ */
+void Ring_Buffer_Init(Ring_Buffer *ring_buffer, uint8_t *storage, uint32_t size);
+
+/**
+ * @brief The Ring_Buffer_Put function adds one byte to the ring buffer (producer side).
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param data The byte to add.
+ *
+ * @return uint8_t 1 if the byte was added, 0 if the ring buffer was full.
+ */
+uint8_t Ring_Buffer_Put(Ring_Buffer *ring_buffer, uint8_t data);
+
+/**
+ * @brief The Ring_Buffer_Get function removes one byte from the ring buffer (consumer side).
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param data A pointer to the variable that receives the byte.
+ *
+ * @return uint8_t 1 if a byte was removed, 0 if the ring buffer was empty.
+ */
+uint8_t Ring_Buffer_Get(Ring_Buffer *ring_buffer, uint8_t *data);
+
+/**
+ * @brief The Ring_Buffer_Write function adds up to length bytes to the ring buffer (producer side).
+ *
+ * The head index is only updated once, after all of the bytes have been copied.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param data A pointer to the bytes to add.
+ *
+ * @param length The number of bytes to add.
+ *
+ * @return uint32_t The number of bytes added, which is less than length if the ring buffer became full.
+ */
+uint32_t Ring_Buffer_Write(Ring_Buffer *ring_buffer, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief The Ring_Buffer_Read function removes up to length bytes from the ring buffer (consumer side).
+ *
+ * The tail index is only updated once, after all of the bytes have been copied.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param data A pointer to the buffer that receives the bytes.
+ *
+ * @param length The maximum number of bytes to remove.
+ *
+ * @return uint32_t The number of bytes removed.
+ */
+uint32_t Ring_Buffer_Read(Ring_Buffer *ring_buffer, uint8_t *data, uint32_t length);
+
+/**
+ * @brief The Ring_Buffer_Peek function returns the stored bytes that are contiguous in memory (consumer side).
+ *
+ * This function does not copy or remove any bytes. The consumer can read the bytes in place
+ * and then call Ring_Buffer_Consume. When the stored bytes wrap around the end of the storage,
+ * only the bytes up to the end of the storage are returned.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param data A pointer to the variable that receives the address of the oldest stored byte.
+ *
+ * @return uint32_t The number of contiguous bytes starting at *data.
+ */
+uint32_t Ring_Buffer_Peek(const Ring_Buffer *ring_buffer, const uint8_t **data);
+
+/**
+ * @brief The Ring_Buffer_Consume function removes bytes that were read in place (consumer side).
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @param length The number of bytes to remove. It must not exceed the value returned by Ring_Buffer_Peek.
+ *
+ * @return None
+ */
+void Ring_Buffer_Consume(Ring_Buffer *ring_buffer, uint32_t length);
+
+/**
+ * @brief The Ring_Buffer_Count function returns the number of bytes stored in the ring buffer.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @return uint32_t The number of bytes stored.
+ */
+uint32_t Ring_Buffer_Count(const Ring_Buffer *ring_buffer);
+
+/**
+ * @brief The Ring_Buffer_Free function returns the number of bytes that can still be added to the ring buffer.
+ *
+ * @param ring_buffer A pointer to the ring buffer.
+ *
+ * @return uint32_t The number of free bytes.
+ */
+uint32_t Ring_Buffer_Free(const Ring_Buffer *ring_buffer);
+
+#endif
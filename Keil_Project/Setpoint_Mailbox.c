@@ -0,0 +1,114 @@
+/**
+ * @file Setpoint_Mailbox.c
+ *
+ * @brief Source code for the Setpoint_Mailbox driver.
+ *
+ * This file contains the function definitions for the Setpoint_Mailbox driver.
+ * It passes the latest throttle and steering setpoint from the command receiver
+ * to the control loop through a single slot protected by a sequence lock.
+ *
+ * @author
+ */
+
+#include "Setpoint_Mailbox.h"
+
+// Even when the slot is stable, odd while the writer is updating it
+// The number of published setpoints is sequence / 2
+static volatile uint32_t sequence = 0;
+
+static volatile int16_t slot_throttle = 0;
+static volatile int16_t slot_steering = 0;
+static volatile uint32_t slot_time_us = 0;
+
+// Sequence number of the last setpoint read (written only by the reader)
+static uint32_t last_read_sequence = 0;
+
+// Written only by the reader
+static uint32_t consumed_count = 0;
+static uint32_t dropped_count = 0;
+static uint32_t read_retries_exhausted = 0;
+
+void Setpoint_Mailbox_Init(void)
+{
+	sequence = 0;
+	slot_throttle = 0;
+	slot_steering = 0;
+	slot_time_us = 0;
+
+	last_read_sequence = 0;
+	consumed_count = 0;
+	dropped_count = 0;
+	read_retries_exhausted = 0;
+}
+
+void Setpoint_Mailbox_Publish(const Protocol_Setpoint *setpoint)
+{
+	uint32_t now_us = (uint32_t)SysTick_Now_us();
+	uint32_t current = sequence;
+
+	// Mark the slot as being written
+	sequence = current + 1;
+	__DMB();
+
+	slot_throttle = setpoint->throttle;
+	slot_steering = setpoint->steering;
+	slot_time_us = now_us;
+
+	// Make the new values visible before the slot is marked as stable again
+	__DMB();
+	sequence = current + 2;
+}
+
+uint8_t Setpoint_Mailbox_Read(Protocol_Setpoint *setpoint, uint32_t *publish_time_in_us)
+{
+	for (uint32_t attempt = 0; attempt < SETPOINT_MAILBOX_READ_ATTEMPTS; attempt++)
+	{
+		uint32_t start = sequence;
+
+		if (start == last_read_sequence)
+		{
+			return 0;
+		}
+
+		// A write is in progress
+		if (start & 0x01)
+		{
+			continue;
+		}
+
+		__DMB();
+		int16_t throttle = slot_throttle;
+		int16_t steering = slot_steering;
+		uint32_t time_us = slot_time_us;
+		__DMB();
+
+		// The copy is consistent only if no write started during it
+		if (sequence != start)
+		{
+			continue;
+		}
+
+		setpoint->throttle = throttle;
+		setpoint->steering = steering;
+		*publish_time_in_us = time_us;
+
+		// Every setpoint published after the last read except this one was never applied
+		dropped_count += ((start - last_read_sequence) / 2) - 1;
+		consumed_count++;
+		last_read_sequence = start;
+
+		return 1;
+	}
+
+	read_retries_exhausted++;
+
+	return 0;
+}
+
+void Setpoint_Mailbox_Get_Stats(Setpoint_Mailbox_Stats *stats)
+{
+	stats->published = sequence / 2;
+	stats->consumed = consumed_count;
+	stats->dropped = dropped_count;
+	stats->read_retries_exhausted = read_retries_exhausted;
+}
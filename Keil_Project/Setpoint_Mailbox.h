@@ -0,0 +1,97 @@
+/**
+ * @file Setpoint_Mailbox.h
+ *
+ * @brief Header file for the Setpoint_Mailbox driver.
+ *
+ * This file contains the function definitions for the Setpoint_Mailbox driver.
+ * It passes the latest throttle and steering setpoint from the command receiver
+ * to the control loop through a single slot, so a burst of commands never queues up:
+ * each new setpoint replaces the previous one, and the control loop always applies
+ * the newest value.
+ *
+ * The slot is protected by a sequence lock (seqlock). The writer increments the sequence
+ * number before and after it updates the slot, so the sequence number is odd while a write
+ * is in progress. The reader copies the slot and accepts the copy only if the sequence number
+ * was even and did not change during the copy. Neither side ever disables interrupts or waits
+ * for the other.
+ *
+ * There must be exactly one writer and exactly one reader. The reader may run in an interrupt
+ * that preempts the writer: it then gives up after a few attempts and keeps the previous value
+ * instead of spinning on a write that cannot finish.
+ *
+ * @author
+ */
+
+#ifndef SETPOINT_MAILBOX_H
+#define SETPOINT_MAILBOX_H
+
+#include "TM4C123GH6PM.h"
+#include "SysTick_Delay.h"
+#include "Protocol.h"
+
+// Number of times the reader retries a copy that was torn by a concurrent write
+#define SETPOINT_MAILBOX_READ_ATTEMPTS 4
+
+typedef struct
+{
+	// Setpoints written to the mailbox
+	uint32_t published;
+
+	// Setpoints read by the control loop
+	uint32_t consumed;
+
+	// Setpoints overwritten by a newer one before the control loop read them
+	uint32_t dropped;
+
+	// Reads abandoned because a write was in progress
+	uint32_t read_retries_exhausted;
+} Setpoint_Mailbox_Stats;
+
+/**
+ * @brief The Setpoint_Mailbox_Init function empties the mailbox and resets the statistics.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Setpoint_Mailbox_Init(void);
+
+/**
+ * @brief The Setpoint_Mailbox_Publish function writes a new setpoint, replacing the previous one.
+ *
+ * The time of the call is stored with the setpoint, so the reader can measure how long
+ * the setpoint waited before it was applied.
+ *
+ * This function must only be called by the writer (the command receiver).
+ *
+ * @param setpoint A pointer to the new setpoint.
+ *
+ * @return None
+ */
+void Setpoint_Mailbox_Publish(const Protocol_Setpoint *setpoint);
+
+/**
+ * @brief The Setpoint_Mailbox_Read function reads the newest setpoint if one was published since the last read.
+ *
+ * Setpoints that were replaced before they could be read are counted as dropped.
+ * This function must only be called by the reader (the control loop).
+ *
+ * @param setpoint A pointer to the structure that receives the setpoint.
+ *
+ * @param publish_time_in_us A pointer to the variable that receives the lower 32 bits of
+ *                           SysTick_Now_us at the time the setpoint was published.
+ *
+ * @return uint8_t 1 if a new setpoint was read, 0 if there is none or a write was in progress.
+ */
+uint8_t Setpoint_Mailbox_Read(Protocol_Setpoint *setpoint, uint32_t *publish_time_in_us);
+
+/**
+ * @brief The Setpoint_Mailbox_Get_Stats function reads the mailbox statistics.
+ *
+ * @param stats A pointer to the structure that receives the statistics.
+ *
+ * @return None
+ */
+void Setpoint_Mailbox_Get_Stats(Setpoint_Mailbox_Stats *stats);
+
+#endif
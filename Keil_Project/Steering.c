@@ -0,0 +1,96 @@
+/**
+ * @file Steering.c
+ *
+ * @brief Source code for the Steering driver.
+ *
+ * This file contains the function definitions for the Steering driver.
+ * It maps steering setpoints onto servo compare values through an interpolated table.
+ *
+ * @author
+ */
+
+#include "Steering.h"
+#include "PWM.h"
+
+#define STEERING_LAST_POINT (PROTOCOL_STEERING_POINTS - 1)
+
+// Table positions per setpoint unit in 16.16 fixed point (rounded up, so that only
+// the full-scale setpoint reaches the last point)
+#define STEERING_POSITION_Q16 ((((uint32_t)STEERING_LAST_POINT << 16) + (2 * SETPOINT_FULL_SCALE) - 1) / (2 * SETPOINT_FULL_SCALE))
+
+// Compare values of the curve in use, and of the curve being received
+static uint16_t steering_table[PROTOCOL_STEERING_POINTS];
+static uint16_t steering_pending_table[PROTOCOL_STEERING_POINTS];
+
+static uint16_t Steering_Clamp(uint32_t value)
+{
+	// Right has the lower compare value (longer pulse)
+	if (value < SERVO_RIGHT_SAFE) value = SERVO_RIGHT_SAFE;
+	if (value > SERVO_LEFT_SAFE) value = SERVO_LEFT_SAFE;
+
+	return (uint16_t)value;
+}
+
+void Steering_Init(uint32_t expo_percent)
+{
+	if (expo_percent > 100)
+	{
+		expo_percent = 100;
+	}
+
+	for (int32_t i = 0; i < PROTOCOL_STEERING_POINTS; i++)
+	{
+		// Position of the point from -STEERING_LAST_POINT to +STEERING_LAST_POINT (x scaled by STEERING_LAST_POINT)
+		int64_t x = (2 * i) - STEERING_LAST_POINT;
+		int64_t scale = STEERING_LAST_POINT;
+
+		// y scaled by 100 * STEERING_LAST_POINT^3
+		int64_t y = ((100 - (int64_t)expo_percent) * x * scale * scale) + ((int64_t)expo_percent * x * x * x);
+		int64_t full_scale = 100 * scale * scale * scale;
+
+		int32_t span = (y < 0) ? ((int32_t)SERVO_LEFT_SAFE - (int32_t)SERVO_CENTER_VAL)
+		                       : ((int32_t)SERVO_RIGHT_SAFE - (int32_t)SERVO_CENTER_VAL);
+		int64_t magnitude = (y < 0) ? -y : y;
+
+		steering_table[i] = Steering_Clamp((uint32_t)((int32_t)SERVO_CENTER_VAL + (int32_t)((magnitude * span) / full_scale)));
+		steering_pending_table[i] = steering_table[i];
+	}
+}
+
+uint32_t Steering_Map(int16_t steering)
+{
+	int32_t value = steering;
+
+	if (value > SETPOINT_FULL_SCALE) value = SETPOINT_FULL_SCALE;
+	if (value < -SETPOINT_FULL_SCALE) value = -SETPOINT_FULL_SCALE;
+
+	uint32_t position = (uint32_t)(value + SETPOINT_FULL_SCALE) * STEERING_POSITION_Q16;
+	uint32_t index = position >> 16;
+
+	if (index >= STEERING_LAST_POINT)
+	{
+		return steering_table[STEERING_LAST_POINT];
+	}
+
+	int32_t fraction = (int32_t)(position & 0xFFFF);
+	int32_t start = steering_table[index];
+	int32_t end = steering_table[index + 1];
+
+	return (uint32_t)(start + (((end - start) * fraction) / 65536));
+}
+
+void Steering_Load(uint32_t first_point, const uint16_t *pulse_in_us, uint32_t count)
+{
+	for (uint32_t i = 0; (i < count) && ((first_point + i) < PROTOCOL_STEERING_POINTS); i++)
+	{
+		steering_pending_table[first_point + i] = Steering_Clamp(Servo_Pulse_us_To_CMP(pulse_in_us[i]));
+	}
+}
+
+void Steering_Commit(void)
+{
+	for (uint32_t i = 0; i < PROTOCOL_STEERING_POINTS; i++)
+	{
+		steering_table[i] = steering_pending_table[i];
+	}
+}
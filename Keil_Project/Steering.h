@@ -0,0 +1,79 @@
+/**
+ * @file Steering.h
+ *
+ * @brief Header file for the Steering driver.
+ *
+ * This file contains the function definitions for the Steering driver.
+ * It maps steering setpoints (-1000 to +1000) onto servo compare values through a
+ * table of PROTOCOL_STEERING_POINTS points spread evenly over the setpoint range.
+ * Between two points, the compare value is interpolated linearly, so a command costs
+ * one table lookup and one multiply, with no division and no floating point.
+ *
+ * At initialization, the table is filled with an expo curve between SERVO_LEFT_SAFE,
+ * SERVO_CENTER_VAL, and SERVO_RIGHT_SAFE:
+ *
+ *   y = (1 - e) * x + e * x^3      (x and y from -1 to +1, e = expo / 100)
+ *
+ * which flattens the curve around center for fine corrections and keeps full lock at
+ * both ends. The controller can replace the table with a calibrated curve through
+ * PROTOCOL_MSG_STEERING_TABLE. Every point is clamped to the mechanical limits
+ * SERVO_LEFT_SAFE and SERVO_RIGHT_SAFE.
+ *
+ * The table is only updated and read from the main loop.
+ *
+ * @author
+ */
+
+#ifndef STEERING_H
+#define STEERING_H
+
+#include "TM4C123GH6PM.h"
+#include "Protocol.h"
+
+// Default expo, in percent (0 = linear, 100 = cubic)
+#define STEERING_EXPO_PERCENT 30
+
+/**
+ * @brief The Steering_Init function fills the table with an expo curve.
+ *
+ * @param expo_percent The expo, from 0 (linear) to 100 (cubic).
+ *
+ * @return None
+ */
+void Steering_Init(uint32_t expo_percent);
+
+/**
+ * @brief The Steering_Map function returns the servo compare value of a steering setpoint.
+ *
+ * @param steering The steering setpoint, from -1000 (full left) to +1000 (full right).
+ *
+ * @return uint32_t The servo compare value.
+ */
+uint32_t Steering_Map(int16_t steering);
+
+/**
+ * @brief The Steering_Load function stores points of a new curve.
+ *
+ * The points are kept aside until Steering_Commit is called, so the curve in use never
+ * mixes old and new points. Points past the end of the table are ignored.
+ *
+ * @param first_point The index of the first point.
+ *
+ * @param pulse_in_us A pointer to the pulse widths of the points in microseconds.
+ *
+ * @param count The number of points.
+ *
+ * @return None
+ */
+void Steering_Load(uint32_t first_point, const uint16_t *pulse_in_us, uint32_t count);
+
+/**
+ * @brief The Steering_Commit function makes the points stored by Steering_Load the curve in use.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Steering_Commit(void);
+
+#endif
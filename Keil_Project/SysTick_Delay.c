@@ -3,79 +3,100 @@
  *
  * @brief Source code for the SysTick_Delay driver.
  *
- * It provides two blocking functions, SysTick_Delay1ms and SysTick_Delay1us,
- * to create a delay with a busy-wait loop. It uses the SysTick timer with 
- * a specified reload value to generate interrupts every 1 us.
- * 
- * In addition, it uses the Peripheral Internal Oscillator (PIOSC) 
- * as the clock source. The PIOSC provides 16 MHz which is then divided by 4. 
- * The timer is used for creating delays in either microseconds or milliseconds.
+ * It provides a free-running, monotonic 64-bit timebase built from the SysTick
+ * counter and a rollover count, along with two blocking functions,
+ * SysTick_Delay1ms and SysTick_Delay1us, that busy-wait on that timebase.
+ *
+ * SysTick uses the Peripheral Internal Oscillator (PIOSC) as the clock source.
+ * The PIOSC provides 16 MHz which is then divided by 4, so one SysTick cycle is 0.25 us.
+ * The counter reloads (and interrupts) once every 1 ms instead of every 1 us, and the
+ * sub-millisecond part of the time is read directly from the SysTick VAL register.
  *
  * @author Aaron Nanas
  */
 
 #include "SysTick_Delay.h"
 
-// Global variable used to keep track of elapsed time in microseconds
-static uint32_t us_elapsed = 0;
-
-// Global variable used to keep track of elapsed time in milliseconds
-static uint32_t ms_elapsed = 0;
-
-// Global flag used to indicate if milliseconds delay is active
-static uint8_t ms_active = 0;
+// Number of SysTick reloads since SysTick_Delay_Init was called (1 reload = 1 ms)
+static volatile uint64_t systick_rollovers = 0;
 
 void SysTick_Delay_Init(void)
-{	
-	// Set the SysTick timer reload value for 1 us intervals
-	// Each clock cycle is (1 / 4 MHz) = 0.25 us
-	SysTick->LOAD = (4 - 1);
-	
+{
+	// Set the SysTick timer reload value for 1 ms intervals
+	// Each clock cycle is (1 / 4 MHz) = 0.25 us, so 4000 cycles = 1 ms
+	SysTick->LOAD = (SYSTICK_CYCLES_PER_TICK - 1);
+
 	// Clear the VAL register by writing any value to it
 	SysTick->VAL = 0;
-	
+
+	// Reset the rollover count
+	systick_rollovers = 0;
+
 	// Enable the SysTick timer and its interrupt
 	// with the Peripheral Internal Oscillator (PIOSC) as the clock source
 	SysTick->CTRL |= 0x03;
 }
 
+uint64_t SysTick_Now_Cycles(void)
+{
+	// Mask interrupts so that the rollover count and VAL are read as one snapshot
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	uint64_t rollovers = systick_rollovers;
+	uint32_t val = SysTick->VAL;
+
+	// If the counter reloaded but SysTick_Handler has not run yet (e.g. this function
+	// was called with interrupts masked), account for the pending reload here.
+	// VAL is read again so that it is guaranteed to belong to the new period.
+	if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		val = SysTick->VAL;
+		rollovers = rollovers + 1;
+	}
+
+	__set_PRIMASK(primask);
+
+	// SysTick counts down from LOAD to 0
+	return (rollovers * SYSTICK_CYCLES_PER_TICK) + ((SYSTICK_CYCLES_PER_TICK - 1) - val);
+}
+
+uint64_t SysTick_Now_us(void)
+{
+	return SysTick_Now_Cycles() / SYSTICK_CYCLES_PER_US;
+}
+
+uint32_t SysTick_Now_ms(void)
+{
+	return (uint32_t)(SysTick_Now_Cycles() / SYSTICK_CYCLES_PER_TICK);
+}
+
 void SysTick_Delay1us(uint32_t delay_in_us)
 {
-	// Reset the global variable, us_elapsed
-	us_elapsed = 0;
-	
-	// Wait until ms_value reaches the specified delay_in_ms
-	while (delay_in_us > us_elapsed);
+	// Record the start time and compute the number of SysTick cycles to wait
+	uint64_t start_cycles = SysTick_Now_Cycles();
+	uint64_t delay_in_cycles = (uint64_t)delay_in_us * SYSTICK_CYCLES_PER_US;
+
+	// Wait until the specified delay_in_us has elapsed
+	while ((SysTick_Now_Cycles() - start_cycles) < delay_in_cycles);
 }
 
 void SysTick_Delay1ms(uint32_t delay_in_ms)
 {
-	// Reset the global variables, us_elapsed and ms_elapsed
-	us_elapsed = 0;
-	ms_elapsed = 0;
-	
-	// Set the ms_active global flag
-	ms_active = 0x01;
-	
-	// Wait until ms_elapsed reaches the specified delay_in_ms
-	while (delay_in_ms > ms_elapsed);
-	
-	// Reset the ms_active global flag
-	ms_active = 0x00;
+	// Record the start time and compute the number of SysTick cycles to wait
+	uint64_t start_cycles = SysTick_Now_Cycles();
+	uint64_t delay_in_cycles = (uint64_t)delay_in_ms * SYSTICK_CYCLES_PER_TICK;
+
+	// Wait until the specified delay_in_ms has elapsed
+	while ((SysTick_Now_Cycles() - start_cycles) < delay_in_cycles);
 }
 
 void SysTick_Handler(void)
 {
-	// Increment the global variable, us_elapsed
-	us_elapsed = us_elapsed + 1;
-	
-	// Check if us_elapsed has reached 1000 (1 millisecond) and if milliseconds delay is active
-	if (us_elapsed == 1000 && (ms_active == 0x01))
-	{
-		// Reset us_elapsed
-		us_elapsed = 0;
-		
-		// Increment ms_elapsed to indicate that 1 millisecond has passed
-		ms_elapsed = ms_elapsed + 1;
-	}
+	EVENT_TRACE_ENTER(EVENT_TRACE_SYSTICK);
+
+	// Increment the rollover count to indicate that 1 millisecond has passed
+	systick_rollovers = systick_rollovers + 1;
+
+	EVENT_TRACE_EXIT(EVENT_TRACE_SYSTICK);
 }
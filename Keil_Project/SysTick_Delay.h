@@ -3,26 +3,37 @@
  *
  * @brief Header file for the SysTick_Delay driver.
  *
- * It provides two blocking functions, SysTick_Delay1ms and SysTick_Delay1us,
- * to create a delay with a busy-wait loop. It uses the SysTick timer with 
- * a specified reload value to generate interrupts every 1 us.
- * 
- * In addition, it uses the Peripheral Internal Oscillator (PIOSC) 
- * as the clock source. The PIOSC provides 16 MHz which is then divided by 4. 
- * The timer is used for creating delays in either microseconds or milliseconds.
+ * It provides a free-running, monotonic 64-bit timebase built from the SysTick
+ * counter and a rollover count, along with two blocking functions,
+ * SysTick_Delay1ms and SysTick_Delay1us, that busy-wait on that timebase.
+ *
+ * SysTick uses the Peripheral Internal Oscillator (PIOSC) as the clock source.
+ * The PIOSC provides 16 MHz which is then divided by 4, so one SysTick cycle is 0.25 us.
+ * The counter reloads (and interrupts) once every 1 ms instead of every 1 us, and the
+ * sub-millisecond part of the time is read directly from the SysTick VAL register.
  *
  * @author Aaron Nanas
  */
  
 #include "TM4C123GH6PM.h"
+#include "Event_Trace.h"
+
+// SysTick input clock: PIOSC (16 MHz) / 4
+#define SYSTICK_CLOCK_HZ         4000000
+
+// Number of SysTick cycles in one microsecond
+#define SYSTICK_CYCLES_PER_US    (SYSTICK_CLOCK_HZ / 1000000)
+
+// Number of SysTick cycles between reloads (1 ms, i.e. a 1 kHz interrupt rate)
+#define SYSTICK_CYCLES_PER_TICK  (SYSTICK_CLOCK_HZ / 1000)
 
 /**
- * @brief The SysTick_Delay_Init function initializes the SysTick timer to be used for a blocking delay function.
+ * @brief The SysTick_Delay_Init function initializes the SysTick timer to be used as a free-running timebase.
  *
  * This function configures the SysTick timer and its interrupt with a specified reload value to 
- * generate interrupts every 1 us. It uses the Peripheral Internal Oscillator (PIOSC) as the clock source.
- * The PIOSC provides 16 MHz which is then divided by 4. The timer is used for creating delays in either 
- * microseconds or milliseconds.
+ * generate interrupts every 1 ms. It uses the Peripheral Internal Oscillator (PIOSC) as the clock source.
+ * The PIOSC provides 16 MHz which is then divided by 4. The rollover count is reset to zero, so the
+ * timebase starts counting from zero when this function is called.
  *
  * @param None
  *
@@ -30,11 +41,46 @@
  */
 void SysTick_Delay_Init(void);
 
+/**
+ * @brief The SysTick_Now_Cycles function returns the number of SysTick cycles elapsed since initialization.
+ *
+ * This function combines the rollover count with the current value of the SysTick VAL register.
+ * Interrupts are masked for the duration of the read so that both values belong to the same period.
+ * If a reload has occurred but SysTick_Handler has not run yet, the pending reload is accounted for,
+ * so the returned value is monotonic even when called from an interrupt or with interrupts disabled.
+ *
+ * @param None
+ *
+ * @return uint64_t The number of SysTick cycles (0.25 us each) elapsed since SysTick_Delay_Init.
+ */
+uint64_t SysTick_Now_Cycles(void);
+
+/**
+ * @brief The SysTick_Now_us function returns the number of microseconds elapsed since initialization.
+ *
+ * @param None
+ *
+ * @return uint64_t The number of microseconds elapsed since SysTick_Delay_Init.
+ */
+uint64_t SysTick_Now_us(void);
+
+/**
+ * @brief The SysTick_Now_ms function returns the number of milliseconds elapsed since initialization.
+ *
+ * The returned value wraps around after approximately 49.7 days. Use unsigned subtraction
+ * to compute the difference between two values.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of milliseconds elapsed since SysTick_Delay_Init.
+ */
+uint32_t SysTick_Now_ms(void);
+
 /**
  * @brief The SysTick_Delay1us function provides a blocking delay in microseconds using the SysTick timer.
  *
- * This function resets the global variable, us_elapsed, to zero and waits until us_elapsed reaches 
- * the specified delay_in_us.
+ * This function records the current time using SysTick_Now_Cycles and waits until
+ * the specified delay_in_us has elapsed.
  *
  * @param delay_in_us The delay time in microseconds.
  *
@@ -45,9 +91,8 @@ void SysTick_Delay1us(uint32_t delay_in_us);
 /**
  * @brief The SysTick_Delay1ms function provides a blocking delay in milliseconds using the SysTick timer.
  *
- * This function clears the global variables, us_elapsed and ms_elapsed, to zero and sets ms_active flag to 0x01 
- * indicating that milliseconds delay is active. It then waits until ms_elapsed reaches the specified delay_in_ms.
- * After the delay, it clears ms_active flag back to 0x00.
+ * This function records the current time using SysTick_Now_Cycles and waits until
+ * the specified delay_in_ms has elapsed.
  *
  * @param delay_in_ms The delay time in milliseconds.
  *
@@ -58,9 +103,8 @@ void SysTick_Delay1ms(uint32_t delay_in_ms);
 /**
  * @brief The SysTick_Handler function is the interrupt service routine for the SysTick timer.
  *
- * This function is called whenever the SysTick timer generates an interrupt. It increments the global variable
- * us_elapsed by 1, indicating that 1 microsecond has passed. Additionally, if us_elapsed reaches 1000 and ms_active
- * flag is set to 0x01, it resets us_elapsed and increments ms_elapsed by 1, indicating that 1 millisecond has passed.
+ * This function is called whenever the SysTick timer reloads, which happens every 1 ms.
+ * It increments the rollover count used by SysTick_Now_Cycles.
  *
  * @param None
  *
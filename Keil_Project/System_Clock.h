@@ -0,0 +1,30 @@
+/**
+ * @file System_Clock.h
+ *
+ * @brief Clock definitions shared by the drivers.
+ *
+ * PLL_Init (main.c) runs the core from the 400 MHz PLL output (DIV400) divided by
+ * PLL_SYSDIV2 + 1, using the SYSDIV2LSB bit, so the clock is exactly SYSTEM_CLOCK_HZ.
+ *
+ * Every timer reload, baud rate divisor, and cycle count conversion is derived from
+ * SYSTEM_CLOCK_HZ at compile time and checked with #error. SystemCoreClock is not used:
+ * the CMSIS SystemCoreClockUpdate ignores DIV400 and SYSDIV2LSB, so it reports a
+ * different clock than the one PLL_Init configures.
+ *
+ * @author
+ */
+
+#ifndef SYSTEM_CLOCK_H
+#define SYSTEM_CLOCK_H
+
+// Core clock, also used by the timers, the UART, and the PWM module
+#define SYSTEM_CLOCK_HZ 50000000   // 400 MHz PLL / 8
+
+// SYSDIV2:SYSDIV2LSB divisor of the 400 MHz PLL output for SYSTEM_CLOCK_HZ
+#define PLL_SYSDIV2     ((400000000 / SYSTEM_CLOCK_HZ) - 1)
+
+#if ((400000000 % SYSTEM_CLOCK_HZ) != 0) || (PLL_SYSDIV2 < 4) || (PLL_SYSDIV2 > 127)
+#error "SYSTEM_CLOCK_HZ must divide 400 MHz and be at most 80 MHz"
+#endif
+
+#endif
@@ -0,0 +1,262 @@
+/**
+ * @file Telemetry.c
+ *
+ * @brief Source code for the Telemetry driver.
+ *
+ * This file contains the function definitions for the Telemetry driver.
+ * It samples the state of the car at a fixed rate and sends it to the controller
+ * in batched, delta-encoded PROTOCOL_MSG_TELEMETRY frames through the low-priority
+ * UART1 queue, within a rate budget in bytes per second.
+ *
+ * @author
+ */
+
+#include "Telemetry.h"
+
+// The token bucket counts thousandths of a byte so that the budget can be added every millisecond
+#define TELEMETRY_TOKENS_PER_BYTE 1000
+
+static uint8_t telemetry_control_task_id = EXECUTIVE_INVALID_TASK;
+static uint32_t telemetry_rate_budget = 0;
+
+static uint32_t telemetry_tokens = 0;
+static uint32_t telemetry_last_refill_ms = 0;
+
+// Batch being built
+static uint8_t batch_payload[PROTOCOL_MAX_PAYLOAD_SIZE];
+static uint32_t batch_length = 0;
+static uint8_t batch_sample_count = 0;
+static int32_t batch_previous_values[PROTOCOL_TELEMETRY_FIELD_COUNT];
+static uint32_t batch_previous_time_ms = 0;
+
+// Finished batch waiting for the rate budget or a free TX slot
+static uint8_t ready_frame[PROTOCOL_MAX_ENCODED_SIZE];
+static uint32_t ready_frame_length = 0;
+static uint8_t telemetry_sequence = 0;
+
+static Telemetry_Stats telemetry_stats;
+
+// Last frame returned by ADC_Read, reported again when a read fails
+static ADC_Frame telemetry_adc_frame;
+
+static void Telemetry_Read_Sample(int32_t *values)
+{
+	ADC_Frame adc_frame;
+	Executive_Task_Stats task_stats = {0};
+	Command_Stats command_stats;
+	Setpoint_Mailbox_Stats mailbox_stats;
+	UART1_Stats uart1_stats;
+
+	// A failed read may leave a partial copy in adc_frame, so only a complete one replaces
+	// the last frame, and the voltages never drop to 0 mV
+	if (ADC_Read(&adc_frame))
+	{
+		telemetry_adc_frame = adc_frame;
+	}
+	else
+	{
+		telemetry_stats.adc_read_failures++;
+	}
+
+	Executive_Get_Task_Stats(telemetry_control_task_id, &task_stats);
+	Command_Get_Stats(&command_stats);
+	Setpoint_Mailbox_Get_Stats(&mailbox_stats);
+	UART1_Get_Stats(&uart1_stats);
+
+	values[PROTOCOL_TELEMETRY_ESC_CMP] = (int32_t)ESC_CMP_REGISTER;
+	values[PROTOCOL_TELEMETRY_SERVO_CMP] = (int32_t)SERVO_CMP_REGISTER;
+	values[PROTOCOL_TELEMETRY_ADC_MV] = (int32_t)ADC_Raw_To_mV(telemetry_adc_frame.raw[ADC_CHANNEL_POTENTIOMETER]);
+	values[PROTOCOL_TELEMETRY_CONTROL_EXEC_US] = (int32_t)task_stats.max_exec_in_us;
+	values[PROTOCOL_TELEMETRY_CONTROL_JITTER_US] = (int32_t)task_stats.max_jitter_in_us;
+	values[PROTOCOL_TELEMETRY_FRAMES_ACCEPTED] = (int32_t)command_stats.frames_accepted;
+	values[PROTOCOL_TELEMETRY_FRAME_ERRORS] = (int32_t)(command_stats.cobs_errors + command_stats.length_errors +
+	                                                   command_stats.crc_errors + command_stats.version_errors +
+	                                                   command_stats.oversize_frames);
+	values[PROTOCOL_TELEMETRY_SETPOINTS_DROPPED] = (int32_t)mailbox_stats.dropped;
+	values[PROTOCOL_TELEMETRY_RX_OVERRUNS] = (int32_t)(uart1_stats.rx_dma_overruns + uart1_stats.overrun_errors);
+	values[PROTOCOL_TELEMETRY_ESC_STATE] = (int32_t)ESC_State_Get();
+	values[PROTOCOL_TELEMETRY_BATTERY_MV] = (int32_t)(ADC_Raw_To_mV(telemetry_adc_frame.raw[ADC_CHANNEL_BATTERY]) * ADC_BATTERY_DIVIDER);
+}
+
+static void Telemetry_Start_Batch(uint32_t time_ms)
+{
+	batch_payload[0] = 0;
+	batch_length = 1 + Protocol_Put_Varint(time_ms, &batch_payload[1]);
+	batch_sample_count = 0;
+	batch_previous_time_ms = time_ms;
+
+	for (uint32_t i = 0; i < PROTOCOL_TELEMETRY_FIELD_COUNT; i++)
+	{
+		batch_previous_values[i] = 0;
+	}
+}
+
+// Encodes a sample relative to the previous sample of the batch
+// Returns the number of bytes written (at most (PROTOCOL_TELEMETRY_FIELD_COUNT + 1) * PROTOCOL_MAX_VARINT_SIZE)
+static uint32_t Telemetry_Encode_Sample(const int32_t *values, uint32_t time_ms, uint8_t *output)
+{
+	uint32_t length = 0;
+
+	if (batch_sample_count != 0)
+	{
+		length += Protocol_Put_Varint(time_ms - batch_previous_time_ms, &output[length]);
+	}
+
+	for (uint32_t i = 0; i < PROTOCOL_TELEMETRY_FIELD_COUNT; i++)
+	{
+		length += Protocol_Put_Varint(Protocol_Zigzag_Encode(values[i] - batch_previous_values[i]), &output[length]);
+	}
+
+	return length;
+}
+
+static void Telemetry_Finish_Batch(void)
+{
+	batch_payload[0] = batch_sample_count;
+	ready_frame_length = Protocol_Encode_Frame(PROTOCOL_MSG_TELEMETRY, telemetry_sequence, batch_payload, batch_length, ready_frame);
+	telemetry_sequence = telemetry_sequence + 1;
+	batch_sample_count = 0;
+}
+
+static void Telemetry_Add_Sample(const int32_t *values, uint32_t time_ms)
+{
+	uint8_t encoded[(PROTOCOL_TELEMETRY_FIELD_COUNT + 1) * PROTOCOL_MAX_VARINT_SIZE];
+
+	if (batch_sample_count == 0)
+	{
+		Telemetry_Start_Batch(time_ms);
+	}
+
+	uint32_t length = Telemetry_Encode_Sample(values, time_ms, encoded);
+
+	// The sample does not fit: send the batch and start a new one with this sample
+	if ((batch_length + length) > PROTOCOL_MAX_PAYLOAD_SIZE)
+	{
+		Telemetry_Finish_Batch();
+		Telemetry_Start_Batch(time_ms);
+		length = Telemetry_Encode_Sample(values, time_ms, encoded);
+	}
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		batch_payload[batch_length + i] = encoded[i];
+	}
+	batch_length = batch_length + length;
+	batch_sample_count = batch_sample_count + 1;
+	batch_previous_time_ms = time_ms;
+
+	for (uint32_t i = 0; i < PROTOCOL_TELEMETRY_FIELD_COUNT; i++)
+	{
+		batch_previous_values[i] = values[i];
+	}
+
+	if ((batch_sample_count >= TELEMETRY_SAMPLES_PER_BATCH) && (ready_frame_length == 0))
+	{
+		Telemetry_Finish_Batch();
+	}
+}
+
+static void Telemetry_Refill_Tokens(uint32_t now_ms)
+{
+	uint32_t elapsed_ms = now_ms - telemetry_last_refill_ms;
+	uint32_t limit = TELEMETRY_BURST_BYTES * TELEMETRY_TOKENS_PER_BYTE;
+
+	telemetry_last_refill_ms = now_ms;
+
+	// The budget is in bytes per second, which is thousandths of a byte per millisecond
+	uint64_t tokens = (uint64_t)telemetry_tokens + ((uint64_t)telemetry_rate_budget * elapsed_ms);
+	telemetry_tokens = (tokens > limit) ? limit : (uint32_t)tokens;
+}
+
+// Returns 1 if the ready frame was queued or there was none
+static uint8_t Telemetry_Send_Ready_Frame(void)
+{
+	if (ready_frame_length == 0)
+	{
+		return 1;
+	}
+
+	uint32_t cost = ready_frame_length * TELEMETRY_TOKENS_PER_BYTE;
+
+	if (telemetry_tokens < cost)
+	{
+		telemetry_stats.budget_waits++;
+		return 0;
+	}
+
+	if (!UART1_Write_Low_Priority(ready_frame, ready_frame_length))
+	{
+		telemetry_stats.queue_waits++;
+		return 0;
+	}
+
+	telemetry_tokens -= cost;
+	telemetry_stats.batches_sent++;
+	telemetry_stats.bytes_sent += ready_frame_length;
+	ready_frame_length = 0;
+
+	return 1;
+}
+
+void Telemetry_Init(uint8_t control_task_id, uint32_t rate_budget)
+{
+	telemetry_control_task_id = control_task_id;
+	telemetry_rate_budget = rate_budget;
+	telemetry_tokens = 0;
+	telemetry_last_refill_ms = SysTick_Now_ms();
+
+	batch_sample_count = 0;
+	ready_frame_length = 0;
+	telemetry_sequence = 0;
+
+	ADC_Frame empty_frame = {0};
+	telemetry_adc_frame = empty_frame;
+
+	Telemetry_Stats empty_stats = {0};
+	telemetry_stats = empty_stats;
+}
+
+void Telemetry_Set_Rate_Budget(uint32_t rate_budget)
+{
+	telemetry_rate_budget = rate_budget;
+}
+
+static void Telemetry_Sample(void)
+{
+	int32_t values[PROTOCOL_TELEMETRY_FIELD_COUNT];
+	uint32_t now_ms = SysTick_Now_ms();
+
+	Telemetry_Refill_Tokens(now_ms);
+
+	if (telemetry_rate_budget == 0)
+	{
+		return;
+	}
+
+	// A finished batch that is still waiting takes priority over new samples
+	if (!Telemetry_Send_Ready_Frame())
+	{
+		telemetry_stats.samples_skipped++;
+		return;
+	}
+
+	Telemetry_Read_Sample(values);
+	Telemetry_Add_Sample(values, now_ms);
+	telemetry_stats.samples++;
+
+	Telemetry_Send_Ready_Frame();
+}
+
+void Telemetry_Task(void)
+{
+	PROFILE_BEGIN(PROFILE_TELEMETRY_TASK);
+
+	Telemetry_Sample();
+
+	PROFILE_END(PROFILE_TELEMETRY_TASK);
+}
+
+void Telemetry_Get_Stats(Telemetry_Stats *stats)
+{
+	*stats = telemetry_stats;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file Telemetry.h
+ *
+ * @brief Header file for the Telemetry driver.
+ *
+ * This file contains the function definitions for the Telemetry driver.
+ * It samples the state of the car at a fixed rate and sends it to the controller
+ * in batched PROTOCOL_MSG_TELEMETRY frames (see Protocol.h). The fields of each sample
+ * are sent as zigzag varints of their difference from the previous sample, so values
+ * that do not change only take one byte.
+ *
+ * Frames are queued with UART1_Write_Low_Priority, so command acknowledgements are
+ * always transmitted first. A token bucket limits the telemetry to a configurable number
+ * of bytes per second. When the budget is used up, the finished batch waits for it and
+ * new samples are skipped, so the telemetry slows down instead of delaying commands.
+ *
+ * @author
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "TM4C123GH6PM.h"
+#include "SysTick_Delay.h"
+#include "Protocol.h"
+#include "UART1.h"
+#include "ADC.h"
+#include "Executive.h"
+#include "Command.h"
+#include "Setpoint_Mailbox.h"
+#include "Profile.h"
+#include "ESC_State.h"
+
+// Period at which Telemetry_Task should be released by the executive
+#define TELEMETRY_SAMPLE_PERIOD_US  20000
+
+// Maximum number of samples in a batch
+#define TELEMETRY_SAMPLES_PER_BATCH 5
+
+// Default rate budget: a quarter of the link capacity (10 bits per byte on the wire)
+#define TELEMETRY_RATE_BUDGET(baud_rate) ((baud_rate) / 40)
+
+// Largest number of bytes the token bucket can save up for a burst
+#define TELEMETRY_BURST_BYTES       (2 * PROTOCOL_MAX_ENCODED_SIZE)
+
+#if PROTOCOL_MAX_ENCODED_SIZE > UART1_TX_LOW_PRIORITY_SLOT_SIZE
+#error "A telemetry frame does not fit in a low-priority UART1 slot"
+#endif
+
+// The first sample of a batch (sample count, time, and every field) must fit in one payload
+#if (1 + ((PROTOCOL_TELEMETRY_FIELD_COUNT + 1) * PROTOCOL_MAX_VARINT_SIZE)) > PROTOCOL_MAX_PAYLOAD_SIZE
+#error "A telemetry sample does not fit in a frame payload"
+#endif
+
+typedef struct
+{
+	// Samples taken, and samples skipped because a finished batch was still waiting to be sent
+	uint32_t samples;
+	uint32_t samples_skipped;
+
+	// Batches sent and bytes queued for transmission
+	uint32_t batches_sent;
+	uint32_t bytes_sent;
+
+	// Number of times a finished batch had to wait for the rate budget or for a free TX slot
+	uint32_t budget_waits;
+	uint32_t queue_waits;
+
+	// Samples that repeated the previous ADC frame because ADC_Read returned no frame
+	uint32_t adc_read_failures;
+} Telemetry_Stats;
+
+/**
+ * @brief The Telemetry_Init function initializes the telemetry.
+ *
+ * @param control_task_id The executive task ID of the control task, whose timing is reported.
+ *
+ * @param rate_budget The maximum telemetry rate in bytes per second.
+ *
+ * @return None
+ */
+void Telemetry_Init(uint8_t control_task_id, uint32_t rate_budget);
+
+/**
+ * @brief The Telemetry_Set_Rate_Budget function changes the maximum telemetry rate.
+ *
+ * @param rate_budget The maximum telemetry rate in bytes per second. 0 stops the telemetry.
+ *
+ * @return None
+ */
+void Telemetry_Set_Rate_Budget(uint32_t rate_budget);
+
+/**
+ * @brief The Telemetry_Task function takes one sample and sends a batch when it is complete.
+ *
+ * This function should be added to the executive with a period of TELEMETRY_SAMPLE_PERIOD_US.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Telemetry_Task(void);
+
+/**
+ * @brief The Telemetry_Get_Stats function reads the telemetry statistics.
+ *
+ * @param stats A pointer to the structure that receives the statistics.
+ *
+ * @return None
+ */
+void Telemetry_Get_Stats(Telemetry_Stats *stats);
+
+#endif
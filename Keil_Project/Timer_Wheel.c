@@ -0,0 +1,191 @@
+/**
+ * @file Timer_Wheel.c
+ *
+ * @brief Source code for the Timer_Wheel driver.
+ *
+ * This file contains the function definitions for the Timer_Wheel driver.
+ * It provides non-blocking one-shot and periodic software timers with callbacks,
+ * replacing busy-wait delays such as SysTick_Delay1ms.
+ *
+ * The timers are kept in a three-level hierarchical timing wheel driven by the
+ * 1 ms SysTick tick (SysTick_Now_ms):
+ *  - Level 0: 256 slots of 1 ms      (delays up to 256 ms)
+ *  - Level 1: 64 slots of 256 ms     (delays up to 16.4 s)
+ *  - Level 2: 64 slots of 16.384 s   (delays up to 1048.6 s)
+ *
+ * @author
+ */
+
+#include "Timer_Wheel.h"
+
+#define TIMER_WHEEL_L0_MASK     (TIMER_WHEEL_L0_SIZE - 1)
+#define TIMER_WHEEL_LN_MASK     (TIMER_WHEEL_LN_SIZE - 1)
+
+#define TIMER_WHEEL_L1_SHIFT    (TIMER_WHEEL_L0_BITS)
+#define TIMER_WHEEL_L2_SHIFT    (TIMER_WHEEL_L0_BITS + TIMER_WHEEL_LN_BITS)
+
+// Each slot holds the head of a doubly-linked list of timers
+static Soft_Timer *wheel_level0[TIMER_WHEEL_L0_SIZE];
+static Soft_Timer *wheel_level1[TIMER_WHEEL_LN_SIZE];
+static Soft_Timer *wheel_level2[TIMER_WHEEL_LN_SIZE];
+
+// The next tick (in ms) to be processed by Timer_Wheel_Update
+static uint32_t wheel_ticks = 0;
+
+static void Timer_Wheel_Link(Soft_Timer **slot, Soft_Timer *timer)
+{
+	timer->next = *slot;
+	if (timer->next != 0)
+	{
+		timer->next->pprev = &timer->next;
+	}
+	timer->pprev = slot;
+	*slot = timer;
+}
+
+static void Timer_Wheel_Unlink(Soft_Timer *timer)
+{
+	*timer->pprev = timer->next;
+	if (timer->next != 0)
+	{
+		timer->next->pprev = timer->pprev;
+	}
+	timer->next = 0;
+	timer->pprev = 0;
+}
+
+static void Timer_Wheel_Insert(Soft_Timer *timer)
+{
+	int32_t delta = (int32_t)(timer->expires - wheel_ticks);
+
+	if (delta < 0)
+	{
+		// Already due: place it in the slot that will be processed next
+		Timer_Wheel_Link(&wheel_level0[wheel_ticks & TIMER_WHEEL_L0_MASK], timer);
+	}
+	else if (delta < TIMER_WHEEL_L0_SIZE)
+	{
+		Timer_Wheel_Link(&wheel_level0[timer->expires & TIMER_WHEEL_L0_MASK], timer);
+	}
+	else if (delta < (1 << TIMER_WHEEL_L2_SHIFT))
+	{
+		Timer_Wheel_Link(&wheel_level1[(timer->expires >> TIMER_WHEEL_L1_SHIFT) & TIMER_WHEEL_LN_MASK], timer);
+	}
+	else
+	{
+		if ((uint32_t)delta > TIMER_WHEEL_MAX_DELAY_MS)
+		{
+			timer->expires = wheel_ticks + TIMER_WHEEL_MAX_DELAY_MS;
+		}
+		Timer_Wheel_Link(&wheel_level2[(timer->expires >> TIMER_WHEEL_L2_SHIFT) & TIMER_WHEEL_LN_MASK], timer);
+	}
+}
+
+static void Timer_Wheel_Cascade(Soft_Timer **slot)
+{
+	// Detach the whole slot, then re-insert each timer one level closer to expiry
+	Soft_Timer *pending = *slot;
+	*slot = 0;
+
+	while (pending != 0)
+	{
+		Soft_Timer *timer = pending;
+		pending = timer->next;
+		Timer_Wheel_Insert(timer);
+	}
+}
+
+static void Timer_Wheel_Process_Tick(void)
+{
+	uint32_t index = wheel_ticks & TIMER_WHEEL_L0_MASK;
+
+	// When level 0 wraps around, move the next level 1 slot down
+	// When level 1 wraps around as well, move the next level 2 slot down first
+	if (index == 0)
+	{
+		uint32_t index1 = (wheel_ticks >> TIMER_WHEEL_L1_SHIFT) & TIMER_WHEEL_LN_MASK;
+		if (index1 == 0)
+		{
+			Timer_Wheel_Cascade(&wheel_level2[(wheel_ticks >> TIMER_WHEEL_L2_SHIFT) & TIMER_WHEEL_LN_MASK]);
+		}
+		Timer_Wheel_Cascade(&wheel_level1[index1]);
+	}
+
+	// Move the expired timers to a local list so that callbacks can safely
+	// start or cancel any timer, including the ones that expire in this tick
+	Soft_Timer *pending = wheel_level0[index];
+	wheel_level0[index] = 0;
+	if (pending != 0)
+	{
+		pending->pprev = &pending;
+	}
+
+	wheel_ticks = wheel_ticks + 1;
+
+	while (pending != 0)
+	{
+		Soft_Timer *timer = pending;
+		Timer_Wheel_Unlink(timer);
+
+		// Re-arm periodic timers before calling the callback so that the callback can cancel them
+		if (timer->period != 0)
+		{
+			timer->expires = timer->expires + timer->period;
+			Timer_Wheel_Insert(timer);
+		}
+
+		timer->callback(timer->context);
+	}
+}
+
+void Timer_Wheel_Init(void)
+{
+	for (uint32_t i = 0; i < TIMER_WHEEL_L0_SIZE; i++)
+	{
+		wheel_level0[i] = 0;
+	}
+
+	for (uint32_t i = 0; i < TIMER_WHEEL_LN_SIZE; i++)
+	{
+		wheel_level1[i] = 0;
+		wheel_level2[i] = 0;
+	}
+
+	wheel_ticks = SysTick_Now_ms();
+}
+
+void Timer_Wheel_Start(Soft_Timer *timer, uint32_t delay_in_ms, uint32_t period_in_ms, Timer_Callback callback, void *context)
+{
+	Timer_Wheel_Cancel(timer);
+
+	timer->expires = SysTick_Now_ms() + delay_in_ms;
+	timer->period = period_in_ms;
+	timer->callback = callback;
+	timer->context = context;
+
+	Timer_Wheel_Insert(timer);
+}
+
+void Timer_Wheel_Cancel(Soft_Timer *timer)
+{
+	if (timer->pprev != 0)
+	{
+		Timer_Wheel_Unlink(timer);
+	}
+}
+
+uint8_t Timer_Wheel_Is_Active(const Soft_Timer *timer)
+{
+	return (timer->pprev != 0) ? 1 : 0;
+}
+
+void Timer_Wheel_Update(void)
+{
+	uint32_t now_ms = SysTick_Now_ms();
+
+	// Process every tick up to and including the current one
+	while ((int32_t)(now_ms - wheel_ticks) >= 0)
+	{
+		Timer_Wheel_Process_Tick();
+	}
+}
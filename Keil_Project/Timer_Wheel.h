@@ -0,0 +1,130 @@
+/**
+ * @file Timer_Wheel.h
+ *
+ * @brief Header file for the Timer_Wheel driver.
+ *
+ * This file contains the function definitions for the Timer_Wheel driver.
+ * It provides non-blocking one-shot and periodic software timers with callbacks,
+ * replacing busy-wait delays such as SysTick_Delay1ms.
+ *
+ * The timers are kept in a three-level hierarchical timing wheel driven by the
+ * 1 ms SysTick tick (SysTick_Now_ms):
+ *  - Level 0: 256 slots of 1 ms      (delays up to 256 ms)
+ *  - Level 1: 64 slots of 256 ms     (delays up to 16.4 s)
+ *  - Level 2: 64 slots of 16.384 s   (delays up to 1048.6 s)
+ *
+ * Starting, cancelling, and expiring a timer are O(1). Timers in levels 1 and 2
+ * are moved down one level (cascaded) when the level below wraps around.
+ *
+ * Timers are allocated by the caller (usually as static variables), so the driver
+ * does not use dynamic memory. The callbacks run from Timer_Wheel_Update in the
+ * main loop, not from an interrupt, so they may call other drivers freely.
+ * None of the functions in this driver may be called from an interrupt.
+ *
+ * @author
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "TM4C123GH6PM.h"
+#include "SysTick_Delay.h"
+
+// Number of bits used to index level 0 and the upper levels of the wheel
+#define TIMER_WHEEL_L0_BITS     8
+#define TIMER_WHEEL_LN_BITS     6
+
+#define TIMER_WHEEL_L0_SIZE     (1 << TIMER_WHEEL_L0_BITS)
+#define TIMER_WHEEL_LN_SIZE     (1 << TIMER_WHEEL_LN_BITS)
+
+// Longest delay (in ms) that can be represented; longer delays are clamped to this value
+#define TIMER_WHEEL_MAX_DELAY_MS ((1UL << (TIMER_WHEEL_L0_BITS + (2 * TIMER_WHEEL_LN_BITS))) - 1)
+
+// Callback function called when a timer expires
+typedef void (*Timer_Callback)(void *context);
+
+typedef struct Soft_Timer
+{
+	// Links to the neighbouring timers in the same wheel slot
+	struct Soft_Timer *next;
+	struct Soft_Timer **pprev;
+
+	// Absolute expiry time in ms (compared against SysTick_Now_ms)
+	uint32_t expires;
+
+	// Reload period in ms, or 0 for a one-shot timer
+	uint32_t period;
+
+	Timer_Callback callback;
+	void *context;
+} Soft_Timer;
+
+/**
+ * @brief The Timer_Wheel_Init function initializes the timing wheel.
+ *
+ * This function clears every slot of the wheel and aligns the wheel with the current
+ * SysTick time. SysTick_Delay_Init must be called before this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Timer_Wheel_Init(void);
+
+/**
+ * @brief The Timer_Wheel_Start function starts (or restarts) a software timer.
+ *
+ * If the timer is already running, it is cancelled first. The callback is called
+ * from Timer_Wheel_Update once delay_in_ms has elapsed. If period_in_ms is not zero,
+ * the timer is re-armed every period_in_ms after that, measured from the previous
+ * expiry time so that periodic timers do not drift.
+ *
+ * @param timer A pointer to the caller-allocated timer.
+ *
+ * @param delay_in_ms The time until the first expiry in milliseconds.
+ *
+ * @param period_in_ms The reload period in milliseconds, or 0 for a one-shot timer.
+ *
+ * @param callback The function to call when the timer expires.
+ *
+ * @param context A pointer passed to the callback.
+ *
+ * @return None
+ */
+void Timer_Wheel_Start(Soft_Timer *timer, uint32_t delay_in_ms, uint32_t period_in_ms, Timer_Callback callback, void *context);
+
+/**
+ * @brief The Timer_Wheel_Cancel function stops a software timer.
+ *
+ * Cancelling a timer that is not running has no effect. A timer may cancel itself
+ * or any other timer from within its callback.
+ *
+ * @param timer A pointer to the timer to cancel.
+ *
+ * @return None
+ */
+void Timer_Wheel_Cancel(Soft_Timer *timer);
+
+/**
+ * @brief The Timer_Wheel_Is_Active function indicates whether a software timer is running.
+ *
+ * @param timer A pointer to the timer.
+ *
+ * @return uint8_t 1 if the timer is running, 0 otherwise.
+ */
+uint8_t Timer_Wheel_Is_Active(const Soft_Timer *timer);
+
+/**
+ * @brief The Timer_Wheel_Update function advances the wheel to the current SysTick time.
+ *
+ * This function processes every 1 ms tick that has elapsed since the previous call and
+ * calls the callbacks of the timers that have expired. It should be called from the main
+ * loop; if the main loop was busy for several ticks, the missed ticks are processed in order.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Timer_Wheel_Update(void);
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file Tracepoint.c
+ *
+ * @brief Source code for the Tracepoint driver.
+ *
+ * This file contains the function definitions for the Tracepoint driver.
+ * It stamps each stage of a setpoint command, from the bytes seen by the main loop
+ * to the PWM LOAD event, and adds the stage latencies to the latency histograms.
+ *
+ * @author
+ */
+
+#include "Tracepoint.h"
+#include "Latency.h"
+
+// Stamps of the command currently being received (main loop only)
+static uint32_t pending_stamps[TRACEPOINT_COUNT];
+
+// Stamps of the command written to the PWM and waiting for the LOAD event
+static uint32_t in_flight_stamps[TRACEPOINT_COUNT];
+
+// Set by the main loop when a command waits for the LOAD event, cleared by PWM0_0_Handler
+static volatile uint8_t load_armed = 0;
+
+// Set by PWM0_0_Handler when the LOAD event was stamped, cleared by the main loop
+static volatile uint8_t load_complete = 0;
+static volatile uint32_t load_stamp = 0;
+
+static Tracepoint_Stats tracepoint_stats;
+
+static uint32_t Tracepoint_Cycles_To_us(uint32_t cycles)
+{
+	return cycles / SYSTICK_CYCLES_PER_US;
+}
+
+uint32_t Tracepoint_Stamp(void)
+{
+	return (uint32_t)SysTick_Now_Cycles();
+}
+
+void Tracepoint_Record(uint8_t tracepoint, uint32_t stamp)
+{
+	if (tracepoint < TRACEPOINT_CMP_WRITTEN)
+	{
+		pending_stamps[tracepoint] = stamp;
+	}
+}
+
+void Tracepoint_CMP_Written(void)
+{
+	uint32_t stamp = Tracepoint_Stamp();
+
+	// Disarm first, so PWM0_0_Handler cannot complete the trace while the stamps are replaced
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	uint8_t was_armed = load_armed;
+	load_armed = 0;
+
+	__set_PRIMASK(primask);
+
+	if (was_armed)
+	{
+		tracepoint_stats.superseded++;
+	}
+
+	// Finish a command that reached the LOAD event but was not added to the histograms yet
+	Tracepoint_Update();
+
+	for (uint32_t i = 0; i < TRACEPOINT_CMP_WRITTEN; i++)
+	{
+		in_flight_stamps[i] = pending_stamps[i];
+	}
+	in_flight_stamps[TRACEPOINT_CMP_WRITTEN] = stamp;
+
+	__DMB();
+	load_armed = 1;
+}
+
+void Tracepoint_PWM_Load(void)
+{
+	if (load_armed)
+	{
+		load_stamp = Tracepoint_Stamp();
+		load_armed = 0;
+		load_complete = 1;
+	}
+}
+
+void Tracepoint_Update(void)
+{
+	if (!load_complete)
+	{
+		return;
+	}
+
+	in_flight_stamps[TRACEPOINT_PWM_LOAD] = load_stamp;
+	load_complete = 0;
+
+	const uint32_t *stamps = in_flight_stamps;
+
+	Latency_Record(PROTOCOL_HISTOGRAM_RX_TO_DECODE,
+	               Tracepoint_Cycles_To_us(stamps[TRACEPOINT_DECODED] - stamps[TRACEPOINT_RX_VISIBLE]));
+	Latency_Record(PROTOCOL_HISTOGRAM_DECODE_TO_PUBLISH,
+	               Tracepoint_Cycles_To_us(stamps[TRACEPOINT_PUBLISHED] - stamps[TRACEPOINT_DECODED]));
+	Latency_Record(PROTOCOL_HISTOGRAM_CMP_TO_LOAD,
+	               Tracepoint_Cycles_To_us(stamps[TRACEPOINT_PWM_LOAD] - stamps[TRACEPOINT_CMP_WRITTEN]));
+	Latency_Record(PROTOCOL_HISTOGRAM_RX_TO_LOAD,
+	               Tracepoint_Cycles_To_us(stamps[TRACEPOINT_PWM_LOAD] - stamps[TRACEPOINT_RX_VISIBLE]));
+
+	tracepoint_stats.completed++;
+}
+
+void Tracepoint_Get_Stats(Tracepoint_Stats *stats)
+{
+	*stats = tracepoint_stats;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file Tracepoint.h
+ *
+ * @brief Header file for the Tracepoint driver.
+ *
+ * This file contains the function definitions for the Tracepoint driver.
+ * It follows a setpoint command from the moment its bytes are seen by the main loop to the
+ * PWM edge that applies it, and breaks the total latency down into stages:
+ *
+ *  Tracepoint               Where
+ *  TRACEPOINT_RX_VISIBLE    Command_Process, when UART1_RX_Peek returns the bytes of the frame
+ *  TRACEPOINT_DECODED       Command_Process, when the delimiter completes a valid frame
+ *  TRACEPOINT_PUBLISHED     Command handler, after the setpoint is written to the mailbox
+ *  TRACEPOINT_CMP_WRITTEN   Control task, after the PWM compare values are written
+ *  TRACEPOINT_PWM_LOAD      PWM0_0_Handler, at the next LOAD event of PWM generator 0
+ *
+ * The compare values written by software only take effect when the generator counter
+ * reaches zero, and the new pulse starts at the LOAD event that follows, so
+ * TRACEPOINT_PWM_LOAD marks the first edge of the new pulse.
+ *
+ * Each tracepoint is stamped with SysTick_Now_Cycles. When a command reaches the PWM,
+ * Tracepoint_Update adds the time spent in each stage to the latency histograms
+ * (see Latency.h), which the controller reads with PROTOCOL_MSG_HISTOGRAM_REQUEST.
+ * The time from publish to compare write goes to PROTOCOL_HISTOGRAM_COMMAND_TO_PWM,
+ * which the control task records itself.
+ *
+ * UART1 receives into uDMA buffers, so there is no interrupt for each received byte;
+ * the first stage therefore starts when the main loop sees the bytes, and the radio
+ * delay is measured separately with pings.
+ *
+ * @author
+ */
+
+#ifndef TRACEPOINT_H
+#define TRACEPOINT_H
+
+#include "TM4C123GH6PM.h"
+#include "SysTick_Delay.h"
+
+enum Tracepoints
+{
+	TRACEPOINT_RX_VISIBLE  = 0,
+	TRACEPOINT_DECODED     = 1,
+	TRACEPOINT_PUBLISHED   = 2,
+	TRACEPOINT_CMP_WRITTEN = 3,
+	TRACEPOINT_PWM_LOAD    = 4,
+	TRACEPOINT_COUNT       = 5
+};
+
+typedef struct
+{
+	// Commands followed all the way to the PWM LOAD event
+	uint32_t completed;
+
+	// Commands replaced by a newer compare write before the LOAD event
+	uint32_t superseded;
+} Tracepoint_Stats;
+
+/**
+ * @brief The Tracepoint_Stamp function returns the current time for a tracepoint.
+ *
+ * @param None
+ *
+ * @return uint32_t The lower 32 bits of SysTick_Now_Cycles.
+ */
+uint32_t Tracepoint_Stamp(void);
+
+/**
+ * @brief The Tracepoint_Record function records a main loop tracepoint of the command being received.
+ *
+ * This function must only be called from the main loop, for TRACEPOINT_RX_VISIBLE,
+ * TRACEPOINT_DECODED, and TRACEPOINT_PUBLISHED.
+ *
+ * @param tracepoint One of the Tracepoints.
+ *
+ * @param stamp The time returned by Tracepoint_Stamp.
+ *
+ * @return None
+ */
+void Tracepoint_Record(uint8_t tracepoint, uint32_t stamp);
+
+/**
+ * @brief The Tracepoint_CMP_Written function records that the last published command was written to the PWM.
+ *
+ * This function must be called from the main loop right after the compare values are written.
+ * It waits for the next PWM LOAD event to complete the trace of the command.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Tracepoint_CMP_Written(void);
+
+/**
+ * @brief The Tracepoint_PWM_Load function records a LOAD event of PWM generator 0.
+ *
+ * This function is called by PWM0_0_Handler.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Tracepoint_PWM_Load(void);
+
+/**
+ * @brief The Tracepoint_Update function adds the stages of a completed command to the latency histograms.
+ *
+ * This function should be called from the main loop.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Tracepoint_Update(void);
+
+/**
+ * @brief The Tracepoint_Get_Stats function reads the tracepoint statistics.
+ *
+ * @param stats A pointer to the structure that receives the statistics.
+ *
+ * @return None
+ */
+void Tracepoint_Get_Stats(Tracepoint_Stats *stats);
+
+#endif
@@ -0,0 +1,457 @@
+/**
+ * @file UART1.c
+ *
+ * @brief Source code for the UART1 driver.
+ *
+ * This file contains the function definitions for the UART1 driver.
+ * It interfaces with the HC-06 Bluetooth module. The following pins are used:
+ *  - U1RX  (PB0)  <-->  HC-06 TXD
+ *  - U1TX  (PB1)  <-->  HC-06 RXD
+ *
+ * Receive path:
+ * uDMA channel 22 (UART1 RX) runs in ping-pong mode over a pool of UART1_RX_DMA_BUFFER_COUNT
+ * buffers of UART1_RX_DMA_BUFFER_SIZE bytes. The primary control structure fills the even
+ * buffers and the alternate control structure fills the odd buffers. When one of them completes,
+ * the uDMA controller switches to the other one without software involvement, and UART1_Handler
+ * re-arms the completed control structure with the buffer two positions ahead in the pool.
+ *
+ * The pool therefore behaves like a ring buffer written by hardware. The write position is
+ * computed from the number of completed buffers and the progress of the active control structure,
+ * and the main loop reads the received bytes in place (UART1_RX_Peek / UART1_RX_Consume).
+ *
+ * Transmit path:
+ * uDMA channel 23 (UART1 TX) runs in basic mode directly from the TX ring buffer storage.
+ * Each transfer covers the bytes that are contiguous in the ring buffer, and UART1_Handler
+ * starts the next transfer when the previous one completes. When the ring buffer is empty,
+ * the oldest low-priority slot is sent instead, as a single transfer.
+ *
+ * @author
+ */
+
+#include "UART1.h"
+
+// UART Flag Register (FR) bits
+#define UART_FR_BUSY   0x08
+
+// UART Interrupt Mask (IM), Masked Interrupt Status (MIS), and Interrupt Clear (ICR) bits
+#define UART_INT_FE    0x080
+#define UART_INT_PE    0x100
+#define UART_INT_BE    0x200
+#define UART_INT_OE    0x400
+#define UART_INT_ERROR (UART_INT_FE | UART_INT_PE | UART_INT_BE | UART_INT_OE)
+
+// uDMA channels assigned to UART1 (encoding 0)
+#define UART1_RX_DMA_CHANNEL 22
+#define UART1_TX_DMA_CHANNEL 23
+
+#define UART1_RX_DMA_POOL_SIZE (UART1_RX_DMA_BUFFER_COUNT * UART1_RX_DMA_BUFFER_SIZE)
+#define UART1_RX_DMA_POOL_MASK (UART1_RX_DMA_POOL_SIZE - 1)
+
+#define UART1_RX_DMA_CONTROL (UDMA_CTL_DST_INC_8 | UDMA_CTL_DST_SIZE_8 | UDMA_CTL_SRC_INC_NONE | UDMA_CTL_SRC_SIZE_8 | \
+                              UDMA_CTL_ARB_SIZE_8 | UDMA_CTL_XFER_SIZE(UART1_RX_DMA_BUFFER_SIZE) | UDMA_CTL_MODE_PINGPONG)
+
+#define UART1_TX_DMA_CONTROL (UDMA_CTL_DST_INC_NONE | UDMA_CTL_DST_SIZE_8 | UDMA_CTL_SRC_INC_8 | UDMA_CTL_SRC_SIZE_8 | \
+                              UDMA_CTL_ARB_SIZE_4 | UDMA_CTL_MODE_BASIC)
+
+static uint8_t rx_dma_pool[UART1_RX_DMA_POOL_SIZE];
+
+// Number of RX buffers completed by the uDMA controller (written by UART1_Handler)
+static volatile uint32_t rx_buffers_completed = 0;
+
+// Read position in the RX byte stream (written by the main loop)
+static volatile uint32_t rx_tail = 0;
+
+static uint8_t tx_storage[UART1_TX_BUFFER_SIZE];
+static Ring_Buffer tx_ring_buffer;
+
+// Low-priority frame slots
+// The main loop writes a slot and then advances tx_low_head; UART1_Handler advances tx_low_tail
+static uint8_t tx_low_slots[UART1_TX_LOW_PRIORITY_SLOT_COUNT][UART1_TX_LOW_PRIORITY_SLOT_SIZE];
+static uint8_t tx_low_lengths[UART1_TX_LOW_PRIORITY_SLOT_COUNT];
+static volatile uint32_t tx_low_head = 0;
+static volatile uint32_t tx_low_tail = 0;
+
+// Number of bytes in the active TX transfer, or 0 if no transfer is active
+static volatile uint32_t tx_dma_length = 0;
+
+// Set when the active TX transfer comes from a low-priority slot
+static volatile uint8_t tx_dma_low_priority = 0;
+
+static volatile UART1_Stats uart1_stats;
+
+static void UART1_Write_Baud_Rate_Divisors(uint32_t baud_rate)
+{
+	uint32_t divisor = UART1_BAUD_RATE_DIVISOR(baud_rate);
+
+	UART1->IBRD = divisor >> 6;
+	UART1->FBRD = divisor & 0x3F;
+
+	// Write LCRH after IBRD and FBRD so that the new divisors take effect
+	// Set the word length to 8 bits (WLEN = 0x3) and enable the FIFOs (FEN)
+	UART1->LCRH = 0x70;
+}
+
+static void UART1_RX_DMA_Arm(uint8_t alternate, uint32_t buffer_number)
+{
+	uint8_t *buffer = &rx_dma_pool[(buffer_number % UART1_RX_DMA_BUFFER_COUNT) * UART1_RX_DMA_BUFFER_SIZE];
+
+	uDMA_Set_Transfer(UART1_RX_DMA_CHANNEL, alternate, &UART1->DR, &buffer[UART1_RX_DMA_BUFFER_SIZE - 1], UART1_RX_DMA_CONTROL);
+}
+
+static void UART1_TX_DMA_Start(void)
+{
+	const uint8_t *data;
+	uint32_t length = Ring_Buffer_Peek(&tx_ring_buffer, &data);
+
+	tx_dma_low_priority = 0;
+
+	// Serve the low-priority slots only when the normal queue is empty
+	if ((length == 0) && (tx_low_head != tx_low_tail))
+	{
+		uint32_t slot = tx_low_tail & (UART1_TX_LOW_PRIORITY_SLOT_COUNT - 1);
+
+		__DMB();
+		data = tx_low_slots[slot];
+		length = tx_low_lengths[slot];
+		tx_dma_low_priority = 1;
+	}
+
+	if (length == 0)
+	{
+		return;
+	}
+
+	if (length > UDMA_MAX_TRANSFER_SIZE)
+	{
+		length = UDMA_MAX_TRANSFER_SIZE;
+	}
+
+	tx_dma_length = length;
+	uDMA_Set_Transfer(UART1_TX_DMA_CHANNEL, 0, &data[length - 1], &UART1->DR, UART1_TX_DMA_CONTROL | UDMA_CTL_XFER_SIZE(length));
+	uDMA_Enable_Channel(UART1_TX_DMA_CHANNEL);
+}
+
+// Returns the total number of bytes written into the RX pool by the uDMA controller
+static uint32_t UART1_RX_Head(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	uint32_t completed = rx_buffers_completed;
+	uint8_t alternate_active = uDMA_Is_Alternate_Active(UART1_RX_DMA_CHANNEL);
+	uint32_t remaining = uDMA_Get_Remaining(UART1_RX_DMA_CHANNEL, alternate_active);
+
+	__set_PRIMASK(primask);
+
+	// The primary control structure fills the even buffers and the alternate fills the odd buffers.
+	// If the active structure does not match the next buffer, a completion is still pending
+	// in UART1_Handler, so the active buffer is one further ahead.
+	uint32_t active_buffer = completed;
+	if ((active_buffer & 0x01) != alternate_active)
+	{
+		active_buffer = active_buffer + 1;
+	}
+
+	return (active_buffer * UART1_RX_DMA_BUFFER_SIZE) + (UART1_RX_DMA_BUFFER_SIZE - remaining);
+}
+
+void UART1_Init(uint32_t baud_rate)
+{
+	Ring_Buffer_Init(&tx_ring_buffer, tx_storage, UART1_TX_BUFFER_SIZE);
+
+	rx_buffers_completed = 0;
+	rx_tail = 0;
+	tx_low_head = 0;
+	tx_low_tail = 0;
+	tx_dma_length = 0;
+	tx_dma_low_priority = 0;
+
+	// Enable the clock to UART1 and Port B
+	SYSCTL->RCGCUART |= 0x02;
+	SYSCTL->RCGCGPIO |= 0x02;
+
+	// Wait until UART1 and Port B are ready to be accessed
+	while ((SYSCTL->PRUART & 0x02) == 0);
+	while ((SYSCTL->PRGPIO & 0x02) == 0);
+
+	// Configure PB0 (U1RX) and PB1 (U1TX) to use their alternate function
+	GPIOB->AFSEL |= 0x03;
+	GPIOB->PCTL &= ~0x000000FF;
+	GPIOB->PCTL |= 0x00000011;
+	GPIOB->DEN |= 0x03;
+
+	// Disable UART1 before configuration
+	UART1->CTL &= ~0x01;
+
+	// Use the system clock as the UART clock source
+	UART1->CC = 0x0;
+
+	UART1_Write_Baud_Rate_Divisors(baud_rate);
+
+	// Request a uDMA burst when the RX FIFO is 1/2 full (RXIFLSEL = 0x2)
+	// and when the TX FIFO drains to 1/2 full (TXIFLSEL = 0x2)
+	UART1->IFLS = 0x12;
+
+	// Configure uDMA channel 22 for ping-pong reception into the first two buffers of the pool
+	uDMA_Init();
+	uDMA_Configure_Channel(UART1_RX_DMA_CHANNEL, 0);
+	UART1_RX_DMA_Arm(0, 0);
+	UART1_RX_DMA_Arm(1, 1);
+	uDMA_Enable_Channel(UART1_RX_DMA_CHANNEL);
+
+	// Configure uDMA channel 23 for transmission; transfers are started by UART1_Handler
+	uDMA_Configure_Channel(UART1_TX_DMA_CHANNEL, 0);
+
+	// Enable the RX and TX uDMA requests (RXDMAE and TXDMAE)
+	UART1->DMACTL = 0x03;
+
+	// Clear any pending interrupts, then enable only the receive error interrupts
+	// The uDMA completion interrupts of channels 22 and 23 are raised on the UART1 vector
+	UART1->ICR = 0x7F2;
+	UART1->IM = UART_INT_ERROR;
+
+	NVIC_SetPriority(UART1_IRQn, UART1_INTERRUPT_PRIORITY);
+	NVIC_EnableIRQ(UART1_IRQn);
+
+	// Enable the transmitter (TXE), the receiver (RXE), and UART1 (UARTEN)
+	UART1->CTL |= 0x301;
+}
+
+void UART1_Set_Baud_Rate(uint32_t baud_rate)
+{
+	// Let the queued bytes finish transmitting before changing the divisors
+	while (Ring_Buffer_Count(&tx_ring_buffer) != 0);
+	while (tx_low_head != tx_low_tail);
+	while (UART1->FR & UART_FR_BUSY);
+
+	UART1->CTL &= ~0x01;
+	UART1_Write_Baud_Rate_Divisors(baud_rate);
+	UART1->CTL |= 0x01;
+}
+
+uint32_t UART1_RX_Peek(const uint8_t **data)
+{
+	uint32_t head = UART1_RX_Head();
+	uint32_t tail = rx_tail;
+
+	// If the uDMA controller has lapped the read position, the unread data was overwritten:
+	// drop everything that is left and continue with new data
+	if ((head - tail) > UART1_RX_DMA_POOL_SIZE)
+	{
+		uart1_stats.rx_dma_overruns++;
+		tail = head;
+		rx_tail = tail;
+	}
+
+	uint32_t offset = tail & UART1_RX_DMA_POOL_MASK;
+	uint32_t contiguous = UART1_RX_DMA_POOL_SIZE - offset;
+	uint32_t count = head - tail;
+
+	*data = &rx_dma_pool[offset];
+
+	return (count < contiguous) ? count : contiguous;
+}
+
+void UART1_RX_Consume(uint32_t length)
+{
+	rx_tail = rx_tail + length;
+}
+
+uint32_t UART1_Available(void)
+{
+	return UART1_RX_Head() - rx_tail;
+}
+
+uint8_t UART1_Read_Byte(uint8_t *data)
+{
+	const uint8_t *received;
+
+	if (UART1_RX_Peek(&received) == 0)
+	{
+		return 0;
+	}
+
+	*data = received[0];
+	UART1_RX_Consume(1);
+
+	return 1;
+}
+
+uint32_t UART1_Read(uint8_t *buffer, uint32_t length)
+{
+	uint32_t total = 0;
+
+	while (total < length)
+	{
+		const uint8_t *received;
+		uint32_t count = UART1_RX_Peek(&received);
+
+		if (count == 0)
+		{
+			break;
+		}
+
+		if (count > (length - total))
+		{
+			count = length - total;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			buffer[total + i] = received[i];
+		}
+
+		UART1_RX_Consume(count);
+		total = total + count;
+	}
+
+	return total;
+}
+
+uint32_t UART1_Write(const uint8_t *data, uint32_t length)
+{
+	uint32_t queued = Ring_Buffer_Write(&tx_ring_buffer, data, length);
+
+	// Pend the UART1 interrupt so that UART1_Handler starts a TX transfer if none is active
+	if (queued > 0)
+	{
+		NVIC_SetPendingIRQ(UART1_IRQn);
+	}
+
+	return queued;
+}
+
+uint32_t UART1_Write_String(const char *string)
+{
+	uint32_t length = 0;
+
+	while (string[length] != '\0')
+	{
+		length = length + 1;
+	}
+
+	return UART1_Write((const uint8_t *)string, length);
+}
+
+uint8_t UART1_Write_Low_Priority(const uint8_t *data, uint32_t length)
+{
+	uint32_t head = tx_low_head;
+
+	if (((head - tx_low_tail) >= UART1_TX_LOW_PRIORITY_SLOT_COUNT) || (length == 0) || (length > UART1_TX_LOW_PRIORITY_SLOT_SIZE))
+	{
+		return 0;
+	}
+
+	uint32_t slot = head & (UART1_TX_LOW_PRIORITY_SLOT_COUNT - 1);
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		tx_low_slots[slot][i] = data[i];
+	}
+	tx_low_lengths[slot] = (uint8_t)length;
+
+	// Publish the slot only after its contents are written
+	__DMB();
+	tx_low_head = head + 1;
+
+	NVIC_SetPendingIRQ(UART1_IRQn);
+
+	return 1;
+}
+
+uint32_t UART1_TX_Low_Priority_Free(void)
+{
+	return UART1_TX_LOW_PRIORITY_SLOT_COUNT - (tx_low_head - tx_low_tail);
+}
+
+uint32_t UART1_TX_Free(void)
+{
+	return Ring_Buffer_Free(&tx_ring_buffer);
+}
+
+void UART1_Get_Stats(UART1_Stats *stats)
+{
+	*stats = uart1_stats;
+	stats->rx_bytes = UART1_RX_Head();
+}
+
+void UART1_Handler(void)
+{
+	EVENT_TRACE_ENTER(EVENT_TRACE_UART1);
+	PROFILE_BEGIN(PROFILE_UART1_HANDLER);
+
+	// Count and clear the receive error interrupts
+	uint32_t status = UART1->MIS;
+	UART1->ICR = status & UART_INT_ERROR;
+
+	if (status & UART_INT_ERROR)
+	{
+		if (status & UART_INT_FE) uart1_stats.framing_errors++;
+		if (status & UART_INT_PE) uart1_stats.parity_errors++;
+		if (status & UART_INT_BE) uart1_stats.break_errors++;
+		if (status & UART_INT_OE) uart1_stats.overrun_errors++;
+	}
+
+	// RX buffer completed: re-arm the control structure that stopped with the buffer two positions ahead
+	if (uDMA_Get_Channel_Interrupt(UART1_RX_DMA_CHANNEL))
+	{
+		uDMA_Clear_Channel_Interrupt(UART1_RX_DMA_CHANNEL);
+
+		// In ping-pong mode both structures may have completed if this interrupt was delayed
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			uint32_t completed = rx_buffers_completed;
+			uint8_t alternate = completed & 0x01;
+
+			if (uDMA_Get_Remaining(UART1_RX_DMA_CHANNEL, alternate) != 0)
+			{
+				break;
+			}
+
+			uint32_t next_buffer = completed + 2;
+			UART1_RX_DMA_Arm(alternate, next_buffer);
+			rx_buffers_completed = completed + 1;
+			uart1_stats.rx_buffer_swaps++;
+
+			// Swap latency: how far the other buffer has already been filled by the time
+			// this one is re-armed. Reaching UART1_RX_DMA_BUFFER_SIZE means data was lost.
+			uint32_t latency = UART1_RX_DMA_BUFFER_SIZE - uDMA_Get_Remaining(UART1_RX_DMA_CHANNEL, !alternate);
+			if (latency > uart1_stats.max_swap_latency_bytes)
+			{
+				uart1_stats.max_swap_latency_bytes = latency;
+			}
+		}
+	}
+
+	// TX transfer completed: release the transmitted bytes from the ring buffer or the low-priority slot
+	if (uDMA_Get_Channel_Interrupt(UART1_TX_DMA_CHANNEL))
+	{
+		uDMA_Clear_Channel_Interrupt(UART1_TX_DMA_CHANNEL);
+
+		if ((tx_dma_length != 0) && !uDMA_Is_Channel_Enabled(UART1_TX_DMA_CHANNEL))
+		{
+			if (tx_dma_low_priority)
+			{
+				tx_low_tail = tx_low_tail + 1;
+				uart1_stats.tx_low_priority_frames++;
+			}
+			else
+			{
+				Ring_Buffer_Consume(&tx_ring_buffer, tx_dma_length);
+			}
+
+			uart1_stats.tx_bytes += tx_dma_length;
+			uart1_stats.tx_dma_bursts++;
+			tx_dma_length = 0;
+		}
+	}
+
+	// Start the next TX transfer if there is data waiting and no transfer is active
+	if (tx_dma_length == 0)
+	{
+		UART1_TX_DMA_Start();
+	}
+
+	PROFILE_END(PROFILE_UART1_HANDLER);
+	EVENT_TRACE_EXIT(EVENT_TRACE_UART1);
+}
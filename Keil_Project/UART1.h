@@ -0,0 +1,259 @@
+/**
+ * @file UART1.h
+ *
+ * @brief Header file for the UART1 driver.
+ *
+ * This file contains the function definitions for the UART1 driver.
+ * It interfaces with the HC-06 Bluetooth module. The following pins are used:
+ *  - U1RX  (PB0)  <-->  HC-06 TXD
+ *  - U1TX  (PB1)  <-->  HC-06 RXD
+ *
+ * Both directions use the uDMA controller (see uDMA.h):
+ *  - RX: channel 22 in ping-pong mode fills a pool of fixed-size buffers. The main loop
+ *    reads the received bytes in place with UART1_RX_Peek and UART1_RX_Consume, so completed
+ *    buffers are handed to the command parser without a copy. UART1_Handler only runs once
+ *    per completed buffer to re-arm it, instead of once every few bytes.
+ *  - TX: channel 23 in basic mode sends bursts directly from a single-producer/single-consumer
+ *    ring buffer (see Ring_Buffer.h).
+ *
+ * There are two transmit queues. The normal queue (UART1_Write) is for time-critical messages
+ * such as command acknowledgements. The low-priority queue (UART1_Write_Low_Priority) holds
+ * whole frames, such as telemetry batches, in fixed slots. A low-priority frame is only started
+ * when the normal queue is empty, and it is always sent as one transfer, so frames from the two
+ * queues are never interleaved. A normal message waits at most for one low-priority frame.
+ *
+ * The main loop never polls the UART1 flag register, except while changing the baud rate.
+ *
+ * @author
+ */
+
+#ifndef UART1_H
+#define UART1_H
+
+#include "TM4C123GH6PM.h"
+#include "System_Clock.h"
+#include "Ring_Buffer.h"
+#include "uDMA.h"
+#include "Profile.h"
+#include "Event_Trace.h"
+
+// Default baud rate of the HC-06 module
+#define UART1_DEFAULT_BAUD_RATE   9600
+
+// Range of baud rates passed to UART1_Init and UART1_Set_Baud_Rate (see HC06.c)
+#define UART1_MIN_BAUD_RATE       9600
+#define UART1_MAX_BAUD_RATE       230400
+
+// BRD = SYSTEM_CLOCK_HZ / (16 * baud_rate), in units of 1/64 so that the lower 6 bits are the
+// fractional part (FBRD) and the upper bits are the integer part (IBRD), with rounding:
+// (64 * SYSTEM_CLOCK_HZ) / (16 * baud_rate) = (4 * SYSTEM_CLOCK_HZ) / baud_rate
+#define UART1_BAUD_RATE_DIVISOR(baud_rate) ((((uint32_t)SYSTEM_CLOCK_HZ * 4) + ((baud_rate) / 2)) / (baud_rate))
+
+// IBRD must be between 1 and 65535 over the whole range
+#if ((SYSTEM_CLOCK_HZ * 4) / UART1_MAX_BAUD_RATE) < 64
+#error "SYSTEM_CLOCK_HZ is too slow for UART1_MAX_BAUD_RATE"
+#endif
+
+#if ((SYSTEM_CLOCK_HZ * 4) / UART1_MIN_BAUD_RATE) > 0x3FFFFF
+#error "SYSTEM_CLOCK_HZ is too fast for UART1_MIN_BAUD_RATE"
+#endif
+
+// Number and size of the RX uDMA buffers (both must be powers of two, and the size at most 1024)
+#define UART1_RX_DMA_BUFFER_COUNT 4
+#define UART1_RX_DMA_BUFFER_SIZE  64
+
+// Size of the TX ring buffer (must be a power of two)
+#define UART1_TX_BUFFER_SIZE      256
+
+// Number and size of the low-priority TX frame slots (the count must be a power of two)
+#define UART1_TX_LOW_PRIORITY_SLOT_COUNT 4
+#define UART1_TX_LOW_PRIORITY_SLOT_SIZE  80
+
+// NVIC priority of the UART1 interrupt (0 = highest, 7 = lowest)
+#define UART1_INTERRUPT_PRIORITY  2
+
+typedef struct
+{
+	// Bytes received by the RX uDMA channel and transmitted by the TX uDMA channel
+	uint32_t rx_bytes;
+	uint32_t tx_bytes;
+
+	// Number of RX buffers completed and re-armed
+	uint32_t rx_buffer_swaps;
+
+	// Number of times unread RX data was overwritten because the main loop fell behind
+	uint32_t rx_dma_overruns;
+
+	// Largest number of bytes received into the next RX buffer before the completed one was re-armed
+	uint32_t max_swap_latency_bytes;
+
+	// Number of TX uDMA transfers
+	uint32_t tx_dma_bursts;
+
+	// Frames sent from the low-priority queue
+	uint32_t tx_low_priority_frames;
+
+	// Receive errors reported by the UART (framing, parity, break, and FIFO overrun)
+	uint32_t framing_errors;
+	uint32_t parity_errors;
+	uint32_t break_errors;
+	uint32_t overrun_errors;
+} UART1_Stats;
+
+/**
+ * @brief The UART1_Init function initializes UART1 and its interrupt.
+ *
+ * This function configures PB0 and PB1 for UART1, sets the frame format to 8 data bits,
+ * no parity, and one stop bit (8-N-1), enables the FIFOs, and starts the RX uDMA channel.
+ * Only the receive error interrupts are enabled in the UART itself. The baud rate divisors
+ * are computed from SYSTEM_CLOCK_HZ, so PLL_Init must be called before this function.
+ *
+ * @param baud_rate The baud rate in bits per second (e.g. 9600).
+ *
+ * @return None
+ */
+void UART1_Init(uint32_t baud_rate);
+
+/**
+ * @brief The UART1_Set_Baud_Rate function changes the baud rate of UART1.
+ *
+ * This function waits for the bytes that have already been queued to finish transmitting,
+ * disables UART1, reprograms the integer and fractional baud rate divisors (IBRD and FBRD)
+ * from SYSTEM_CLOCK_HZ, and enables UART1 again.
+ *
+ * @param baud_rate The baud rate in bits per second.
+ *
+ * @return None
+ */
+void UART1_Set_Baud_Rate(uint32_t baud_rate);
+
+/**
+ * @brief The UART1_RX_Peek function returns received bytes in place, without copying them.
+ *
+ * The returned bytes are contiguous in memory. When the received bytes wrap around the end
+ * of the buffer pool, only the bytes up to the end of the pool are returned, and the rest
+ * are returned by the next call after UART1_RX_Consume. If the main loop fell so far behind
+ * that unread bytes were overwritten, they are dropped and counted in rx_dma_overruns.
+ *
+ * @param data A pointer to the variable that receives the address of the oldest unread byte.
+ *
+ * @return uint32_t The number of contiguous bytes starting at *data.
+ */
+uint32_t UART1_RX_Peek(const uint8_t **data);
+
+/**
+ * @brief The UART1_RX_Consume function marks bytes returned by UART1_RX_Peek as read.
+ *
+ * @param length The number of bytes to mark as read. It must not exceed the value returned by UART1_RX_Peek.
+ *
+ * @return None
+ */
+void UART1_RX_Consume(uint32_t length);
+
+/**
+ * @brief The UART1_Available function returns the number of received bytes waiting to be read.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of bytes that have been received but not read yet.
+ */
+uint32_t UART1_Available(void);
+
+/**
+ * @brief The UART1_Read_Byte function reads one received byte without blocking.
+ *
+ * @param data A pointer to the variable that receives the byte.
+ *
+ * @return uint8_t 1 if a byte was read, 0 if no byte was available.
+ */
+uint8_t UART1_Read_Byte(uint8_t *data);
+
+/**
+ * @brief The UART1_Read function reads up to length received bytes without blocking.
+ *
+ * @param buffer A pointer to the buffer that receives the bytes.
+ *
+ * @param length The maximum number of bytes to read.
+ *
+ * @return uint32_t The number of bytes read.
+ */
+uint32_t UART1_Read(uint8_t *buffer, uint32_t length);
+
+/**
+ * @brief The UART1_Write function queues bytes for transmission without blocking.
+ *
+ * The bytes are copied into the TX ring buffer and the UART1 interrupt is pended,
+ * so UART1_Handler starts a TX uDMA transfer immediately if none is active.
+ *
+ * @param data A pointer to the bytes to transmit.
+ *
+ * @param length The number of bytes to transmit.
+ *
+ * @return uint32_t The number of bytes queued, which is less than length if the TX ring buffer is full.
+ */
+uint32_t UART1_Write(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief The UART1_Write_String function queues a null-terminated string for transmission without blocking.
+ *
+ * @param string A pointer to the string to transmit.
+ *
+ * @return uint32_t The number of bytes queued.
+ */
+uint32_t UART1_Write_String(const char *string);
+
+/**
+ * @brief The UART1_Write_Low_Priority function queues a complete frame in the low-priority queue without blocking.
+ *
+ * The frame is sent after every byte queued with UART1_Write, and it is either queued
+ * entirely or not at all.
+ *
+ * @param data A pointer to the frame.
+ *
+ * @param length The number of bytes in the frame (at most UART1_TX_LOW_PRIORITY_SLOT_SIZE).
+ *
+ * @return uint8_t 1 if the frame was queued, 0 if every slot is in use or the frame is too long.
+ */
+uint8_t UART1_Write_Low_Priority(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief The UART1_TX_Low_Priority_Free function returns the number of free low-priority slots.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of frames that can still be queued with UART1_Write_Low_Priority.
+ */
+uint32_t UART1_TX_Low_Priority_Free(void);
+
+/**
+ * @brief The UART1_TX_Free function returns the number of bytes that can still be queued for transmission.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of free bytes in the TX ring buffer.
+ */
+uint32_t UART1_TX_Free(void);
+
+/**
+ * @brief The UART1_Get_Stats function reads the UART1 statistics.
+ *
+ * @param stats A pointer to the structure that receives the statistics.
+ *
+ * @return None
+ */
+void UART1_Get_Stats(UART1_Stats *stats);
+
+/**
+ * @brief The UART1_Handler function is the interrupt service routine for UART1.
+ *
+ * This function counts receive errors, re-arms completed RX uDMA buffers, releases
+ * the bytes of a completed TX uDMA transfer from the TX ring buffer or the low-priority slot,
+ * and starts the next TX transfer when there is data waiting, serving the normal queue first.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART1_Handler(void);
+
+#endif
@@ -1,21 +1,55 @@
 /*
  * @file main.c
  *
- * @brief Main source code for the ADC program.
+ * @brief Main source code for the RC car firmware.
  *
- * This file contains the main entry point and function definitions for the ADC program.
+ * This file contains the main entry point, which initializes the drivers and runs the executive,
+ * and the tasks and handlers that the executive schedules:
+ *  - Control task (1 kHz): applies the newest setpoint to the ESC and the steering servo
+ *  - Telemetry task: samples the car state and sends it to the controller
+ *  - PWM fault event handler: restarts the ESC arming after an emergency stop
+ *
+ * At boot, the HC-06 is configured to its fastest baud rate while the ESC arms. The link
+ * supervisor then ramps the throttle to neutral whenever the controller goes silent.
+ * The main loop processes the received commands, runs the due tasks and expires the timers
+ * of the timer wheel.
  *
  * It interfaces with the following:
- *  - EduBase Board Potentiometer (PE2)
- *  - EduBase Board Analog Light Sensor (PE1)
+ *  - ESC and steering servo (PWM0, see PWM.h)
+ *  - HC-06 Bluetooth module (UART1)
+ *  - EduBase Board Potentiometer, Light Sensor and the battery voltage (ADC0)
  *
  * @author
  */
 #include "TM4C123GH6PM.h"
+#include "System_Clock.h"
 #include "SysTick_Delay.h"
 
 #include "GPIO.h"
 #include "PWM.h"
+#include "Timer_Wheel.h"
+#include "Executive.h"
+#include "UART1.h"
+#include "HC06.h"
+#include "Setpoint_Mailbox.h"
+#include "Command.h"
+#include "ADC.h"
+#include "Telemetry.h"
+#include "Link_Supervisor.h"
+#include "ESC_State.h"
+
+// The HC-06 is configured while the ESC arms, so the boot does not delay the first drive command
+#if HC06_BOOT_BUDGET_MS > ESC_STATE_ARMING_MS
+#error "HC06_BOOT_BUDGET_MS must not be longer than ESC_STATE_ARMING_MS"
+#endif
+
+// Task periods of the executive
+#define CONTROL_TASK_PERIOD_US 1000
+
+// OneShot125 sends one pulse after each throttle write of the control task
+#if (ESC_SIGNAL_MODE == ESC_SIGNAL_ONESHOT125) && (CONTROL_TASK_PERIOD_US != ESC_FRAME_US)
+#error "CONTROL_TASK_PERIOD_US must be ESC_FRAME_US in OneShot125 mode"
+#endif
 
 void PLL_Init(void) {
     // 1. Configure to use RCC2
@@ -27,49 +61,114 @@ void PLL_Init(void) {
     SYSCTL->RCC2 &= ~0x00000070;
     // 4. Activate PLL
     SYSCTL->RCC2 &= ~0x00002000;
-    // 5. Set System Divisor for 50 MHz
+    // 5. Set System Divisor for SYSTEM_CLOCK_HZ (see System_Clock.h)
     // 400 MHz / 8 = 50 MHz. SYSDIV2 = 7.
     SYSCTL->RCC2 |= 0x40000000; 
-    SYSCTL->RCC2 = (SYSCTL->RCC2 & ~0x1FC00000) + (7 << 22);
+    SYSCTL->RCC2 = (SYSCTL->RCC2 & ~0x1FC00000) + (PLL_SYSDIV2 << 22);
     // 6. Wait for lock
     while((SYSCTL->RIS & 0x00000040) == 0);
     // 7. Enable PLL
     SYSCTL->RCC2 &= ~0x00000800;
 }
 
+// The ESC lost its signal: hold the throttle at neutral and restart the arming
+// until PWM_Fault_Update brings the outputs back
+void PWM_Fault_Event_Handler(const Executive_Event *event)
+{
+	(void)event;
+
+	ESC_State_Init();
+}
+
+void Control_Task(void)
+{
+	static int16_t steering = 0;
+	Protocol_Setpoint setpoint;
+	uint32_t publish_time_us;
+
+	PROFILE_BEGIN(PROFILE_CONTROL_TASK);
+
+	// Add the stages of the last traced command to the latency histograms
+	Tracepoint_Update();
+
+	// Apply only the newest setpoint received since the previous period
+	uint8_t received = Setpoint_Mailbox_Read(&setpoint, &publish_time_us);
+
+	if (received)
+	{
+		// The link supervisor owns the throttle while the failsafe is active
+		ESC_State_Set_Command(Link_Supervisor_Is_Failsafe() ? 0 : setpoint.throttle);
+		steering = setpoint.steering;
+	}
+
+	// Bring the outputs back after an emergency stop; the ESC lost its signal and arms again
+	if (PWM_Fault_Update())
+	{
+		ESC_State_Init();
+	}
+
+	// The arming and brake timers expire in Timer_Wheel_Update, so the throttle
+	// can change even when no setpoint arrives
+	uint8_t throttle_changed = ESC_State_Update();
+
+	// OneShot125 sends a pulse after each write, so the throttle is then written every period
+	if (received || throttle_changed || (ESC_SIGNAL_MODE == ESC_SIGNAL_ONESHOT125))
+	{
+		// Both channels change in the same PWM period
+		if (!Link_Supervisor_Is_Failsafe())
+		{
+			PWM_Set_Setpoint(ESC_State_Get_Throttle(), steering);
+		}
+		else
+		{
+			Servo_Set_Steering(steering);
+		}
+	}
+
+	if (received)
+	{
+		Tracepoint_CMP_Written();
+
+		Latency_Record(PROTOCOL_HISTOGRAM_COMMAND_TO_PWM, (uint32_t)SysTick_Now_us() - publish_time_us);
+	}
+
+	PROFILE_END(PROFILE_CONTROL_TASK);
+}
+
 int main(void)
 {
+	Profile_Init();
+	Event_Trace_Init();
 	SysTick_Delay_Init();
 	PLL_Init();
 	PWM_Init();
-	
-    
-			//Servo_Set_Angle_Value(SERVO_CENTER_VAL);
-			//SysTick_Delay1ms(1800);
+	Steering_Init(STEERING_EXPO_PERCENT);
+
+	// The ESC arming timer runs on the wheel; it expires in the main loop
+	Timer_Wheel_Init();
+	ESC_State_Init();
+	ADC_Init();
+	UART1_Init(UART1_DEFAULT_BAUD_RATE);
+	uint32_t baud_rate = HC06_Autoconfigure();
+
+	Executive_Init();
+	Executive_Register_Event_Handler(EXECUTIVE_EVENT_PWM_FAULT, PWM_Fault_Event_Handler);
+	Setpoint_Mailbox_Init();
+	Latency_Init();
+	Command_Init();
+
+	// Add the tasks in order of decreasing rate
+	uint8_t control_task_id = Executive_Add_Task("control", Control_Task, CONTROL_TASK_PERIOD_US);
+	Executive_Add_Task("telemetry", Telemetry_Task, TELEMETRY_SAMPLE_PERIOD_US);
+
+	Telemetry_Init(control_task_id, TELEMETRY_RATE_BUDGET(baud_rate));
 
-    // 4. Disable Output (Stop sending)
-    //PWM0->ENABLE &= ~0x02;
+	// Start the failsafe last, right before the main loop begins receiving frames
+	Link_Supervisor_Init(LINK_SUPERVISOR_TIMEOUT_MS, LINK_SUPERVISOR_RAMP_MS);
 
     while(1){
-			Servo_Set_Angle_Value(SERVO_CENTER_VAL);
-			SysTick_Delay1ms(3000);
-			Servo_Set_Angle_Value(SERVO_LEFT_SAFE);
-			SysTick_Delay1ms(3000);
-			
-			Servo_Set_Angle_Value(SERVO_CENTER_VAL);
-			SysTick_Delay1ms(3000);
-			Servo_Set_Angle_Value(SERVO_RIGHT_SAFE);
-			SysTick_Delay1ms(3000);
-			//Servo_Set_Angle_Value(SERVO_RIGHT_SAFE);
-			//SysTick_Delay1ms(5000);
-       /* 
-        // Stop (1.5ms)
-        Servo_Set_Angle_Value(SERVO_CENTER_VAL);
-        SysTick_Delay1ms(3000);
-			Servo_Set_Angle_Value(SERVO_LEFT_VAL);
-        SysTick_Delay1ms(3000);
-			Servo_Set_Angle_Value(SERVO_RIGHT_VAL);
-        SysTick_Delay1ms(3000);
-			*/
+			Command_Process();
+			Executive_Run_Once();
+			Timer_Wheel_Update();
     }
 }
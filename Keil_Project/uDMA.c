@@ -0,0 +1,114 @@
+/**
+ * @file uDMA.c
+ *
+ * @brief Source code for the uDMA driver.
+ *
+ * This file contains the function definitions for the uDMA driver.
+ * It owns the uDMA channel control table and provides helper functions
+ * to configure the primary and alternate control structures of a channel.
+ *
+ * @author
+ */
+
+#include "uDMA.h"
+
+typedef struct
+{
+	volatile const void *source_end;
+	volatile void *destination_end;
+	volatile uint32_t control;
+	uint32_t unused;
+} uDMA_Control_Structure;
+
+// Primary control structures (entries 0 - 31) followed by alternate control structures (entries 32 - 63)
+static uDMA_Control_Structure udma_control_table[64] __attribute__((aligned(1024)));
+
+static uint8_t udma_initialized = 0;
+
+void uDMA_Init(void)
+{
+	if (udma_initialized)
+	{
+		return;
+	}
+
+	// Enable the clock to the uDMA module and wait until it is ready
+	SYSCTL->RCGCDMA |= 0x01;
+	while ((SYSCTL->PRDMA & 0x01) == 0);
+
+	// Enable the uDMA controller (MASTEN)
+	UDMA->CFG = 0x01;
+
+	// Set the base address of the channel control table
+	UDMA->CTLBASE = (uint32_t)udma_control_table;
+
+	udma_initialized = 1;
+}
+
+void uDMA_Configure_Channel(uint8_t channel, uint8_t encoding)
+{
+	uint32_t channel_bit = 1UL << channel;
+
+	// Disable the channel before changing its configuration
+	UDMA->ENACLR = channel_bit;
+
+	// Select the peripheral in the channel map (4 bits per channel, 8 channels per register)
+	volatile uint32_t *channel_map = &UDMA->CHMAP0 + (channel / 8);
+	uint32_t shift = (channel % 8) * 4;
+	*channel_map = (*channel_map & ~(0xFUL << shift)) | ((uint32_t)encoding << shift);
+
+	// Default priority, primary control structure, and allow single requests
+	UDMA->PRIOCLR = channel_bit;
+	UDMA->ALTCLR = channel_bit;
+	UDMA->USEBURSTCLR = channel_bit;
+
+	// Allow the peripheral to request transfers on this channel
+	UDMA->REQMASKCLR = channel_bit;
+}
+
+void uDMA_Set_Transfer(uint8_t channel, uint8_t alternate, volatile const void *source_end, volatile void *destination_end, uint32_t control)
+{
+	uDMA_Control_Structure *entry = &udma_control_table[channel + (alternate ? 32 : 0)];
+
+	entry->source_end = source_end;
+	entry->destination_end = destination_end;
+	entry->control = control;
+}
+
+uint32_t uDMA_Get_Remaining(uint8_t channel, uint8_t alternate)
+{
+	uint32_t control = udma_control_table[channel + (alternate ? 32 : 0)].control;
+
+	if ((control & UDMA_CTL_MODE_MASK) == UDMA_CTL_MODE_STOP)
+	{
+		return 0;
+	}
+
+	// XFERSIZE holds the number of items left minus one
+	return ((control >> 4) & 0x3FF) + 1;
+}
+
+uint8_t uDMA_Is_Alternate_Active(uint8_t channel)
+{
+	return (UDMA->ALTSET & (1UL << channel)) ? 1 : 0;
+}
+
+void uDMA_Enable_Channel(uint8_t channel)
+{
+	UDMA->ENASET = 1UL << channel;
+}
+
+uint8_t uDMA_Is_Channel_Enabled(uint8_t channel)
+{
+	return (UDMA->ENASET & (1UL << channel)) ? 1 : 0;
+}
+
+uint8_t uDMA_Get_Channel_Interrupt(uint8_t channel)
+{
+	return (UDMA->CHIS & (1UL << channel)) ? 1 : 0;
+}
+
+void uDMA_Clear_Channel_Interrupt(uint8_t channel)
+{
+	UDMA->CHIS = 1UL << channel;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file uDMA.h
+ *
+ * @brief Header file for the uDMA driver.
+ *
+ * This file contains the function definitions for the uDMA driver.
+ * It owns the uDMA channel control table and provides helper functions
+ * to configure the primary and alternate control structures of a channel.
+ *
+ * The control table holds a primary and an alternate control structure for each
+ * of the 32 channels. Each control structure contains the source end pointer,
+ * the destination end pointer, and the control word of the transfer. The table
+ * must be aligned on a 1024-byte boundary.
+ *
+ * When a transfer on a peripheral channel completes, the interrupt is raised on the
+ * peripheral's own vector (e.g. UART1_Handler), and the completion status of the channel
+ * must be read and cleared with uDMA_Get_Channel_Interrupt and uDMA_Clear_Channel_Interrupt.
+ *
+ * @author
+ */
+
+#ifndef UDMA_H
+#define UDMA_H
+
+#include "TM4C123GH6PM.h"
+
+// Channel Control Word (DMACHCTL) fields
+#define UDMA_CTL_DST_INC_8      0x00000000
+#define UDMA_CTL_DST_INC_NONE   0xC0000000
+#define UDMA_CTL_DST_SIZE_8     0x00000000
+#define UDMA_CTL_SRC_INC_8      0x00000000
+#define UDMA_CTL_SRC_INC_NONE   0x0C000000
+#define UDMA_CTL_SRC_SIZE_8     0x00000000
+#define UDMA_CTL_ARB_SIZE_1     0x00000000
+#define UDMA_CTL_ARB_SIZE_4     0x00008000
+#define UDMA_CTL_ARB_SIZE_8     0x0000C000
+#define UDMA_CTL_XFER_SIZE(n)   ((((uint32_t)(n) - 1) & 0x3FF) << 4)
+#define UDMA_CTL_MODE_STOP      0x00000000
+#define UDMA_CTL_MODE_BASIC     0x00000001
+#define UDMA_CTL_MODE_PINGPONG  0x00000003
+#define UDMA_CTL_MODE_MASK      0x00000007
+
+// Maximum number of items in a single transfer
+#define UDMA_MAX_TRANSFER_SIZE  1024
+
+/**
+ * @brief The uDMA_Init function initializes the uDMA controller.
+ *
+ * This function enables the clock to the uDMA module, enables the controller,
+ * and sets the base address of the channel control table. It may be called by
+ * several drivers; only the first call has an effect.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void uDMA_Init(void);
+
+/**
+ * @brief The uDMA_Configure_Channel function prepares a channel for peripheral transfers.
+ *
+ * This function disables the channel, selects the peripheral encoding in the channel map,
+ * and sets the channel to default priority, primary control structure, and to accept
+ * both single and burst requests from the peripheral.
+ *
+ * @param channel The channel number (0 - 31).
+ *
+ * @param encoding The channel encoding (0 - 4) that selects the peripheral.
+ *
+ * @return None
+ */
+void uDMA_Configure_Channel(uint8_t channel, uint8_t encoding);
+
+/**
+ * @brief The uDMA_Set_Transfer function writes a control structure of a channel.
+ *
+ * @param channel The channel number (0 - 31).
+ *
+ * @param alternate Selects the alternate control structure if set (1), otherwise the primary (0).
+ *
+ * @param source_end The address of the last source item.
+ *
+ * @param destination_end The address of the last destination item.
+ *
+ * @param control The channel control word (built from the UDMA_CTL_* fields).
+ *
+ * @return None
+ */
+void uDMA_Set_Transfer(uint8_t channel, uint8_t alternate, volatile const void *source_end, volatile void *destination_end, uint32_t control);
+
+/**
+ * @brief The uDMA_Get_Remaining function returns the number of items left in a control structure.
+ *
+ * The uDMA controller updates the control word after each arbitration, so this value
+ * can be used to track the progress of an active transfer.
+ *
+ * @param channel The channel number (0 - 31).
+ *
+ * @param alternate Selects the alternate control structure if set (1), otherwise the primary (0).
+ *
+ * @return uint32_t The number of items left, or 0 if the transfer has completed (mode is stop).
+ */
+uint32_t uDMA_Get_Remaining(uint8_t channel, uint8_t alternate);
+
+/**
+ * @brief The uDMA_Is_Alternate_Active function indicates whether a channel is using its alternate control structure.
+ *
+ * @param channel The channel number (0 - 31).
+ *
+ * @return uint8_t 1 if the alternate control structure is active, 0 if the primary is active.
+ */
+uint8_t uDMA_Is_Alternate_Active(uint8_t channel);
+
+/**
+ * @brief The uDMA_Enable_Channel function enables a channel so that it responds to requests.
+ *
+ * @param channel The channel number (0 - 31).
+ *
+ * @return None
+ */
+void uDMA_Enable_Channel(uint8_t channel);
+
+/**
+ * @brief The uDMA_Is_Channel_Enabled function indicates whether a channel is enabled.
+ *
+ * The uDMA controller disables a channel automatically when a basic transfer completes.
+ *
+ * @param channel The channel number (0 - 31).
+ *
+ * @return uint8_t 1 if the channel is enabled, 0 otherwise.
+ */
+uint8_t uDMA_Is_Channel_Enabled(uint8_t channel);
+
+/**
+ * @brief The uDMA_Get_Channel_Interrupt function indicates whether a channel has completed a transfer.
+ *
+ * @param channel The channel number (0 - 31).
+ *
+ * @return uint8_t 1 if the channel's completion interrupt status is set, 0 otherwise.
+ */
+uint8_t uDMA_Get_Channel_Interrupt(uint8_t channel);
+
+/**
+ * @brief The uDMA_Clear_Channel_Interrupt function clears the completion interrupt status of a channel.
+ *
+ * @param channel The channel number (0 - 31).
+ *
+ * @return None
+ */
+void uDMA_Clear_Channel_Interrupt(uint8_t channel);
+
+#endif